@@ -6,8 +6,10 @@
 
 #include "Render/Renderable.hpp"
 #include "Render/EditorCamera.hpp"
+#include "TRG/Math/DynamicConvexShell.hpp"
 #include "TRG/Math/Mesh.hpp"
 #include <raylib.h>
+#include <random>
 
 
 namespace TRG::Application {
@@ -72,6 +74,8 @@ namespace TRG::Application {
 		std::optional<Vec2> EndAddPoint(float ts);
 
 		void UpdatePointToAdd();
+		/// Move every point of the mesh graph a little, in place, without pushing a copy in the history.
+		void MovePoints(float ts);
 		void MakeModel(const std::vector<glm::vec<3, Real>>& vertices);
 
 	private:
@@ -93,6 +97,9 @@ namespace TRG::Application {
 	private:
 		std::vector<Vec2> m_JarvisShell;
 		std::vector<Vec2> m_GrahamScanShell;
+		// Kept up to date with the points, without recomputing the whole hull.
+		Math::DynamicConvexShell m_DynamicShell;
+		bool m_ShowDynamicShell = false;
 	public:
 		MouseButton m_AddPoint = MOUSE_BUTTON_MIDDLE;
 		MouseButton m_AddTriangulationPoint = MOUSE_BUTTON_SIDE;
@@ -113,7 +120,16 @@ namespace TRG::Application {
 		bool m_EditInputs = false;
 		bool m_ShouldOptimizeOnAddPoint = false;
 		bool m_UseDelaunayCoreAddPoint = false;
+		Math::DelaunayAlgorithm m_DelaunayAlgorithm = Math::DelaunayAlgorithm::BowyerWatson;
 		bool m_ShouldAddPoint = true;
+		bool m_ShouldMovePoints = false;
+		Real m_MovePointsSpeed = 0.1;
+		Real m_RefineMinAngle = 20;
+		Real m_RefineMaxArea = REAL_MAX;
+		Real m_TerrainTolerance = 0.01;
+		int m_ConvexHullPointCount = 10000;
+		std::mt19937 m_Random{42};
+		std::vector<uint32_t> m_MovedPoints;
 	};
 
 } // TRG::Application
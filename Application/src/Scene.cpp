@@ -4,6 +4,8 @@
 
 #include "Scene.hpp"
 #include "ImGuiLib.hpp"
+#include "TRG/Math/QuickHull.hpp"
+#include "TRG/Math/Tetrahedralization.hpp"
 
 #include <imgui.h>
 #include <iostream>
@@ -69,6 +71,7 @@ namespace TRG::Application {
 		else if (m_Action == Action::AddPoint && IsMouseButtonReleased(m_AddPoint)) {
 			if (const auto vec2 = EndAddPoint(ts)) {
 				m_2DPoints.push_back(vec2.value());
+				m_DynamicShell.Insert(vec2.value());
 			}
 			m_Action = Action::None;
 		}
@@ -104,6 +107,10 @@ namespace TRG::Application {
 			m_Action = Action::None;
 		}
 
+		if (m_ShouldMovePoints && m_UseDelaunayCoreAddPoint) {
+			MovePoints(ts);
+		}
+
 		switch (m_Action) {
 			case Action::None:
 				break;
@@ -159,14 +166,16 @@ namespace TRG::Application {
 		}
 
 		if (m_UseDelaunayCoreAddPoint && !GetMeshGraph().m_Triangles.empty()) {
-			const auto [points, lines] = GetMeshGraph().GetVoronoi();
-			for (const auto& [pointId, point]: points) {
-				DrawSphere(Vector3(point.x, 0.1, point.y), 0.05, { 0,0,255, 128});
+			// Only the cells changed since the last frame are updated.
+			const auto& voronoi = GetMeshGraph().GetVoronoiDiagram();
+			for (const auto& point: voronoi.Vertices) {
+				if (!point) continue;
+				DrawSphere(Vector3(point->x, 0.1, point->y), 0.05, { 0,0,255, 128});
 			}
-			for (const auto [pointId1, pointId2] : lines) {
-				const auto point1 = points.at(pointId1);
-				const auto point2 = points.at(pointId2);
-				DrawLine3D(Vector3(point1.x, 0.1, point1.y), Vector3(point2.x, 0.1, point2.y), { 0,0,255, 255});
+			for (const auto& edge : voronoi.Edges) {
+				if (!edge) continue;
+				if (edge->Infinite) DrawSphere(Vector3(edge->To.x, 0.1, edge->To.y), 0.05, { 0,0,255, 128});
+				DrawLine3D(Vector3(edge->From.x, 0.1, edge->From.y), Vector3(edge->To.x, 0.1, edge->To.y), { 0,0,255, 255});
 			}
 		}
 
@@ -186,6 +195,17 @@ namespace TRG::Application {
 			DrawLine3D(Vector3(current.x, 0, current.y), Vector3(next.x, 0, next.y), GrahamScanColor);
 		}
 
+		if (m_ShowDynamicShell) {
+			constexpr auto dynamicShellColor = Color{ 20, 160, 90, 255};
+			const std::vector<Vec2> dynamicShell = m_DynamicShell.Query();
+			for (uint64_t i = 0; i < dynamicShell.size(); ++i) {
+				const auto& current = dynamicShell[i];
+				const auto& next = dynamicShell[(i + 1) % dynamicShell.size()];
+				DrawSphere(Vector3(current.x, 0, current.y), 0.01, dynamicShellColor);
+				DrawLine3D(Vector3(current.x, 0, current.y), Vector3(next.x, 0, next.y), dynamicShellColor);
+			}
+		}
+
 		if (m_Action == Action::AddPoint && PointToAdd.has_value()) {
 			DrawSphere(reinterpret<Vector3>(PointToAdd.value()), 0.01, Color{180, 50, 40, 150});
 		}
@@ -230,6 +250,7 @@ namespace TRG::Application {
 		{
 			if (ImGui::Button("Delete All")) {
 				m_2DPoints.clear();
+				m_DynamicShell.Clear();
 			}
 			ImGui::SameLine(0, 1);
 			if (ImGui::Button("Sort")) {
@@ -251,8 +272,59 @@ namespace TRG::Application {
 			}
 
 			if (ImGui::Button("Make Graham Scan Shell")) {
-				 auto list = Math::GrahamScanConvexShell(m_2DPoints.begin(), m_2DPoints.end());
-				m_GrahamScanShell = std::vector<Vec2>(list.begin(), list.end());
+				m_GrahamScanShell = Math::MonotoneChainConvexShell(m_2DPoints.begin(), m_2DPoints.end());
+			}
+
+			ImGui::Checkbox("Show Dynamic Shell", &m_ShowDynamicShell);
+
+			ImGui::BeginDisabled(m_2DPoints.size() < 3);
+			if (ImGui::Button("Polygon Triangulation")) {
+				try {
+					const std::vector<uint32_t> indices = Math::TriangulatePolygon(m_2DPoints);
+					std::vector<Vec3> vertices;
+					vertices.reserve(indices.size());
+					for (const uint32_t index: indices) {
+						vertices.emplace_back(m_2DPoints[index].x, 0.001, m_2DPoints[index].y);
+					}
+					MakeModel(vertices);
+				} catch (const std::exception& e) {
+					std::cerr << e.what() << std::endl;
+				}
+			}
+			ImGui::EndDisabled();
+
+			ImGui::DragInt("Convex Hull Points", &m_ConvexHullPointCount, 100, 4, 1000000);
+			if (ImGui::Button("Random 3D Convex Hull")) {
+				// Points in a ball above the grid.
+				std::uniform_real_distribution<Real> coordinate(-1, 1);
+				std::vector<Vec3> points;
+				points.reserve(m_ConvexHullPointCount);
+				while (points.size() < static_cast<size_t>(m_ConvexHullPointCount)) {
+					const Vec3 point{coordinate(m_Random), coordinate(m_Random), coordinate(m_Random)};
+					if (Math::Magnitude(point) <= 1) points.push_back(point + Vec3{0, 1, 0});
+				}
+				try {
+					const Math::QuickHull3D hull(std::move(points), std::max(1u, std::thread::hardware_concurrency()));
+					MakeModel(hull.GetMesh());
+				} catch (const std::exception& e) {
+					std::cerr << e.what() << std::endl;
+				}
+			}
+			if (ImGui::Button("Random 3D Delaunay")) {
+				std::uniform_real_distribution<Real> coordinate(-1, 1);
+				std::vector<Vec3> points;
+				points.reserve(m_ConvexHullPointCount);
+				while (points.size() < static_cast<size_t>(m_ConvexHullPointCount)) {
+					const Vec3 point{coordinate(m_Random), coordinate(m_Random), coordinate(m_Random)};
+					if (Math::Magnitude(point) <= 1) points.push_back(point + Vec3{0, 1, 0});
+				}
+				// The tetrahedra are shrunk so the inside of the ball can be seen.
+				try {
+					const Math::DelaunayTetrahedralization delaunay(std::move(points));
+					MakeModel(delaunay.GetMesh(0.75));
+				} catch (const std::exception& e) {
+					std::cerr << e.what() << std::endl;
+				}
 			}
 
 			if (ImGui::Button("Incremental Triangulation")) {
@@ -268,8 +340,16 @@ namespace TRG::Application {
 				MakeModel(vertices);
 			}
 
+			{
+				constexpr const char *algorithms[] = {"Incremental", "Bowyer-Watson", "Divide & Conquer", "Parallel Divide & Conquer"};
+				int algorithm = static_cast<int>(m_DelaunayAlgorithm);
+				if (ImGui::Combo("Delaunay Algorithm", &algorithm, algorithms, IM_ARRAYSIZE(algorithms))) {
+					m_DelaunayAlgorithm = static_cast<Math::DelaunayAlgorithm>(algorithm);
+				}
+			}
+
 			if (ImGui::Button("Core Delaunay Triangulation")) {
-				const auto mg = Math::MeshGraph(m_2DPoints.cbegin(), m_2DPoints.cend(), true);
+				const auto mg = Math::MeshGraph::BuildDelaunay(m_2DPoints.cbegin(), m_2DPoints.cend(), m_DelaunayAlgorithm);
 				const auto vertices = Math::MeshGraphToMesh3DXZ(mg, 0.001);
 				MakeModel(vertices);
 			}
@@ -279,7 +359,11 @@ namespace TRG::Application {
 			for (uint64_t i = 0; i < m_2DPoints.size(); ++i) {
 				ImGui::PushID(i);
 				std::string name = "Point " + std::to_string(i);
-				ImGuiLib::DragReal2(name.c_str(), &m_2DPoints[i].x, 0.01, 0,0, "%.2f");
+				const Vec2 previous = m_2DPoints[i];
+				if (ImGuiLib::DragReal2(name.c_str(), &m_2DPoints[i].x, 0.01, 0,0, "%.2f")) {
+					m_DynamicShell.Erase(previous);
+					m_DynamicShell.Insert(m_2DPoints[i]);
+				}
 				ImGui::SameLine();
 				if (ImGui::Button("Delete")) {
 					toDelete.push_back(i);
@@ -290,6 +374,7 @@ namespace TRG::Application {
 		ImGui::End();
 
 		for (const auto to_delete: toDelete) {
+			m_DynamicShell.Erase(m_2DPoints[to_delete]);
 			m_2DPoints.erase(m_2DPoints.begin() + to_delete);
 		}
 	}
@@ -390,6 +475,18 @@ namespace TRG::Application {
 			ImGui::BeginDisabled(!m_UseDelaunayCoreAddPoint);
 			{
 				ImGui::Checkbox("Add Point On Click", &m_ShouldAddPoint);
+				ImGui::Checkbox("Move Points Each Frame", &m_ShouldMovePoints);
+				ImGuiLib::DragReal("Move Speed", &m_MovePointsSpeed, 0.01, 0, REAL_MAX);
+
+				ImGuiLib::DragReal("Refine Min Angle", &m_RefineMinAngle, 0.1, 0, 59);
+				ImGuiLib::DragReal("Refine Max Area", &m_RefineMaxArea, 0.01, 0.001, REAL_MAX);
+				ImGui::BeginDisabled(GetMeshGraph().m_Triangles.empty());
+				if (ImGui::Button("Refine Delaunay")) {
+					m_MeshGraphs.push_back(GetCopyMeshGraph());
+					GetMeshGraph().RefineDelaunay(m_RefineMinAngle * deg2rad, m_RefineMaxArea, 100000);
+					MakeModel(Math::MeshGraphToMesh3DXZ(GetMeshGraph(), 0.001_r));
+				}
+				ImGui::EndDisabled();
 			}
 			ImGui::EndDisabled();
 
@@ -410,6 +507,29 @@ namespace TRG::Application {
 			}
 			ImGui::EndDisabled();
 
+			ImGuiLib::DragReal("Terrain Tolerance", &m_TerrainTolerance, 0.001, 0, REAL_MAX);
+			if (ImGui::Button("Random Terrain")) {
+				// A few octaves of waves on a 257x257 grid, of which the TIN keeps a fraction of the samples.
+				constexpr uint32_t size = 257;
+				std::uniform_real_distribution<Real> phase(0, 2 * pi);
+				std::array<Real, 6> phases;
+				for (Real &value: phases) value = phase(m_Random);
+				std::vector<Real> heights;
+				heights.reserve(size * size);
+				for (uint32_t y = 0; y < size; ++y) {
+					for (uint32_t x = 0; x < size; ++x) {
+						Real height = 0;
+						for (uint32_t octave = 0; octave < 3; ++octave) {
+							const Real frequency = static_cast<Real>(1 << octave) * 0.03_r;
+							height += std::sin(static_cast<Real>(x) * frequency + phases[2 * octave]) * std::cos(static_cast<Real>(y) * frequency + phases[2 * octave + 1]) / static_cast<Real>(1 << octave);
+						}
+						heights.push_back(height * 0.2_r);
+					}
+				}
+				m_MeshGraphs.push_back(Math::MeshGraph::BuildTerrain(heights, size, size, m_TerrainTolerance, Vec2{-2, -2}, Vec2{4_r / (size - 1)}));
+				MakeModel(Math::MeshGraphToMesh3DXZ(GetMeshGraph(), 0.001_r));
+			}
+
 			ImGui::BeginDisabled(GetMeshGraph().m_Triangles.empty());
 			if (ImGui::Button("Make Mesh")) {
 				MakeModel(Math::MeshGraphToMesh3DXZ(GetMeshGraph(), 0.001_r));
@@ -563,6 +683,28 @@ namespace TRG::Application {
 		return Vec2{PointToAdd.value().x, PointToAdd.value().z};
 	}
 
+	void Scene::MovePoints(const float ts) {
+		auto& mg = GetMeshGraph();
+		std::uniform_real_distribution<Real> step(-1, 1);
+		const Real distance = m_MovePointsSpeed * ts;
+
+		// A point leaving its neighbourhood is removed & added back, the ids are collected before moving anything.
+		m_MovedPoints.clear();
+		for (const auto& [id, vert] : mg.m_Vertices) {
+			m_MovedPoints.push_back(id);
+		}
+		for (const uint32_t id : m_MovedPoints) {
+			const Vec2 position = mg.m_Vertices.at(id).Position + Vec2{step(m_Random), step(m_Random)} * distance;
+			try {
+				mg.MoveDelaunayPoint(id, position);
+			} catch (const std::exception& e) {
+				std::cerr << e.what() << std::endl;
+				m_ShouldMovePoints = false;
+				return;
+			}
+		}
+	}
+
 	void Scene::UpdatePointToAdd() {
 		const auto& app = SingletonApp::Get();
 
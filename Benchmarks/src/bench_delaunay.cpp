@@ -0,0 +1,87 @@
+#include <TRG/Math.hpp>
+#include <TRG/Math/Mesh.hpp>
+#include <iostream>
+#include <iomanip>
+#include <random>
+
+using namespace TRG;
+
+// Usage: TRG_Benchmarks [--incremental-max N] [--parabola] [point counts...]
+// The point-by-point constructor is quadratic-ish, it is skipped above `--incremental-max` points (100000 by default).
+// `--parabola` put the points on y = x^2, the worst case of the incremental insertions.
+
+static std::vector<Math::MeshGraph::Vector2> GeneratePoints(const uint64_t count, const uint32_t seed, const bool parabola) {
+	std::mt19937 random(seed);
+	std::uniform_real_distribution<Real> distribution(-1000, 1000);
+	std::vector<Math::MeshGraph::Vector2> points;
+	points.reserve(count);
+	for (uint64_t i = 0; i < count; ++i) {
+		if (parabola) {
+			const Real x = distribution(random) / 1000;
+			points.emplace_back(x, x * x);
+		} else {
+			points.emplace_back(distribution(random), distribution(random));
+		}
+	}
+	return points;
+}
+
+template<typename Func>
+static double MeasureMilliseconds(Func &&func) {
+	const auto start = std::chrono::steady_clock::now();
+	func();
+	const auto end = std::chrono::steady_clock::now();
+	return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+int main(const int argc, char **argv) {
+	uint64_t incrementalMax = 100000;
+	bool parabola = false;
+	std::vector<uint64_t> counts;
+	for (int i = 1; i < argc; ++i) {
+		const std::string_view arg = argv[i];
+		if (arg == "--incremental-max" && i + 1 < argc) {
+			incrementalMax = std::stoull(argv[++i]);
+		} else if (arg == "--parabola") {
+			parabola = true;
+		} else {
+			counts.push_back(std::stoull(argv[i]));
+		}
+	}
+	if (counts.empty()) counts = {10000, 100000, 1000000};
+
+	std::cout << std::setw(10) << "points" << std::setw(12) << "triangles"
+			<< std::setw(20) << "constructor (ms)" << std::setw(20) << "BuildDelaunay (ms)" << std::setw(10) << "speedup"
+			<< std::setw(24) << "DivideAndConquer (ms)" << std::setw(16) << "Parallel (ms)" << "\n";
+
+	for (const uint64_t count: counts) {
+		const auto points = GeneratePoints(count, 42, parabola);
+
+		size_t triangleCount = 0;
+		const double bulkMs = MeasureMilliseconds([&]() {
+			const Math::MeshGraph graph = Math::MeshGraph::BuildDelaunay(points.cbegin(), points.cend());
+			triangleCount = graph.m_Triangles.size();
+		});
+
+		const double divideAndConquerMs = MeasureMilliseconds([&]() {
+			const Math::MeshGraph graph = Math::MeshGraph::BuildDelaunay(points.cbegin(), points.cend(), Math::DelaunayAlgorithm::DivideAndConquer);
+		});
+
+		const double parallelMs = MeasureMilliseconds([&]() {
+			const Math::MeshGraph graph = Math::MeshGraph::BuildDelaunay(points.cbegin(), points.cend(), Math::DelaunayAlgorithm::ParallelDivideAndConquer);
+		});
+
+		std::cout << std::setw(10) << count << std::setw(12) << triangleCount << std::fixed << std::setprecision(1);
+		if (count <= incrementalMax) {
+			const double incrementalMs = MeasureMilliseconds([&]() {
+				const Math::MeshGraph graph(points.cbegin(), points.cend(), true);
+			});
+			std::cout << std::setw(20) << incrementalMs << std::setw(20) << bulkMs << std::setw(9) << incrementalMs / bulkMs << "x";
+		} else {
+			std::cout << std::setw(20) << "skipped" << std::setw(20) << bulkMs << std::setw(10) << "-";
+		}
+		std::cout << std::setw(24) << divideAndConquerMs << std::setw(16) << parallelMs << "\n";
+	}
+
+	return 0;
+}
@@ -0,0 +1,125 @@
+#include <TRG/Math.hpp>
+#include <TRG/Math/Batch.hpp>
+#include <iostream>
+#include <iomanip>
+#include <random>
+
+using namespace TRG;
+
+// Usage: TRG_PredicatesBenchmarks [triangle count] [query count]
+// Test every query point against every triangle with the scalar glm path and with the batch kernels.
+
+template<typename Func>
+static double MeasureMilliseconds(Func &&func) {
+	const auto start = std::chrono::steady_clock::now();
+	func();
+	const auto end = std::chrono::steady_clock::now();
+	return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+static void PrintRow(const std::string_view name, const double scalarMs, const double batchMs, const uint64_t scalarCount, const uint64_t batchCount) {
+	std::cout << std::setw(20) << name << std::fixed << std::setprecision(1)
+			<< std::setw(14) << scalarMs << std::setw(14) << batchMs << std::setw(9) << scalarMs / batchMs << "x"
+			<< std::setw(16) << scalarCount << std::setw(16) << batchCount << "\n";
+}
+
+int main(const int argc, char **argv) {
+	const uint64_t triangleCount = argc > 1 ? std::stoull(argv[1]) : 100000;
+	const uint64_t queryCount = argc > 2 ? std::stoull(argv[2]) : 200;
+
+	std::mt19937 random(42);
+	std::uniform_real_distribution<Real> distribution(-1000, 1000);
+	const auto randomPoint = [&]() { return Vec2{distribution(random), distribution(random)}; };
+
+	std::vector<std::array<Vec2, 3>> triangles;
+	Math::TriangleBuffer triangleBuffer;
+	Math::SegmentBuffer segmentBuffer;
+	triangles.reserve(triangleCount);
+	triangleBuffer.Reserve(triangleCount);
+	segmentBuffer.Reserve(triangleCount);
+	for (uint64_t i = 0; i < triangleCount; ++i) {
+		const Vec2 a = randomPoint();
+		const Vec2 b = a + randomPoint() * static_cast<Real>(0.01);
+		const Vec2 c = a + randomPoint() * static_cast<Real>(0.01);
+		triangles.push_back({a, b, c});
+		triangleBuffer.Add(a, b, c);
+		segmentBuffer.Add(a, b);
+	}
+	std::vector<Vec2> queries;
+	for (uint64_t i = 0; i < queryCount; ++i) queries.push_back(randomPoint());
+
+	std::cout << "SIMD width: " << Math::Batch::Width << " triangles per instruction\n";
+	std::cout << std::setw(20) << "kernel" << std::setw(14) << "scalar (ms)" << std::setw(14) << "batch (ms)" << std::setw(10) << "speedup"
+			<< std::setw(16) << "scalar hits" << std::setw(16) << "batch hits" << "\n";
+
+	std::vector<int8_t> signs(triangleCount);
+	std::vector<uint8_t> flags(triangleCount);
+
+	{
+		uint64_t scalarCount = 0, batchCount = 0;
+		const double scalarMs = MeasureMilliseconds([&]() {
+			for (const Vec2 &p: queries) {
+				for (const auto &[a, b, c]: triangles) scalarCount += Math::IsTriangleOriented(a, b, p);
+			}
+		});
+		const double batchMs = MeasureMilliseconds([&]() {
+			for (const Vec2 &p: queries) {
+				Math::OrientBatch(p, segmentBuffer, signs.data());
+				for (const int8_t sign: signs) batchCount += sign > 0;
+			}
+		});
+		PrintRow("orientation", scalarMs, batchMs, scalarCount, batchCount);
+	}
+
+	{
+		// The historical path: build the circle, then compare the distance to the radius.
+		uint64_t scalarCount = 0, batchCount = 0;
+		const double scalarMs = MeasureMilliseconds([&]() {
+			for (const Vec2 &p: queries) {
+				for (const auto &[a, b, c]: triangles) scalarCount += Math::IsPointInsideCircle(Math::GetCircle(a, b, c), p);
+			}
+		});
+		const double batchMs = MeasureMilliseconds([&]() {
+			for (const Vec2 &p: queries) {
+				Math::InCircleBatch(p, triangleBuffer, flags.data());
+				for (const uint8_t flag: flags) batchCount += flag;
+			}
+		});
+		PrintRow("circumcircle", scalarMs, batchMs, scalarCount, batchCount);
+	}
+
+	{
+		uint64_t scalarCount = 0, batchCount = 0;
+		const double scalarMs = MeasureMilliseconds([&]() {
+			for (const Vec2 &p: queries) {
+				for (const auto &[a, b, c]: triangles) scalarCount += Math::IsPointInsideCircumcircle(a, b, c, p);
+			}
+		});
+		const double batchMs = MeasureMilliseconds([&]() {
+			for (const Vec2 &p: queries) {
+				Math::InCircleBatch(p, triangleBuffer, flags.data());
+				for (const uint8_t flag: flags) batchCount += flag;
+			}
+		});
+		PrintRow("exact circumcircle", scalarMs, batchMs, scalarCount, batchCount);
+	}
+
+	{
+		std::vector<double> centerX(triangleCount), centerY(triangleCount);
+		double scalarSum = 0, batchSum = 0;
+		const double scalarMs = MeasureMilliseconds([&]() {
+			for (uint64_t query = 0; query < queryCount; ++query) {
+				for (const auto &[a, b, c]: triangles) scalarSum += Math::GetCircleCenter(a, b, c).x;
+			}
+		});
+		const double batchMs = MeasureMilliseconds([&]() {
+			for (uint64_t query = 0; query < queryCount; ++query) {
+				Math::CircumcentersBatch(triangleBuffer, centerX.data(), centerY.data());
+				batchSum += centerX[query % triangleCount];
+			}
+		});
+		PrintRow("circumcenters", scalarMs, batchMs, static_cast<uint64_t>(scalarSum != 0), static_cast<uint64_t>(batchSum != 0));
+	}
+
+	return 0;
+}
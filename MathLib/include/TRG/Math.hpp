@@ -8,4 +8,8 @@
 #include "Math/Geometry.hpp"
 #include "Math/Raycast.hpp"
 #include "Math/Shells.hpp"
-#include "Math/Triangulation.hpp"
\ No newline at end of file
+#include "Math/DynamicConvexShell.hpp"
+#include "Math/Triangulation.hpp"
+#include "Math/Polygon.hpp"
+#include "Math/QuickHull.hpp"
+#include "Math/Tetrahedralization.hpp"
\ No newline at end of file
@@ -121,11 +121,11 @@ namespace TRG::Math {
 
 	template<typename T, glm::qualifier Q = glm::qualifier::defaultp>
 	[[nodiscard]] inline static bool IsPointInsideCircle(const Circle<T,Q>& circle, const glm::vec<2,T,Q>& point) {
-		return Math::Distance(circle.Center, point) < circle.Radius;
+		return Math::Distance2(circle.Center, point) < circle.Radius * circle.Radius;
 	}
 
 	template<typename T, glm::qualifier Q = glm::qualifier::defaultp>
 	[[nodiscard]] inline static bool IsPointInsideSphere(const Sphere<T,Q>& sphere, const glm::vec<3,T,Q>& point) {
-		return Math::Distance(sphere.Center, point) < sphere.Radius;
+		return Math::Distance2(sphere.Center, point) < sphere.Radius * sphere.Radius;
 	}
 } // TRG
@@ -0,0 +1,288 @@
+#pragma once
+
+#include "Basics.hpp"
+#include "Predicates.hpp"
+#include <bit>
+#include <cstdint>
+#include <vector>
+
+#if defined(__AVX2__)
+	#include <immintrin.h>
+	#define TRG_BATCH_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#include <emmintrin.h>
+	#define TRG_BATCH_SSE2
+#endif
+
+namespace TRG::Math {
+
+	/**
+	 * Structure-of-arrays copy of a list of segments AB, the layout read by the batch kernels.
+	 * The coordinates are stored as double, so the float coordinates are kept exactly.
+	 */
+	struct SegmentBuffer {
+		std::vector<double> AX, AY;
+		std::vector<double> BX, BY;
+
+		template<typename T, glm::qualifier Q = glm::qualifier::defaultp>
+		void Add(const glm::vec<2,T,Q>& a, const glm::vec<2,T,Q>& b) {
+			AX.push_back(static_cast<double>(a.x)); AY.push_back(static_cast<double>(a.y));
+			BX.push_back(static_cast<double>(b.x)); BY.push_back(static_cast<double>(b.y));
+		}
+
+		void Reserve(const size_t count) {
+			for (auto *coordinates: {&AX, &AY, &BX, &BY}) coordinates->reserve(count);
+		}
+
+		void Clear() {
+			for (auto *coordinates: {&AX, &AY, &BX, &BY}) coordinates->clear();
+		}
+
+		[[nodiscard]] size_t Size() const { return AX.size(); }
+	};
+
+	/**
+	 * Structure-of-arrays copy of a list of triangles ABC, the layout read by the batch kernels.
+	 * The coordinates are stored as double, so the float coordinates are kept exactly.
+	 */
+	struct TriangleBuffer {
+		std::vector<double> AX, AY;
+		std::vector<double> BX, BY;
+		std::vector<double> CX, CY;
+
+		template<typename T, glm::qualifier Q = glm::qualifier::defaultp>
+		void Add(const glm::vec<2,T,Q>& a, const glm::vec<2,T,Q>& b, const glm::vec<2,T,Q>& c) {
+			AX.push_back(static_cast<double>(a.x)); AY.push_back(static_cast<double>(a.y));
+			BX.push_back(static_cast<double>(b.x)); BY.push_back(static_cast<double>(b.y));
+			CX.push_back(static_cast<double>(c.x)); CY.push_back(static_cast<double>(c.y));
+		}
+
+		void Reserve(const size_t count) {
+			for (auto *coordinates: {&AX, &AY, &BX, &BY, &CX, &CY}) coordinates->reserve(count);
+		}
+
+		void Clear() {
+			for (auto *coordinates: {&AX, &AY, &BX, &BY, &CX, &CY}) coordinates->clear();
+		}
+
+		[[nodiscard]] size_t Size() const { return AX.size(); }
+	};
+
+	namespace Batch {
+
+		// The lanes of the vector unit, the kernels are written once on top of them.
+#if defined(TRG_BATCH_AVX2)
+		struct Lanes {
+			using Type = __m256d;
+			static constexpr size_t Count = 4;
+			static Type Load(const double *p) { return _mm256_loadu_pd(p); }
+			static void Store(double *p, const Type a) { _mm256_storeu_pd(p, a); }
+			static Type Set(const double value) { return _mm256_set1_pd(value); }
+			static Type Add(const Type a, const Type b) { return _mm256_add_pd(a, b); }
+			static Type Sub(const Type a, const Type b) { return _mm256_sub_pd(a, b); }
+			static Type Mul(const Type a, const Type b) { return _mm256_mul_pd(a, b); }
+			static Type Div(const Type a, const Type b) { return _mm256_div_pd(a, b); }
+			static Type Abs(const Type a) { return _mm256_andnot_pd(_mm256_set1_pd(-0.0), a); }
+			static Type Neg(const Type a) { return _mm256_xor_pd(_mm256_set1_pd(-0.0), a); }
+			/// One bit per lane where a > b.
+			static int Greater(const Type a, const Type b) { return _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_GT_OQ)); }
+		};
+#elif defined(TRG_BATCH_SSE2)
+		struct Lanes {
+			using Type = __m128d;
+			static constexpr size_t Count = 2;
+			static Type Load(const double *p) { return _mm_loadu_pd(p); }
+			static void Store(double *p, const Type a) { _mm_storeu_pd(p, a); }
+			static Type Set(const double value) { return _mm_set1_pd(value); }
+			static Type Add(const Type a, const Type b) { return _mm_add_pd(a, b); }
+			static Type Sub(const Type a, const Type b) { return _mm_sub_pd(a, b); }
+			static Type Mul(const Type a, const Type b) { return _mm_mul_pd(a, b); }
+			static Type Div(const Type a, const Type b) { return _mm_div_pd(a, b); }
+			static Type Abs(const Type a) { return _mm_andnot_pd(_mm_set1_pd(-0.0), a); }
+			static Type Neg(const Type a) { return _mm_xor_pd(_mm_set1_pd(-0.0), a); }
+			/// One bit per lane where a > b.
+			static int Greater(const Type a, const Type b) { return _mm_movemask_pd(_mm_cmpgt_pd(a, b)); }
+		};
+#endif
+
+		/// Number of triangles or segments tested by a single instruction, 1 without SIMD.
+		inline constexpr size_t Width =
+#if defined(TRG_BATCH_AVX2) || defined(TRG_BATCH_SSE2)
+			Lanes::Count;
+#else
+			1;
+#endif
+
+		/// Center of the circumcircle of ABC, not finite if ABC is degenerated.
+		inline void Circumcenter(const double ax, const double ay, const double bx, const double by, const double cx, const double cy, double &centerX, double &centerY) {
+			const double abx = bx - ax;
+			const double aby = by - ay;
+			const double acx = cx - ax;
+			const double acy = cy - ay;
+			const double abLength = abx * abx + aby * aby;
+			const double acLength = acx * acx + acy * acy;
+			const double divider = 2 * (abx * acy - aby * acx);
+			centerX = ax + (acy * abLength - aby * acLength) / divider;
+			centerY = ay + (abx * acLength - acx * abLength) / divider;
+		}
+
+		[[nodiscard]] inline int8_t Sign(const double value) {
+			return static_cast<int8_t>((value > 0) - (value < 0));
+		}
+
+#if defined(TRG_BATCH_AVX2) || defined(TRG_BATCH_SSE2)
+		/**
+		 * Filtered orientation of the lanes: the bits of `positive` & `negative` are set where the sign is certain.
+		 */
+		inline void Orient(const Lanes::Type ax, const Lanes::Type ay, const Lanes::Type bx, const Lanes::Type by,
+		                   const Lanes::Type cx, const Lanes::Type cy, int &positive, int &negative) {
+			using L = Lanes;
+			const L::Type left = L::Mul(L::Sub(ax, cx), L::Sub(by, cy));
+			const L::Type right = L::Mul(L::Sub(ay, cy), L::Sub(bx, cx));
+			const L::Type determinant = L::Sub(left, right);
+			const L::Type bound = L::Mul(L::Set(Predicates::Orient2DErrorBound), L::Add(L::Abs(left), L::Abs(right)));
+			positive = L::Greater(determinant, bound);
+			negative = L::Greater(L::Neg(determinant), bound);
+		}
+#endif
+
+	}
+
+	/**
+	 * Orientation of the point P against each segment AB of the buffer, the batch version of `Orient2D(a, b, p)`.
+	 * The sign is exact: the lanes the floating-point filter can't decide are evaluated again by the scalar predicate.
+	 * @param signs Receive 1 if P is on the left of AB, -1 on the right, 0 if collinear. Must hold `segments.Size()` values.
+	 */
+	template<typename T, glm::qualifier Q = glm::qualifier::defaultp>
+	inline static void OrientBatch(const glm::vec<2,T,Q>& p, const SegmentBuffer& segments, int8_t* signs) {
+		const double px = static_cast<double>(p.x);
+		const double py = static_cast<double>(p.y);
+		const size_t count = segments.Size();
+		size_t i = 0;
+#if defined(TRG_BATCH_AVX2) || defined(TRG_BATCH_SSE2)
+		using L = Batch::Lanes;
+		const L::Type vpx = L::Set(px);
+		const L::Type vpy = L::Set(py);
+		for (; i + L::Count <= count; i += L::Count) {
+			int positive, negative;
+			Batch::Orient(L::Load(&segments.AX[i]), L::Load(&segments.AY[i]), L::Load(&segments.BX[i]), L::Load(&segments.BY[i]), vpx, vpy, positive, negative);
+			for (size_t lane = 0; lane < L::Count; ++lane) {
+				signs[i + lane] = static_cast<int8_t>((positive >> lane & 1) - (negative >> lane & 1));
+			}
+			// Only the lanes the filter couldn't decide go through the exact predicate.
+			for (int uncertain = ~(positive | negative) & ((1 << L::Count) - 1); uncertain != 0; uncertain &= uncertain - 1) {
+				const size_t j = i + static_cast<size_t>(std::countr_zero(static_cast<unsigned>(uncertain)));
+				signs[j] = Batch::Sign(Predicates::Orient2D(segments.AX[j], segments.AY[j], segments.BX[j], segments.BY[j], px, py));
+			}
+		}
+#endif
+		for (; i < count; ++i) {
+			signs[i] = Batch::Sign(Predicates::Orient2D(segments.AX[i], segments.AY[i], segments.BX[i], segments.BY[i], px, py));
+		}
+	}
+
+	/**
+	 * Check if the point P is strictly inside the circumcircle of each triangle of the buffer,
+	 * the batch version of `IsPointInsideCircumcircle`, with the same exact result.
+	 * @param inside Receive 1 if P is inside the circumcircle, 0 otherwise. Must hold `triangles.Size()` values.
+	 */
+	template<typename T, glm::qualifier Q = glm::qualifier::defaultp>
+	inline static void InCircleBatch(const glm::vec<2,T,Q>& p, const TriangleBuffer& triangles, uint8_t* inside) {
+		const double px = static_cast<double>(p.x);
+		const double py = static_cast<double>(p.y);
+		const size_t count = triangles.Size();
+		const auto exact = [&triangles, px, py](const size_t i) -> uint8_t {
+			const double orientation = Predicates::Orient2D(triangles.AX[i], triangles.AY[i], triangles.BX[i], triangles.BY[i], triangles.CX[i], triangles.CY[i]);
+			if (orientation == 0) return 0;
+			const double determinant = Predicates::InCircle(triangles.AX[i], triangles.AY[i], triangles.BX[i], triangles.BY[i], triangles.CX[i], triangles.CY[i], px, py);
+			return orientation > 0 ? determinant > 0 : determinant < 0;
+		};
+
+		size_t i = 0;
+#if defined(TRG_BATCH_AVX2) || defined(TRG_BATCH_SSE2)
+		using L = Batch::Lanes;
+		const L::Type vpx = L::Set(px);
+		const L::Type vpy = L::Set(py);
+		const L::Type incircleBound = L::Set(Predicates::InCircleErrorBound);
+		for (; i + L::Count <= count; i += L::Count) {
+			const L::Type ax = L::Load(&triangles.AX[i]);
+			const L::Type ay = L::Load(&triangles.AY[i]);
+			const L::Type bx = L::Load(&triangles.BX[i]);
+			const L::Type by = L::Load(&triangles.BY[i]);
+			const L::Type cx = L::Load(&triangles.CX[i]);
+			const L::Type cy = L::Load(&triangles.CY[i]);
+
+			int clockwise, counterClockwise;
+			Batch::Orient(ax, ay, bx, by, cx, cy, counterClockwise, clockwise);
+
+			const L::Type adx = L::Sub(ax, vpx);
+			const L::Type ady = L::Sub(ay, vpy);
+			const L::Type bdx = L::Sub(bx, vpx);
+			const L::Type bdy = L::Sub(by, vpy);
+			const L::Type cdx = L::Sub(cx, vpx);
+			const L::Type cdy = L::Sub(cy, vpy);
+
+			const L::Type bdxcdy = L::Mul(bdx, cdy);
+			const L::Type cdxbdy = L::Mul(cdx, bdy);
+			const L::Type cdxady = L::Mul(cdx, ady);
+			const L::Type adxcdy = L::Mul(adx, cdy);
+			const L::Type adxbdy = L::Mul(adx, bdy);
+			const L::Type bdxady = L::Mul(bdx, ady);
+			const L::Type aLift = L::Add(L::Mul(adx, adx), L::Mul(ady, ady));
+			const L::Type bLift = L::Add(L::Mul(bdx, bdx), L::Mul(bdy, bdy));
+			const L::Type cLift = L::Add(L::Mul(cdx, cdx), L::Mul(cdy, cdy));
+
+			const L::Type determinant = L::Add(L::Add(L::Mul(aLift, L::Sub(bdxcdy, cdxbdy)), L::Mul(bLift, L::Sub(cdxady, adxcdy))), L::Mul(cLift, L::Sub(adxbdy, bdxady)));
+			const L::Type permanent = L::Add(L::Add(L::Mul(L::Add(L::Abs(bdxcdy), L::Abs(cdxbdy)), aLift),
+			                                        L::Mul(L::Add(L::Abs(cdxady), L::Abs(adxcdy)), bLift)),
+			                                 L::Mul(L::Add(L::Abs(adxbdy), L::Abs(bdxady)), cLift));
+			const L::Type bound = L::Mul(incircleBound, permanent);
+			const int positive = L::Greater(determinant, bound);
+			const int negative = L::Greater(L::Neg(determinant), bound);
+
+			const int result = (counterClockwise & positive) | (clockwise & negative);
+			for (size_t lane = 0; lane < L::Count; ++lane) {
+				inside[i + lane] = static_cast<uint8_t>(result >> lane & 1);
+			}
+			for (int uncertain = ~((counterClockwise | clockwise) & (positive | negative)) & ((1 << L::Count) - 1); uncertain != 0; uncertain &= uncertain - 1) {
+				const size_t j = i + static_cast<size_t>(std::countr_zero(static_cast<unsigned>(uncertain)));
+				inside[j] = exact(j);
+			}
+		}
+#endif
+		for (; i < count; ++i) {
+			inside[i] = exact(i);
+		}
+	}
+
+	/**
+	 * Calculate the center of the circumcircle of each triangle of the buffer, the batch version of `GetCircleCenter`.
+	 * The lanes follow the operations of the scalar `Batch::Circumcenter`. The center of a degenerated triangle is not finite.
+	 * @param centerX, centerY Receive the coordinates of the centers. Must hold `triangles.Size()` values.
+	 */
+	inline static void CircumcentersBatch(const TriangleBuffer& triangles, double* centerX, double* centerY) {
+		const size_t count = triangles.Size();
+		size_t i = 0;
+#if defined(TRG_BATCH_AVX2) || defined(TRG_BATCH_SSE2)
+		using L = Batch::Lanes;
+		const L::Type two = L::Set(2);
+		for (; i + L::Count <= count; i += L::Count) {
+			const L::Type ax = L::Load(&triangles.AX[i]);
+			const L::Type ay = L::Load(&triangles.AY[i]);
+			const L::Type abx = L::Sub(L::Load(&triangles.BX[i]), ax);
+			const L::Type aby = L::Sub(L::Load(&triangles.BY[i]), ay);
+			const L::Type acx = L::Sub(L::Load(&triangles.CX[i]), ax);
+			const L::Type acy = L::Sub(L::Load(&triangles.CY[i]), ay);
+			const L::Type abLength = L::Add(L::Mul(abx, abx), L::Mul(aby, aby));
+			const L::Type acLength = L::Add(L::Mul(acx, acx), L::Mul(acy, acy));
+			const L::Type divider = L::Mul(two, L::Sub(L::Mul(abx, acy), L::Mul(aby, acx)));
+			L::Store(&centerX[i], L::Add(ax, L::Div(L::Sub(L::Mul(acy, abLength), L::Mul(aby, acLength)), divider)));
+			L::Store(&centerY[i], L::Add(ay, L::Div(L::Sub(L::Mul(abx, acLength), L::Mul(acx, abLength)), divider)));
+		}
+#endif
+		for (; i < count; ++i) {
+			Batch::Circumcenter(triangles.AX[i], triangles.AY[i], triangles.BX[i], triangles.BY[i], triangles.CX[i], triangles.CY[i], centerX[i], centerY[i]);
+		}
+	}
+
+}
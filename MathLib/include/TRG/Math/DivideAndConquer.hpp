@@ -0,0 +1,300 @@
+#pragma once
+
+#include "Basics.hpp"
+#include "Geometry.hpp"
+#include <numeric>
+#include <thread>
+
+namespace TRG::Math {
+
+	/**
+	 * Delaunay triangulation with the divide-and-conquer algorithm of Guibas & Stolfi, on a quad-edge structure.
+	 * The points are sorted once, then each half is triangulated and the two halves are merged bottom to top.
+	 * Unlike the incremental insertions it is O(n log n) in the worst case, whatever the distribution of the points.
+	 * With several threads, the top levels of the recursion split the points in vertical strips triangulated in parallel,
+	 * their seams being stitched by the same merge, so the result is the same Delaunay triangulation.
+	 */
+	class DivideAndConquerDelaunay {
+	public:
+		using T = Real;
+		using Vector2 = glm::vec<2, T>;
+
+	public:
+		/// Below this number of points, a strip is not split between threads anymore.
+		static constexpr uint32_t MinParallelPoints = 4096;
+
+	public:
+		/**
+		 * Triangulate the points. The duplicated points are ignored.
+		 * @param points The points to triangulate.
+		 * @param threadCount Number of threads triangulating the strips, 1 to stay on the calling thread.
+		 */
+		explicit DivideAndConquerDelaunay(std::vector<Vector2> points, uint32_t threadCount = 1);
+		~DivideAndConquerDelaunay() = default;
+
+	public:
+		[[nodiscard]] const std::vector<Vector2> &GetPoints() const { return m_Points; }
+		/// Indices of the points used by the triangulation (the first of each duplicate), sorted by x then y.
+		[[nodiscard]] const std::vector<uint32_t> &GetVertices() const { return m_Order; }
+		/// The triangles, as counter-clockwise indices into the points.
+		[[nodiscard]] std::vector<std::array<uint32_t, 3>> GetTriangles() const;
+
+	private:
+		/**
+		 * The quad-edge slots given to a part of the recursion.
+		 * A planar graph of k points has less than 3k edges, so the strip [begin, end[ of the order owns the quad-edges
+		 * [3 begin, 3 end[ and never overlaps with the other strips, and the deleted quad-edges are recycled.
+		 */
+		struct QuadAllocator {
+			std::vector<std::pair<uint32_t, uint32_t>> Ranges;
+			std::vector<uint32_t> FreeQuads;
+		};
+
+		// A quad-edge is 4 consecutive directed edges: the edge, its dual rotated, the edge reversed, the dual reversed.
+		[[nodiscard]] static uint32_t Rot(const uint32_t e) { return (e & ~3u) | ((e + 1) & 3u); }
+		[[nodiscard]] static uint32_t InvRot(const uint32_t e) { return (e & ~3u) | ((e + 3) & 3u); }
+		[[nodiscard]] static uint32_t Sym(const uint32_t e) { return e ^ 2u; }
+
+		[[nodiscard]] uint32_t Onext(const uint32_t e) const { return m_Next[e]; }
+		[[nodiscard]] uint32_t Oprev(const uint32_t e) const { return Rot(m_Next[Rot(e)]); }
+		[[nodiscard]] uint32_t Lnext(const uint32_t e) const { return Rot(m_Next[InvRot(e)]); }
+		[[nodiscard]] uint32_t Rprev(const uint32_t e) const { return m_Next[Sym(e)]; }
+		[[nodiscard]] uint32_t Org(const uint32_t e) const { return m_Origin[e]; }
+		[[nodiscard]] uint32_t Dest(const uint32_t e) const { return m_Origin[Sym(e)]; }
+
+		uint32_t MakeEdge(uint32_t orgId, uint32_t destId, QuadAllocator &allocator);
+		void Splice(uint32_t a, uint32_t b);
+		uint32_t Connect(uint32_t a, uint32_t b, QuadAllocator &allocator);
+		void DeleteEdge(uint32_t e, QuadAllocator &allocator);
+
+		[[nodiscard]] bool IsRightOf(const uint32_t vertexId, const uint32_t e) const {
+			return Math::IsTriangleOriented(m_Points[vertexId], m_Points[Dest(e)], m_Points[Org(e)]);
+		}
+		[[nodiscard]] bool IsLeftOf(const uint32_t vertexId, const uint32_t e) const {
+			return Math::IsTriangleOriented(m_Points[vertexId], m_Points[Org(e)], m_Points[Dest(e)]);
+		}
+
+		/// Sort the order by x then y, the halves being sorted on their own thread down to the given depth.
+		void SortOrder(uint32_t begin, uint32_t end, uint32_t depth);
+
+		/**
+		 * Triangulate the sorted points [begin, end[ of the order, the halves being triangulated on their own thread down to the given depth.
+		 * @return The counter-clockwise convex hull edge out of the leftmost point & the clockwise one out of the rightmost point.
+		 */
+		std::pair<uint32_t, uint32_t> Triangulate(uint32_t begin, uint32_t end, QuadAllocator &allocator, uint32_t depth);
+		/// Merge two adjacent triangulations, given their hull edges as returned by Triangulate.
+		std::pair<uint32_t, uint32_t> Merge(uint32_t ldo, uint32_t ldi, uint32_t rdi, uint32_t rdo, QuadAllocator &allocator);
+
+	private:
+		std::vector<Vector2> m_Points;
+		std::vector<uint32_t> m_Order;
+		std::vector<uint32_t> m_Next;
+		std::vector<uint32_t> m_Origin;
+		// Not a std::vector<bool>, the threads write the flags of neighbouring quad-edges.
+		std::vector<uint8_t> m_Deleted;
+	};
+
+	inline DivideAndConquerDelaunay::DivideAndConquerDelaunay(std::vector<Vector2> points, const uint32_t threadCount) : m_Points(std::move(points)) {
+		uint32_t depth = 0;
+		while ((1u << depth) < threadCount) ++depth;
+
+		m_Order.resize(m_Points.size());
+		std::iota(m_Order.begin(), m_Order.end(), 0u);
+		SortOrder(0, static_cast<uint32_t>(m_Order.size()), depth);
+		m_Order.erase(std::unique(m_Order.begin(), m_Order.end(), [this](const uint32_t a, const uint32_t b) {
+			return m_Points[a] == m_Points[b];
+		}), m_Order.end());
+
+		const auto count = static_cast<uint32_t>(m_Order.size());
+		if (count < 2) return;
+
+		m_Next.resize(4 * 3 * static_cast<size_t>(count));
+		m_Origin.resize(4 * 3 * static_cast<size_t>(count));
+		m_Deleted.resize(3 * static_cast<size_t>(count), true);
+		QuadAllocator allocator{{{0, 3 * count}}, {}};
+		Triangulate(0, count, allocator, depth);
+	}
+
+	inline void DivideAndConquerDelaunay::SortOrder(const uint32_t begin, const uint32_t end, const uint32_t depth) {
+		// The index breaks the ties so the order is the same whatever the number of threads.
+		const auto compare = [this](const uint32_t a, const uint32_t b) {
+			const Vector2 &pa = m_Points[a];
+			const Vector2 &pb = m_Points[b];
+			return pa.x < pb.x || (pa.x == pb.x && (pa.y < pb.y || (pa.y == pb.y && a < b)));
+		};
+		if (depth == 0 || end - begin < 2 * MinParallelPoints) {
+			std::sort(m_Order.begin() + begin, m_Order.begin() + end, compare);
+			return;
+		}
+
+		const uint32_t middle = begin + (end - begin) / 2;
+		std::thread worker([this, begin, middle, depth]() { SortOrder(begin, middle, depth - 1); });
+		SortOrder(middle, end, depth - 1);
+		worker.join();
+		std::inplace_merge(m_Order.begin() + begin, m_Order.begin() + middle, m_Order.begin() + end, compare);
+	}
+
+	inline std::vector<std::array<uint32_t, 3>> DivideAndConquerDelaunay::GetTriangles() const {
+		std::vector<std::array<uint32_t, 3>> triangles;
+		triangles.reserve(2 * m_Order.size());
+		std::vector<bool> visited(m_Next.size(), false);
+
+		for (uint32_t quad = 0; quad < m_Deleted.size(); ++quad) {
+			if (m_Deleted[quad]) continue;
+			for (const uint32_t e: {4 * quad, Sym(4 * quad)}) {
+				if (visited[e]) continue;
+				const uint32_t e1 = Lnext(e);
+				const uint32_t e2 = Lnext(e1);
+				visited[e] = true;
+				// The outer face is walked clockwise, only the triangles are counter-clockwise.
+				if (Lnext(e2) != e || !Math::IsTriangleOriented(m_Points[Org(e)], m_Points[Org(e1)], m_Points[Org(e2)])) continue;
+				visited[e1] = true;
+				visited[e2] = true;
+				triangles.push_back({Org(e), Org(e1), Org(e2)});
+			}
+		}
+		return triangles;
+	}
+
+	inline uint32_t DivideAndConquerDelaunay::MakeEdge(const uint32_t orgId, const uint32_t destId, QuadAllocator &allocator) {
+		uint32_t quad;
+		if (!allocator.FreeQuads.empty()) {
+			quad = allocator.FreeQuads.back();
+			allocator.FreeQuads.pop_back();
+		} else {
+			while (allocator.Ranges.back().first == allocator.Ranges.back().second) allocator.Ranges.pop_back();
+			quad = allocator.Ranges.back().first++;
+		}
+
+		const uint32_t e = 4 * quad;
+		m_Next[e] = e;
+		m_Next[e + 1] = e + 3;
+		m_Next[e + 2] = e + 2;
+		m_Next[e + 3] = e + 1;
+		m_Origin[e] = orgId;
+		m_Origin[e + 2] = destId;
+		m_Deleted[quad] = false;
+		return e;
+	}
+
+	inline void DivideAndConquerDelaunay::Splice(const uint32_t a, const uint32_t b) {
+		const uint32_t alpha = Rot(Onext(a));
+		const uint32_t beta = Rot(Onext(b));
+		std::swap(m_Next[a], m_Next[b]);
+		std::swap(m_Next[alpha], m_Next[beta]);
+	}
+
+	inline uint32_t DivideAndConquerDelaunay::Connect(const uint32_t a, const uint32_t b, QuadAllocator &allocator) {
+		const uint32_t e = MakeEdge(Dest(a), Org(b), allocator);
+		Splice(e, Lnext(a));
+		Splice(Sym(e), b);
+		return e;
+	}
+
+	inline void DivideAndConquerDelaunay::DeleteEdge(const uint32_t e, QuadAllocator &allocator) {
+		Splice(e, Oprev(e));
+		Splice(Sym(e), Oprev(Sym(e)));
+		m_Deleted[e >> 2] = true;
+		allocator.FreeQuads.push_back(e >> 2);
+	}
+
+	inline std::pair<uint32_t, uint32_t> DivideAndConquerDelaunay::Triangulate(const uint32_t begin, const uint32_t end, QuadAllocator &allocator, const uint32_t depth) {
+		const uint32_t count = end - begin;
+		if (count == 2) {
+			const uint32_t a = MakeEdge(m_Order[begin], m_Order[begin + 1], allocator);
+			return {a, Sym(a)};
+		}
+
+		if (count == 3) {
+			const uint32_t s1 = m_Order[begin];
+			const uint32_t s2 = m_Order[begin + 1];
+			const uint32_t s3 = m_Order[begin + 2];
+			const uint32_t a = MakeEdge(s1, s2, allocator);
+			const uint32_t b = MakeEdge(s2, s3, allocator);
+			Splice(Sym(a), b);
+			if (Math::IsTriangleOriented(m_Points[s1], m_Points[s2], m_Points[s3])) {
+				Connect(b, a, allocator);
+				return {a, Sym(b)};
+			}
+			if (Math::IsTriangleOriented(m_Points[s1], m_Points[s3], m_Points[s2])) {
+				const uint32_t c = Connect(b, a, allocator);
+				return {Sym(c), c};
+			}
+			// The 3 points are collinear.
+			return {a, Sym(b)};
+		}
+
+		const uint32_t middle = begin + count / 2;
+		if (depth == 0 || count < 2 * MinParallelPoints) {
+			const auto [ldo, ldi] = Triangulate(begin, middle, allocator, depth);
+			const auto [rdi, rdo] = Triangulate(middle, end, allocator, depth);
+			return Merge(ldo, ldi, rdi, rdo, allocator);
+		}
+
+		// Each strip only touches its own quad-edges, so they can be triangulated concurrently.
+		QuadAllocator leftAllocator{{{3 * begin, 3 * middle}}, {}};
+		QuadAllocator rightAllocator{{{3 * middle, 3 * end}}, {}};
+		std::pair<uint32_t, uint32_t> left;
+		std::thread worker([this, &left, &leftAllocator, begin, middle, depth]() { left = Triangulate(begin, middle, leftAllocator, depth - 1); });
+		const auto [rdi, rdo] = Triangulate(middle, end, rightAllocator, depth - 1);
+		worker.join();
+
+		allocator.Ranges = std::move(leftAllocator.Ranges);
+		allocator.Ranges.insert(allocator.Ranges.end(), rightAllocator.Ranges.begin(), rightAllocator.Ranges.end());
+		allocator.FreeQuads = std::move(leftAllocator.FreeQuads);
+		allocator.FreeQuads.insert(allocator.FreeQuads.end(), rightAllocator.FreeQuads.begin(), rightAllocator.FreeQuads.end());
+		return Merge(left.first, left.second, rdi, rdo, allocator);
+	}
+
+	inline std::pair<uint32_t, uint32_t> DivideAndConquerDelaunay::Merge(uint32_t ldo, uint32_t ldi, uint32_t rdi, uint32_t rdo, QuadAllocator &allocator) {
+		// Lower common tangent of the two halves.
+		while (true) {
+			if (IsLeftOf(Org(rdi), ldi)) {
+				ldi = Lnext(ldi);
+			} else if (IsRightOf(Org(ldi), rdi)) {
+				rdi = Rprev(rdi);
+			} else {
+				break;
+			}
+		}
+
+		uint32_t basel = Connect(Sym(rdi), ldi, allocator);
+		if (Org(ldi) == Org(ldo)) ldo = Sym(basel);
+		if (Org(rdi) == Org(rdo)) rdo = basel;
+
+		// Zip the two halves from bottom to top.
+		const auto isValid = [this, &basel](const uint32_t e) { return IsRightOf(Dest(e), basel); };
+		while (true) {
+			uint32_t lcand = Onext(Sym(basel));
+			if (isValid(lcand)) {
+				while (Math::IsPointInsideCircumcircle(m_Points[Dest(basel)], m_Points[Org(basel)], m_Points[Dest(lcand)], m_Points[Dest(Onext(lcand))])) {
+					const uint32_t next = Onext(lcand);
+					DeleteEdge(lcand, allocator);
+					lcand = next;
+				}
+			}
+
+			uint32_t rcand = Oprev(basel);
+			if (isValid(rcand)) {
+				while (Math::IsPointInsideCircumcircle(m_Points[Dest(basel)], m_Points[Org(basel)], m_Points[Dest(rcand)], m_Points[Dest(Oprev(rcand))])) {
+					const uint32_t next = Oprev(rcand);
+					DeleteEdge(rcand, allocator);
+					rcand = next;
+				}
+			}
+
+			const bool lcandIsValid = isValid(lcand);
+			const bool rcandIsValid = isValid(rcand);
+			if (!lcandIsValid && !rcandIsValid) break;
+
+			if (!lcandIsValid || (rcandIsValid && Math::IsPointInsideCircumcircle(m_Points[Dest(lcand)], m_Points[Org(lcand)], m_Points[Org(rcand)], m_Points[Dest(rcand)]))) {
+				basel = Connect(rcand, Sym(basel), allocator);
+			} else {
+				basel = Connect(Sym(basel), Sym(lcand), allocator);
+			}
+		}
+
+		return {ldo, rdo};
+	}
+
+}
@@ -0,0 +1,355 @@
+#pragma once
+
+#include "Basics.hpp"
+#include "FreeListVector.hpp"
+#include "Predicates.hpp"
+#include <array>
+#include <cmath>
+#include <vector>
+
+namespace TRG::Math {
+
+	/**
+	 * Convex hull of a set of points changing over time, after Overmars & van Leeuwen.
+	 * The points are the leaves of a balanced tree sorted by x then y, and each inner node keeps the bridges joining
+	 * the upper & lower hulls of its two children. An insertion or an erasure recomputes the bridges on the path to the root,
+	 * each one found by going down both children at once, so an update is O(log² n) and never looks at the other points.
+	 * Only orientation tests (and one exact comparison of two lines) are used, so the hull is exact.
+	 */
+	class DynamicConvexShell {
+	public:
+		using T = Real;
+		using Vector2 = glm::vec<2, T>;
+
+	public:
+		DynamicConvexShell() = default;
+		~DynamicConvexShell() = default;
+
+	public:
+		/**
+		 * Add a point in O(log² n). A point already in the set is counted once more.
+		 */
+		void Insert(const Vector2 &point);
+
+		/**
+		 * Remove one copy of a point in O(log² n).
+		 * @return Whether the point was in the set.
+		 */
+		bool Erase(const Vector2 &point);
+
+		/**
+		 * Build the hull in O(h log n).
+		 * @return The vertices of the hull counter-clockwise, from the lowest of the leftmost points, without the points in the middle of an edge.
+		 */
+		[[nodiscard]] std::vector<Vector2> Query() const;
+
+		void Clear();
+
+		/// Number of points, the duplicates included.
+		[[nodiscard]] size_t GetCount() const { return m_Count; }
+		[[nodiscard]] bool IsEmpty() const { return m_Count == 0; }
+
+	private:
+		static constexpr uint32_t InvalidId = FreeListVector<int>::InvalidId;
+
+		/// The leaves of the first & of the second child joined by a hull of a node.
+		struct Bridge {
+			uint32_t First{InvalidId};
+			uint32_t Second{InvalidId};
+		};
+
+		struct Node {
+			Vector2 Point{0};
+			uint32_t Parent{InvalidId};
+			uint32_t Left{InvalidId};
+			uint32_t Right{InvalidId};
+			/// The leftmost & rightmost leaves of the subtree.
+			uint32_t Min{InvalidId};
+			uint32_t Max{InvalidId};
+			int32_t Height{0};
+			/// The number of copies of the point of a leaf.
+			uint32_t Copies{1};
+			/// The bridges of the upper hull, then of the lower hull.
+			std::array<Bridge, 2> Bridges{};
+
+			[[nodiscard]] bool IsLeaf() const { return Left == InvalidId; }
+		};
+
+		// The lower hull is computed as the upper hull of the points turned by half a turn, which reverses their order.
+		template<bool Lower>
+		[[nodiscard]] uint32_t GetFirst(const uint32_t node) const { return Lower ? m_Nodes[node].Right : m_Nodes[node].Left; }
+		template<bool Lower>
+		[[nodiscard]] uint32_t GetSecond(const uint32_t node) const { return Lower ? m_Nodes[node].Left : m_Nodes[node].Right; }
+		template<bool Lower>
+		[[nodiscard]] Vector2 GetPoint(const uint32_t leaf) const { return Lower ? -m_Nodes[leaf].Point : m_Nodes[leaf].Point; }
+
+		[[nodiscard]] static bool IsLess(const Vector2 &a, const Vector2 &b) { return a.x < b.x || (a.x == b.x && a.y < b.y); }
+		[[nodiscard]] static bool IsAsHighAt(const Vector2 &a, const Vector2 &b, const Vector2 &c, const Vector2 &d, const Vector2 &separator);
+
+		[[nodiscard]] uint32_t FindLeaf(const Vector2 &point) const;
+		template<bool Lower>
+		[[nodiscard]] Bridge FindBridge(uint32_t node) const;
+		template<bool Lower>
+		void CollectHull(uint32_t node, uint32_t low, uint32_t high, std::vector<Vector2> &hull) const;
+		template<bool Lower>
+		[[nodiscard]] bool IsOnHull(uint32_t node, const Vector2 &point, uint32_t removedLeaf) const;
+
+		void Update(uint32_t node, std::array<bool, 2> hulls = {true, true});
+		void Replace(uint32_t node, uint32_t by);
+		uint32_t Rotate(uint32_t node, bool toTheRight);
+		void Rebalance(uint32_t node, const Vector2 &point, uint32_t removedLeaf, std::array<bool, 2> changed);
+
+	private:
+		FreeListVector<Node> m_Nodes;
+		uint32_t m_Root{InvalidId};
+		size_t m_Count{0};
+	};
+
+	inline void DynamicConvexShell::Insert(const Vector2 &point) {
+		++m_Count;
+		if (m_Root == InvalidId) {
+			m_Root = m_Nodes.emplace(Node{.Point = point});
+			Update(m_Root);
+			return;
+		}
+		const uint32_t leaf = FindLeaf(point);
+		if (m_Nodes[leaf].Point == point) {
+			++m_Nodes[leaf].Copies;
+			return;
+		}
+
+		// The leaf is replaced by an inner node holding it & the new leaf.
+		const uint32_t added = m_Nodes.emplace(Node{.Point = point});
+		Update(added);
+		const uint32_t parent = m_Nodes[leaf].Parent;
+		const uint32_t inner = m_Nodes.emplace(Node{.Parent = parent});
+		Replace(leaf, inner);
+		const bool isFirst = IsLess(point, m_Nodes[leaf].Point);
+		m_Nodes[inner].Left = isFirst ? added : leaf;
+		m_Nodes[inner].Right = isFirst ? leaf : added;
+		m_Nodes[leaf].Parent = inner;
+		m_Nodes[added].Parent = inner;
+		Rebalance(inner, point, InvalidId, {true, true});
+	}
+
+	inline bool DynamicConvexShell::Erase(const Vector2 &point) {
+		if (m_Root == InvalidId) return false;
+		const uint32_t leaf = FindLeaf(point);
+		if (m_Nodes[leaf].Point != point) return false;
+		--m_Count;
+		if (--m_Nodes[leaf].Copies > 0) return true;
+
+		// The sibling of the leaf takes the place of their parent.
+		const uint32_t parent = m_Nodes[leaf].Parent;
+		m_Nodes.erase(leaf);
+		if (parent == InvalidId) {
+			m_Root = InvalidId;
+			return true;
+		}
+		const Node &removed = m_Nodes[parent];
+		const uint32_t sibling = removed.Left == leaf ? removed.Right : removed.Left;
+		const uint32_t grandParent = removed.Parent;
+		const auto isBridged = [leaf](const Bridge &bridge) { return bridge.First == leaf || bridge.Second == leaf; };
+		const std::array<bool, 2> changed{isBridged(removed.Bridges[0]), isBridged(removed.Bridges[1])};
+		Replace(parent, sibling);
+		m_Nodes[sibling].Parent = grandParent;
+		m_Nodes.erase(parent);
+		Rebalance(grandParent, point, leaf, changed);
+		return true;
+	}
+
+	inline std::vector<DynamicConvexShell::Vector2> DynamicConvexShell::Query() const {
+		if (m_Root == InvalidId) return {};
+		std::vector<Vector2> lower;
+		std::vector<Vector2> upper;
+		CollectHull<true>(m_Root, InvalidId, InvalidId, lower);
+		CollectHull<false>(m_Root, InvalidId, InvalidId, upper);
+		if (upper.size() == 1) return upper;
+
+		// The lower hull from left to right & the upper one back, without the points in line with their neighbours.
+		std::vector<Vector2> shell;
+		shell.reserve(lower.size() + upper.size());
+		const auto addChain = [&shell](const auto begin, const auto end) {
+			const size_t chainStart = shell.size();
+			for (auto it = begin; it != end; ++it) {
+				while (shell.size() >= chainStart + 2 && Orient2D(shell[shell.size() - 2], shell.back(), *it) <= 0) shell.pop_back();
+				shell.push_back(*it);
+			}
+		};
+		addChain(lower.rbegin(), lower.rend());
+		shell.pop_back();
+		addChain(upper.rbegin(), upper.rend());
+		shell.pop_back();
+		return shell;
+	}
+
+	inline void DynamicConvexShell::Clear() {
+		m_Nodes.clear();
+		m_Root = InvalidId;
+		m_Count = 0;
+	}
+
+	/**
+	 * Whether the line AB is at least as high as the line CD on the vertical of the separator S, both going to the right.
+	 * The height of S over a line is its orientation divided by the width of the segment, so it is the sign of
+	 * O(A, B, S) (Dx - Cx) - O(C, D, S) (Bx - Ax).
+	 * A tie between points at the same x is broken as if the plane was sheared by an infinitesimal, making the x distinct.
+	 */
+	inline bool DynamicConvexShell::IsAsHighAt(const Vector2 &a, const Vector2 &b, const Vector2 &c, const Vector2 &d, const Vector2 &separator) {
+		const double sx = separator.x, sy = separator.y;
+		const double abLeft = (a.x - sx) * (b.y - sy), abRight = (a.y - sy) * (b.x - sx);
+		const double cdLeft = (c.x - sx) * (d.y - sy), cdRight = (c.y - sy) * (d.x - sx);
+		const double abWidth = static_cast<double>(b.x) - a.x, cdWidth = static_cast<double>(d.x) - c.x;
+		const double determinant = (abLeft - abRight) * cdWidth - (cdLeft - cdRight) * abWidth;
+		const double permanent = (std::abs(abLeft) + std::abs(abRight)) * std::abs(cdWidth) + (std::abs(cdLeft) + std::abs(cdRight)) * std::abs(abWidth);
+		if (std::abs(determinant) > 16 * Predicates::Epsilon * permanent) return determinant < 0;
+
+		using namespace Predicates;
+		const auto orient = [sx, sy](const Vector2 &p, const Vector2 &q) {
+			return Sum(Product(Difference(p.x, sx), Difference(q.y, sy)), Negate(Product(Difference(p.y, sy), Difference(q.x, sx))));
+		};
+		const auto abOrientation = orient(a, b);
+		const auto cdOrientation = orient(c, d);
+		const double exact = Estimate(Sum(Product(abOrientation, Difference(d.x, c.x)), Negate(Product(cdOrientation, Difference(b.x, a.x)))));
+		if (exact != 0) return exact < 0;
+		return Estimate(Sum(Product(abOrientation, Difference(d.y, c.y)), Negate(Product(cdOrientation, Difference(b.y, a.y))))) <= 0;
+	}
+
+	inline uint32_t DynamicConvexShell::FindLeaf(const Vector2 &point) const {
+		uint32_t node = m_Root;
+		while (!m_Nodes[node].IsLeaf()) {
+			const Node &current = m_Nodes[node];
+			node = IsLess(m_Nodes[m_Nodes[current.Left].Max].Point, point) ? current.Right : current.Left;
+		}
+		return node;
+	}
+
+	/**
+	 * The bridge over two hulls split by a vertical line, going down the children whose half can't hold the bridge.
+	 * AB & CD are the bridges of the current nodes on each side, and each test rules out the half of one of them.
+	 */
+	template<bool Lower>
+	DynamicConvexShell::Bridge DynamicConvexShell::FindBridge(const uint32_t node) const {
+		uint32_t left = GetFirst<Lower>(node);
+		uint32_t right = GetSecond<Lower>(node);
+		const Vector2 separator = GetPoint<Lower>(Lower ? m_Nodes[right].Max : m_Nodes[right].Min);
+		while (true) {
+			const Node &l = m_Nodes[left];
+			const Node &r = m_Nodes[right];
+			if (l.IsLeaf() && r.IsLeaf()) return {left, right};
+			const Vector2 a = GetPoint<Lower>(l.IsLeaf() ? left : l.Bridges[Lower].First);
+			const Vector2 b = GetPoint<Lower>(l.IsLeaf() ? left : l.Bridges[Lower].Second);
+			const Vector2 c = GetPoint<Lower>(r.IsLeaf() ? right : r.Bridges[Lower].First);
+			const Vector2 d = GetPoint<Lower>(r.IsLeaf() ? right : r.Bridges[Lower].Second);
+			// A point on the right above AB means the bridge leaves the left hull before B, & symmetrically.
+			if (!l.IsLeaf() && (Orient2D(a, b, c) > 0 || Orient2D(a, b, d) > 0)) left = GetFirst<Lower>(left);
+			else if (!r.IsLeaf() && (Orient2D(c, d, a) > 0 || Orient2D(c, d, b) > 0)) right = GetSecond<Lower>(right);
+			else if (l.IsLeaf()) right = GetFirst<Lower>(right);
+			else if (r.IsLeaf()) left = GetSecond<Lower>(left);
+			// Both lines are above the other hull: where they cross tells which side is wrong.
+			else if (IsAsHighAt(a, b, c, d, separator)) left = GetSecond<Lower>(left);
+			else right = GetFirst<Lower>(right);
+		}
+	}
+
+	/**
+	 * Add the vertices of the upper hull of the node between the leaves low & high (InvalidId for no bound), from left to right.
+	 * The hull of a node is the one of its first child up to the bridge, then the one of its second child from the bridge.
+	 */
+	template<bool Lower>
+	void DynamicConvexShell::CollectHull(const uint32_t node, const uint32_t low, const uint32_t high, std::vector<Vector2> &hull) const {
+		const auto isBefore = [this](const uint32_t a, const uint32_t b) { return IsLess(GetPoint<Lower>(a), GetPoint<Lower>(b)); };
+		if (low != InvalidId && high != InvalidId && isBefore(high, low)) return;
+		const Node &current = m_Nodes[node];
+		if (current.IsLeaf()) {
+			if ((low == InvalidId || !isBefore(node, low)) && (high == InvalidId || !isBefore(high, node))) hull.push_back(current.Point);
+			return;
+		}
+		const Bridge &bridge = current.Bridges[Lower];
+		if (low == InvalidId || !isBefore(bridge.First, low)) {
+			CollectHull<Lower>(GetFirst<Lower>(node), low, high != InvalidId && isBefore(high, bridge.First) ? high : bridge.First, hull);
+		}
+		if (high == InvalidId || !isBefore(high, bridge.Second)) {
+			CollectHull<Lower>(GetSecond<Lower>(node), low != InvalidId && isBefore(bridge.Second, low) ? low : bridge.Second, high, hull);
+		}
+	}
+
+	/**
+	 * Whether the point, in one of the children of the node & on its hull, is on the hull of the node too.
+	 * An erased leaf is still known by its id, as an end of the bridges it was part of.
+	 */
+	template<bool Lower>
+	bool DynamicConvexShell::IsOnHull(const uint32_t node, const Vector2 &point, const uint32_t removedLeaf) const {
+		const Bridge &bridge = m_Nodes[node].Bridges[Lower];
+		if (bridge.First == removedLeaf || bridge.Second == removedLeaf) return true;
+		const Vector2 p = Lower ? -point : point;
+		const Node &second = m_Nodes[GetSecond<Lower>(node)];
+		if (IsLess(p, GetPoint<Lower>(Lower ? second.Max : second.Min))) return !IsLess(GetPoint<Lower>(bridge.First), p);
+		return !IsLess(p, GetPoint<Lower>(bridge.Second));
+	}
+
+	inline void DynamicConvexShell::Update(const uint32_t node, const std::array<bool, 2> hulls) {
+		Node &current = m_Nodes[node];
+		if (current.IsLeaf()) {
+			current.Height = 0;
+			current.Min = current.Max = node;
+			return;
+		}
+		current.Height = 1 + std::max(m_Nodes[current.Left].Height, m_Nodes[current.Right].Height);
+		current.Min = m_Nodes[current.Left].Min;
+		current.Max = m_Nodes[current.Right].Max;
+		if (hulls[0]) current.Bridges[0] = FindBridge<false>(node);
+		if (hulls[1]) current.Bridges[1] = FindBridge<true>(node);
+	}
+
+	/// Put a node in the place of another one under its parent, the parent of the new one being left to the caller.
+	inline void DynamicConvexShell::Replace(const uint32_t node, const uint32_t by) {
+		const uint32_t parent = m_Nodes[node].Parent;
+		if (parent == InvalidId) m_Root = by;
+		else if (m_Nodes[parent].Left == node) m_Nodes[parent].Left = by;
+		else m_Nodes[parent].Right = by;
+	}
+
+	/// Rotate the node down with its child on the other side going up, and return that child.
+	inline uint32_t DynamicConvexShell::Rotate(const uint32_t node, const bool toTheRight) {
+		const uint32_t child = toTheRight ? m_Nodes[node].Left : m_Nodes[node].Right;
+		const uint32_t moved = toTheRight ? m_Nodes[child].Right : m_Nodes[child].Left;
+		Replace(node, child);
+		m_Nodes[child].Parent = m_Nodes[node].Parent;
+		(toTheRight ? m_Nodes[node].Left : m_Nodes[node].Right) = moved;
+		m_Nodes[moved].Parent = node;
+		(toTheRight ? m_Nodes[child].Right : m_Nodes[child].Left) = node;
+		m_Nodes[node].Parent = child;
+		Update(node);
+		Update(child);
+		return child;
+	}
+
+	/**
+	 * Update the nodes from this one up to the root after the point was added or removed, keeping the heights of the children
+	 * of a node at most one apart. Once the point is not on the hull of a node, the hulls above don't change and keep their bridges.
+	 * @param changed Whether the upper & the lower hulls of the child of the node changed.
+	 */
+	inline void DynamicConvexShell::Rebalance(uint32_t node, const Vector2 &point, const uint32_t removedLeaf, std::array<bool, 2> changed) {
+		const bool inserted = removedLeaf == InvalidId;
+		while (node != InvalidId) {
+			// A removed point changed the hull if it was on the old one, an inserted one if it is on the new one.
+			if (!inserted) changed = {changed[0] && IsOnHull<false>(node, point, removedLeaf), changed[1] && IsOnHull<true>(node, point, removedLeaf)};
+			Update(node, changed);
+			if (inserted) changed = {changed[0] && IsOnHull<false>(node, point, removedLeaf), changed[1] && IsOnHull<true>(node, point, removedLeaf)};
+			const Node &current = m_Nodes[node];
+			const int32_t balance = m_Nodes[current.Left].Height - m_Nodes[current.Right].Height;
+			if (balance > 1) {
+				const Node &left = m_Nodes[current.Left];
+				if (m_Nodes[left.Left].Height < m_Nodes[left.Right].Height) Rotate(current.Left, false);
+				node = Rotate(node, true);
+			} else if (balance < -1) {
+				const Node &right = m_Nodes[current.Right];
+				if (m_Nodes[right.Right].Height < m_Nodes[right.Left].Height) Rotate(current.Right, true);
+				node = Rotate(node, false);
+			}
+			node = m_Nodes[node].Parent;
+		}
+	}
+
+}
@@ -0,0 +1,194 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace TRG::Math {
+
+	/**
+	 * Contiguous id-addressed container with a free-list.
+	 * The id of an element is its index in the storage, so lookup is O(1), and the ids
+	 * of erased elements are recycled by the next insertion. An erased slot stores its place in the free list
+	 * instead of its id, so inserting a specific id is O(1) too.
+	 * The iteration mimics a `std::map<uint32_t, T>` (yields `std::pair<uint32_t, T>`) but skips the erased slots.
+	 * @tparam T Type of the element stored.
+	 */
+	template<typename T>
+	class FreeListVector {
+	public:
+		static constexpr uint32_t InvalidId = std::numeric_limits<uint32_t>::max();
+		/// Set on the id of the erased slots, the other bits being the index of the slot in the free list.
+		static constexpr uint32_t FreeBit = 1u << 31;
+		using value_type = std::pair<uint32_t, T>;
+		using size_type = std::size_t;
+
+		template<bool IsConst>
+		class Iterator {
+		public:
+			using iterator_category = std::forward_iterator_tag;
+			using value_type = FreeListVector::value_type;
+			using difference_type = std::ptrdiff_t;
+			using pointer = std::conditional_t<IsConst, const value_type *, value_type *>;
+			using reference = std::conditional_t<IsConst, const value_type &, value_type &>;
+			using storage = std::conditional_t<IsConst, const std::vector<value_type>, std::vector<value_type>>;
+		public:
+			Iterator() = default;
+			Iterator(storage *slots, const size_type index) : m_Slots(slots), m_Index(index) { SkipErased(); }
+			operator Iterator<true>() const { return Iterator<true>(m_Slots, m_Index); }
+		public:
+			reference operator*() const { return (*m_Slots)[m_Index]; }
+			pointer operator->() const { return &(*m_Slots)[m_Index]; }
+			Iterator &operator++() { ++m_Index; SkipErased(); return *this; }
+			Iterator operator++(int) { Iterator tmp = *this; ++(*this); return tmp; }
+			[[nodiscard]] bool operator==(const Iterator &other) const { return m_Index == other.m_Index; }
+			[[nodiscard]] bool operator!=(const Iterator &other) const { return m_Index != other.m_Index; }
+			[[nodiscard]] size_type index() const { return m_Index; }
+		private:
+			void SkipErased() {
+				while (m_Index < m_Slots->size() && ((*m_Slots)[m_Index].first & FreeBit)) ++m_Index;
+			}
+		private:
+			storage *m_Slots{nullptr};
+			size_type m_Index{0};
+		};
+
+		using iterator = Iterator<false>;
+		using const_iterator = Iterator<true>;
+
+	public:
+		FreeListVector() = default;
+		~FreeListVector() = default;
+
+	public:
+		/**
+		 * Insert a new element, reusing the last erased slot if any.
+		 * @param value The element to insert.
+		 * @return The id of the inserted element.
+		 */
+		uint32_t emplace(T value = T{}) {
+			if (!m_FreeIds.empty()) {
+				const uint32_t id = m_FreeIds.back();
+				m_FreeIds.pop_back();
+				m_Slots[id] = {id, std::move(value)};
+				++m_Count;
+				return id;
+			}
+			const auto id = static_cast<uint32_t>(m_Slots.size());
+			assert(id < FreeBit);
+			m_Slots.emplace_back(id, std::move(value));
+			++m_Count;
+			return id;
+		}
+
+		/**
+		 * Insert an element with a specific id. Only ids that are not in use are accepted.
+		 * @return An iterator to the element and whether it was inserted.
+		 */
+		std::pair<iterator, bool> insert(const value_type &pair) {
+			const uint32_t id = pair.first;
+			assert(id < FreeBit);
+			if (contains(id)) return {iterator(&m_Slots, id), false};
+			if (id >= m_Slots.size()) {
+				for (auto i = static_cast<uint32_t>(m_Slots.size()); i < id; ++i) {
+					m_Slots.emplace_back(FreeBit | static_cast<uint32_t>(m_FreeIds.size()), T{});
+					m_FreeIds.push_back(i);
+				}
+				m_Slots.emplace_back(id, pair.second);
+			} else {
+				// The last free id takes the place of the inserted one.
+				const uint32_t position = m_Slots[id].first & ~FreeBit;
+				const uint32_t last = m_FreeIds.back();
+				m_FreeIds[position] = last;
+				m_Slots[last].first = FreeBit | position;
+				m_FreeIds.pop_back();
+				m_Slots[id] = pair;
+			}
+			++m_Count;
+			return {iterator(&m_Slots, id), true};
+		}
+
+		void erase(const uint32_t id) {
+			assert(contains(id));
+			// The element is released now rather than when the slot is reused.
+			m_Slots[id] = {FreeBit | static_cast<uint32_t>(m_FreeIds.size()), T{}};
+			m_FreeIds.push_back(id);
+			--m_Count;
+		}
+
+		void erase(const const_iterator it) {
+			erase(static_cast<uint32_t>(it.index()));
+		}
+
+		void clear() {
+			m_Slots.clear();
+			m_FreeIds.clear();
+			m_Count = 0;
+		}
+
+		void reserve(const size_type capacity) {
+			m_Slots.reserve(capacity);
+		}
+
+	public:
+		[[nodiscard]] bool contains(const uint32_t id) const {
+			return id < m_Slots.size() && !(m_Slots[id].first & FreeBit);
+		}
+
+		[[nodiscard]] T &at(const uint32_t id) {
+			if (!contains(id)) throw std::out_of_range("FreeListVector::at: invalid id");
+			return m_Slots[id].second;
+		}
+
+		[[nodiscard]] const T &at(const uint32_t id) const {
+			if (!contains(id)) throw std::out_of_range("FreeListVector::at: invalid id");
+			return m_Slots[id].second;
+		}
+
+		/**
+		 * Unchecked access to an element. The id must be alive.
+		 */
+		[[nodiscard]] T &operator[](const uint32_t id) {
+			assert(contains(id));
+			return m_Slots[id].second;
+		}
+
+		[[nodiscard]] const T &operator[](const uint32_t id) const {
+			assert(contains(id));
+			return m_Slots[id].second;
+		}
+
+		[[nodiscard]] iterator find(const uint32_t id) {
+			return contains(id) ? iterator(&m_Slots, id) : end();
+		}
+
+		[[nodiscard]] const_iterator find(const uint32_t id) const {
+			return contains(id) ? const_iterator(&m_Slots, id) : end();
+		}
+
+		/// Number of alive elements.
+		[[nodiscard]] size_type size() const { return m_Count; }
+		[[nodiscard]] bool empty() const { return m_Count == 0; }
+		/// Upper bound (exclusive) of every id ever given, usable to size per-id side arrays.
+		[[nodiscard]] uint32_t id_bound() const { return static_cast<uint32_t>(m_Slots.size()); }
+
+	public:
+		[[nodiscard]] iterator begin() { return iterator(&m_Slots, 0); }
+		[[nodiscard]] iterator end() { return iterator(&m_Slots, m_Slots.size()); }
+		[[nodiscard]] const_iterator begin() const { return const_iterator(&m_Slots, 0); }
+		[[nodiscard]] const_iterator end() const { return const_iterator(&m_Slots, m_Slots.size()); }
+		[[nodiscard]] const_iterator cbegin() const { return begin(); }
+		[[nodiscard]] const_iterator cend() const { return end(); }
+
+	private:
+		std::vector<value_type> m_Slots;
+		std::vector<uint32_t> m_FreeIds;
+		size_type m_Count{0};
+	};
+
+}
@@ -5,7 +5,10 @@
 #pragma once
 
 #include "Basics.hpp"
+#include "Predicates.hpp"
 #include <stdexcept>
+#include <span>
+#include <vector>
 
 namespace TRG::Math {
 
@@ -32,10 +35,7 @@ namespace TRG::Math {
 
 	template<typename T = Real, glm::qualifier Q = glm::qualifier::defaultp>
 	inline static bool IsTriangleOriented(const glm::vec<2,T,Q>& AB, const glm::vec<2,T,Q>& AC) {
-		return Determinant(glm::mat<2,2,T,Q>{
-			AB.x, AB.y,
-			AC.x, AC.y,
-		}) > 0;
+		return Orient2D(glm::vec<2,T,Q>{0}, AB, AC) > 0;
 	}
 
 	// template<typename T = Real, glm::qualifier Q = glm::qualifier::defaultp>
@@ -45,11 +45,29 @@ namespace TRG::Math {
 	// 	return IsTriangleOriented(AB, AC, normal);
 	// }
 
+	/**
+	 * Check if the triangle ABC is counter-clockwise. The test is exact, it's not fooled by the rounding of b - a & c - a.
+	 */
 	template<typename T = Real, glm::qualifier Q = glm::qualifier::defaultp>
 	inline static bool IsTriangleOriented(const glm::vec<2,T,Q>& a, const glm::vec<2,T,Q>& b, const glm::vec<2,T,Q>& c) {
-		const auto AB = b - a;
-		const auto AC = c - a;
-		return IsTriangleOriented(AB, AC);
+		return Orient2D(a, b, c) > 0;
+	}
+
+	/**
+	 * Check if A, B & C are exactly on the same line.
+	 */
+	template<typename T = Real, glm::qualifier Q = glm::qualifier::defaultp>
+	inline static bool AreCollinear(const glm::vec<2,T,Q>& a, const glm::vec<2,T,Q>& b, const glm::vec<2,T,Q>& c) {
+		return Orient2D(a, b, c) == 0;
+	}
+
+	/**
+	 * Check if the point P, collinear with the segment AB, is strictly between A & B.
+	 */
+	template<typename T = Real, glm::qualifier Q = glm::qualifier::defaultp>
+	inline static bool IsCollinearPointInsideSegment(const glm::vec<2,T,Q>& a, const glm::vec<2,T,Q>& b, const glm::vec<2,T,Q>& p) {
+		if (a.x != b.x) return (a.x < p.x && p.x < b.x) || (b.x < p.x && p.x < a.x);
+		return (a.y < p.y && p.y < b.y) || (b.y < p.y && p.y < a.y);
 	}
 
 	template<class fwd_iterator, typename T = Real, glm::qualifier Q = glm::qualifier::defaultp>
@@ -122,12 +140,7 @@ namespace TRG::Math {
 	inline static bool PointIsInsideTriangle(glm::vec<2,T,Q> a, glm::vec<2,T,Q> b, glm::vec<2,T,Q> c, glm::vec<2,T,Q> p) {
 		if (a == b || a == c || b == c) return false;
 		if (a == p || b == p || c == p) return true;
-
-		{
-			const auto AB = b - a;
-			const auto AC = c - a;
-			if (std::abs(Math::Dot(Math::Normalize(AB), Math::Normalize(AC))) >= 1 - REAL_EPSILON) return false;
-		}
+		if (Math::AreCollinear(a,b,c)) return false;
 
 		if (!Math::IsTriangleOriented(a,b,c)) {
 			std::swap(b,c);
@@ -136,6 +149,20 @@ namespace TRG::Math {
 		return Math::IsTriangleOriented(a,b,p) && Math::IsTriangleOriented(b,c,p) && Math::IsTriangleOriented(c,a,p);
 	}
 
+	/**
+	 * Check if the point is strictly inside the circumcircle of the triangle ABC, whatever the orientation of ABC.
+	 * The test is the sign of the exact in-circle determinant, no circle is built,
+	 * so it stays reliable for the big and flat triangles where `GetCircle` loses all its precision.
+	 * The cocircular points are not inside, and nothing is inside a degenerated triangle.
+	 */
+	template<typename T, glm::qualifier Q = glm::qualifier::defaultp>
+	inline static bool IsPointInsideCircumcircle(const glm::vec<2,T,Q>& a, const glm::vec<2,T,Q>& b, const glm::vec<2,T,Q>& c, const glm::vec<2,T,Q>& p) {
+		const double orientation = Orient2D(a, b, c);
+		if (orientation == 0) return false;
+		const double determinant = InCircle(a, b, c, p);
+		return orientation > 0 ? determinant > 0 : determinant < 0;
+	}
+
 	template<typename T, glm::qualifier Q = glm::qualifier::defaultp>
 	inline static glm::vec<3,T,Q> GetSphereCenter(const glm::vec<3,T,Q>& a, const glm::vec<3,T,Q>& b, const glm::vec<3,T,Q>& c) {
 		const glm::vec<3,T,Q> cross_abbc = Math::Cross(a - b, b - c);
@@ -172,6 +199,23 @@ namespace TRG::Math {
 		return Sphere{a * alpha + b * beta + c * gamma, std::abs(radius)};
 	}
 
+	/**
+	 * The circumsphere of the tetrahedron ABCD, in floating point, so it's only an approximation for the flat tetrahedra.
+	 * Use `InSphere` when the answer must be exact.
+	 */
+	template<typename T, glm::qualifier Q = glm::qualifier::defaultp>
+	inline static Sphere<T,Q> GetSphere(const glm::vec<3,T,Q>& a, const glm::vec<3,T,Q>& b, const glm::vec<3,T,Q>& c, const glm::vec<3,T,Q>& d) {
+		const glm::vec<3,T,Q> ab = b - a;
+		const glm::vec<3,T,Q> ac = c - a;
+		const glm::vec<3,T,Q> ad = d - a;
+		const T divider = static_cast<T>(2) * Math::Dot(ab, Math::Cross(ac, ad));
+
+		const glm::vec<3,T,Q> offset = (Math::Magnitude2(ab) * Math::Cross(ac, ad)
+		                                + Math::Magnitude2(ac) * Math::Cross(ad, ab)
+		                                + Math::Magnitude2(ad) * Math::Cross(ab, ac)) / divider;
+		return Sphere{a + offset, Math::Magnitude(offset)};
+	}
+
 	template<typename T, glm::qualifier Q = glm::qualifier::defaultp>
 	inline static glm::vec<2,T,Q> GetCircleCenter(const glm::vec<2,T,Q>& a, const glm::vec<2,T,Q>& b, const glm::vec<2,T,Q>& c) {
 		const auto ba = a - b;
@@ -215,4 +259,58 @@ namespace TRG::Math {
 		return Circle{a * alpha + b * beta + c * gamma, std::abs(radius)};
 	}
 
+	/**
+	 * Clip a convex polygon by the half-plane of the points X such that dot(X - point, normal) <= 0.
+	 * @param polygon The points of the convex polygon.
+	 * @param result Replaced by the points of the clipped polygon, in the same orientation.
+	 */
+	template<typename T, glm::qualifier Q = glm::qualifier::defaultp>
+	inline static void ClipConvexPolygon(const std::span<const glm::vec<2,T,Q>> polygon, const glm::vec<2,T,Q>& point, const glm::vec<2,T,Q>& normal, std::vector<glm::vec<2,T,Q>>& result) {
+		result.clear();
+		for (size_t i = 0; i < polygon.size(); ++i) {
+			const auto& current = polygon[i];
+			const auto& next = polygon[(i + 1) % polygon.size()];
+			const T currentDistance = Math::Dot(current - point, normal);
+			const T nextDistance = Math::Dot(next - point, normal);
+			if (currentDistance <= 0) result.push_back(current);
+			if ((currentDistance < 0 && nextDistance > 0) || (currentDistance > 0 && nextDistance < 0)) {
+				const T t = currentDistance / (currentDistance - nextDistance);
+				result.push_back(current + (next - current) * t);
+			}
+		}
+	}
+
+	/// The signed area of the polygon, positive if it's counter-clockwise.
+	template<typename T, glm::qualifier Q = glm::qualifier::defaultp>
+	inline static T GetPolygonArea(const std::span<const glm::vec<2,T,Q>> polygon) {
+		T doubleArea = 0;
+		for (size_t i = 0; i < polygon.size(); ++i) {
+			const auto& current = polygon[i];
+			const auto& next = polygon[(i + 1) % polygon.size()];
+			doubleArea += current.x * next.y - next.x * current.y;
+		}
+		return doubleArea * static_cast<T>(0.5);
+	}
+
+	/// The centroid of the area of the polygon, the mean of its points if the area is null.
+	template<typename T, glm::qualifier Q = glm::qualifier::defaultp>
+	inline static glm::vec<2,T,Q> GetPolygonCentroid(const std::span<const glm::vec<2,T,Q>> polygon) {
+		if (polygon.empty()) return glm::vec<2,T,Q>{0};
+		// Relative to the first point, to keep the precision far from the origin.
+		const auto origin = polygon[0];
+		T doubleArea = 0;
+		glm::vec<2,T,Q> weighted{0};
+		glm::vec<2,T,Q> mean{0};
+		for (size_t i = 0; i < polygon.size(); ++i) {
+			const auto current = polygon[i] - origin;
+			const auto next = polygon[(i + 1) % polygon.size()] - origin;
+			const T cross = current.x * next.y - next.x * current.y;
+			doubleArea += cross;
+			weighted += (current + next) * cross;
+			mean += current;
+		}
+		if (doubleArea == 0) return origin + mean / static_cast<T>(polygon.size());
+		return origin + weighted / (static_cast<T>(3) * doubleArea);
+	}
+
 }
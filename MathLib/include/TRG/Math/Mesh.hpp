@@ -5,6 +5,11 @@
 #pragma once
 
 #include "Basics.hpp"
+#include "Geometry.hpp"
+#include "FreeListVector.hpp"
+#include "SpatialSort.hpp"
+#include "DivideAndConquer.hpp"
+#include "Batch.hpp"
 #include <queue>
 
 namespace TRG::Math {
@@ -39,6 +44,18 @@ namespace TRG::Math {
 	};
 
 
+	/// The algorithms able to build the Delaunay triangulation of a set of points.
+	enum class DelaunayAlgorithm {
+		/// Add the points one by one in the given order, like the MeshGraph constructor.
+		Incremental,
+		/// Bowyer-Watson insertions in a BRIO order, the fastest on usual inputs.
+		BowyerWatson,
+		/// Guibas & Stolfi divide-and-conquer, O(n log n) in the worst case.
+		DivideAndConquer,
+		/// Divide-and-conquer with the strips of points triangulated on all the hardware threads.
+		ParallelDivideAndConquer,
+	};
+
 	class MeshGraph {
 	public:
 		using T = Real;
@@ -47,6 +64,10 @@ namespace TRG::Math {
 
 		struct Vertex {
 			Vector2 Position;
+			/// The height of the vertex over the plane of the triangulation, which ignores it. Zero unless the mesh is a terrain.
+			T Height{0};
+			/// One of the edges of the vertex, where the walks around it start.
+			std::optional<uint32_t> IncidentEdge{std::nullopt};
 		};
 
 		struct Edge {
@@ -54,6 +75,8 @@ namespace TRG::Math {
 			uint32_t VertexB;
 			std::optional<uint32_t> TriangleLeft{std::nullopt};
 			std::optional<uint32_t> TriangleRight{std::nullopt};
+			/// A constrained edge is never flipped, see `InsertConstraint`.
+			bool Constrained{false};
 		};
 
 		struct Triangle {
@@ -62,6 +85,41 @@ namespace TRG::Math {
 			uint32_t EdgeCA;
 		};
 
+		struct Circumcircle {
+			Vector2 Center;
+			T SquaredRadius;
+		};
+
+		struct VoronoiEdge {
+			Vector2 From;
+			Vector2 To;
+			/// The dual of a border edge is a ray, `To` is then a point of the ray outside the mesh.
+			bool Infinite;
+		};
+
+		struct VoronoiDiagram {
+			/// The circumcenters of the triangles, indexed by the triangle ids.
+			std::vector<std::optional<Vector2>> Vertices;
+			/// The dual of the edges adjacent to a triangle, indexed by the edge ids.
+			std::vector<std::optional<VoronoiEdge>> Edges;
+			/// The version of the mesh graph this diagram is up to date with.
+			uint64_t Version{0};
+		};
+
+		/// The bounded Voronoi cells, stored contiguously.
+		struct VoronoiCells {
+			/// The vertex id of each cell.
+			std::vector<uint32_t> Sites;
+			/// The points of the cell i are the points in [Offsets[i], Offsets[i + 1]).
+			std::vector<uint32_t> Offsets;
+			std::vector<Vector2> Points;
+
+			[[nodiscard]] size_t Size() const { return Sites.size(); }
+			[[nodiscard]] std::span<const Vector2> GetCell(const size_t index) const {
+				return std::span<const Vector2>{Points}.subspan(Offsets[index], Offsets[index + 1] - Offsets[index]);
+			}
+		};
+
 	public:
 		MeshGraph() = default;
 
@@ -78,129 +136,610 @@ namespace TRG::Math {
 			}
 		}
 
+		/**
+		 * Build the Delaunay triangulation of a whole set of points at once.
+		 * By default, the points are inserted with the Bowyer-Watson algorithm inside a super-triangle, in a BRIO order
+		 * (randomized rounds sorted along a Hilbert curve) so the point location walks stay short.
+		 * Much faster than the constructor adding the points one by one for large sets.
+		 * @param vec2Begin Iterator to the first point.
+		 * @param vec2End Iterator past the last point.
+		 * @param algorithm The algorithm used to build the triangulation.
+		 * @return The Delaunay triangulation of the points.
+		 */
+		template<typename const_iter>
+		[[nodiscard]] static MeshGraph BuildDelaunay(const_iter vec2Begin, const_iter vec2End, const DelaunayAlgorithm algorithm = DelaunayAlgorithm::BowyerWatson) {
+			std::vector<Vector2> points;
+			for (const_iter it = vec2Begin; it != vec2End; ++it) {
+				points.push_back(*it);
+			}
+			MeshGraph graph;
+			switch (algorithm) {
+				case DelaunayAlgorithm::Incremental:
+					for (const Vector2 &point: points) {
+						graph.AddDelaunayPoint(point);
+					}
+					break;
+				case DelaunayAlgorithm::BowyerWatson:
+					graph.BulkAddDelaunayPoints(points);
+					break;
+				case DelaunayAlgorithm::DivideAndConquer:
+				case DelaunayAlgorithm::ParallelDivideAndConquer: {
+					const uint32_t threadCount = algorithm == DelaunayAlgorithm::ParallelDivideAndConquer ? std::max(1u, std::thread::hardware_concurrency()) : 1u;
+					const DivideAndConquerDelaunay triangulation(std::move(points), threadCount);
+					graph.AddTriangles(triangulation.GetPoints(), triangulation.GetVertices(), triangulation.GetTriangles());
+					break;
+				}
+			}
+			return graph;
+		}
+
+		/**
+		 * Build a triangulated irregular network approximating a heightfield with Garland & Heckbert's greedy insertion.
+		 * From the corners of the grid, the sample the furthest from the surface of the mesh, vertically, is inserted until
+		 * all of them are within the tolerance. Each triangle keeps its worst sample in a priority queue, and as an insertion
+		 * only creates the triangles around the new vertex, only these are scanned again.
+		 * @param heights The heights of the samples, row after row: the sample (x, y) is `heights[y * width + x]`.
+		 * @param width The number of samples in a row.
+		 * @param depth The number of rows.
+		 * @param tolerance The largest vertical error allowed.
+		 * @param origin The position of the first sample.
+		 * @param spacing The distance between two samples along x & y.
+		 * @param maxPoints Stop once the mesh has that many vertices.
+		 * @return The Delaunay triangulation of the inserted samples, with their height.
+		 * @throw std::invalid_argument If the grid is smaller than 2x2 or doesn't have as many samples as heights.
+		 */
+		[[nodiscard]] static MeshGraph BuildTerrain(std::span<const T> heights, uint32_t width, uint32_t depth, T tolerance, Vector2 origin = Vector2{0, 0}, Vector2 spacing = Vector2{1, 1},
+		                                            uint32_t maxPoints = std::numeric_limits<uint32_t>::max());
+
 	public:
-		void AddPoint(Vector2 point);
-		void AddDelaunayPoint(Vector2 point);
+		/**
+		 * Add a point to the triangulation without caring for the Delaunay criteria.
+		 * @param point The point to add.
+		 * @param triangleHint A triangle near the point, used as the start of the point location walk.
+		 */
+		void AddPoint(Vector2 point, std::optional<uint32_t> triangleHint = std::nullopt);
+		/**
+		 * Add a point to the triangulation while keeping it Delaunay.
+		 * @param point The point to add.
+		 * @param triangleHint A triangle near the point, used as the start of the point location walk.
+		 */
+		void AddDelaunayPoint(Vector2 point, std::optional<uint32_t> triangleHint = std::nullopt);
+		/// Add a point of a terrain while keeping the triangulation Delaunay on the XY plane, z being the height of the vertex.
+		void AddDelaunayPoint(Vector3 point, std::optional<uint32_t> triangleHint = std::nullopt);
 		void DelaunayTriangulation();
 		void RemoveDelaunayPoint(Vector2 point);
+		/// Remove the point while keeping the triangulation Delaunay, a constraint going through the point is kept between its neighbours,
+		/// unless another constraint crosses it there.
 		void RemoveDelaunayPoint(uint32_t pointId);
+		/**
+		 * Remove several points while keeping the triangulation Delaunay.
+		 * The cavities of neighbouring points are merged and each merged hole is triangulated once,
+		 * the ids freed by the removal are reused by the new edges & triangles.
+		 */
+		void RemoveDelaunayPoints(std::span<const uint32_t> pointIds);
+		/**
+		 * Move a point while keeping the triangulation Delaunay, the vertex keeps its id.
+		 * While the point stays in the kernel of its star, the vertex is moved in place and the edges are flipped back to Delaunay,
+		 * otherwise it's removed & inserted again at its new position. Its constrained edges follow it.
+		 * @return False, leaving the mesh untouched, if another point is already at the position
+		 * or if one of the constrained edges of the point would cross another constraint at the new position.
+		 */
+		bool MoveDelaunayPoint(uint32_t pointId, Vector2 position);
+		/**
+		 * Force the segment between two vertices to be in the triangulation, its edges are never flipped afterward.
+		 * The edges crossing the segment are removed and the pseudo-polygons on both sides are triangulated again,
+		 * the triangulation is then constrained Delaunay. A vertex on the segment splits it in several constrained edges.
+		 * The constraints are kept by the insertions & removals of the other points.
+		 * @throw std::runtime_error If the segment crosses another constraint, the part of the segment before it is kept.
+		 */
+		void InsertConstraint(uint32_t vertexA, uint32_t vertexB);
+		/**
+		 * Ruppert's Delaunay refinement: insert the circumcenters of the triangles with a too small angle or a too large area, the worst first.
+		 * The segments, the constrained edges & the border of the mesh, are split in their middle instead when a vertex or the circumcenter
+		 * about to be inserted is inside their diametral circle, so the mesh keeps its shape & its constraints.
+		 * @param minAngle The smallest angle allowed, in radians. The smaller angles between two segments are left as they are.
+		 * Up to about 20.7° the refinement always ends, beyond it it can go on until the edges are as short as the precision allows.
+		 * @param maxArea The largest area allowed.
+		 * @param maxPoints Stop after inserting that many points.
+		 * @return The number of points inserted.
+		 */
+		uint32_t RefineDelaunay(T minAngle, T maxArea = std::numeric_limits<T>::max(), uint32_t maxPoints = std::numeric_limits<uint32_t>::max());
 	public:
 		std::pair<std::unordered_map<uint32_t, MeshGraph::Vector2>, std::unordered_set<ReversiblePair<uint32_t, uint32_t>, ReversiblePairHash>> GetVoronoi();
+		/**
+		 * Get the Voronoi diagram dual to the triangulation.
+		 * The diagram is persistent, only the cells around the triangles created, flipped or removed since the last call are updated.
+		 */
+		const VoronoiDiagram& GetVoronoiDiagram();
+		/**
+		 * Compute the Voronoi cell of every vertex, clipped to a convex polygon.
+		 * A cell is empty when its site is too far outside of the polygon.
+		 * @param clip The points of the convex polygon, the cells have the same orientation.
+		 * @param cells Replaced by the cells. The buffers are reused, so the cells can be computed each frame without allocating.
+		 */
+		void GetVoronoiCells(std::span<const Vector2> clip, VoronoiCells &cells) const;
+		/// Compute the Voronoi cell of every vertex, clipped to the rectangle [min, max].
+		void GetVoronoiCells(Vector2 min, Vector2 max, VoronoiCells &cells) const;
+		/**
+		 * Lloyd relaxation toward a centroidal Voronoi tessellation.
+		 * Each iteration moves the vertices to the centroid of their Voronoi cell clipped to the domain, then flips the edges
+		 * back to Delaunay, the vertex ids are kept. A vertex whose move would fold a triangle waits for the next iteration.
+		 * @param clip The points of the convex domain.
+		 * @param iterations The maximum number of iterations.
+		 * @param tolerance Stop once no vertex moved further than it during an iteration.
+		 * @param threadCount The number of threads computing the centroids.
+		 * @return The number of iterations done.
+		 */
+		uint32_t RelaxLloyd(std::span<const Vector2> clip, uint32_t iterations, T tolerance = 0, uint32_t threadCount = 1);
+		/// Incremented by every change of the triangles, a consumer can skip its rebuild when the version didn't change.
+		[[nodiscard]] uint64_t GetVersion() const { return m_Version; }
+	public:
+		/**
+		 * Get the circumcircle of the triangle, from the cache when it's enabled.
+		 * The cached circle of a triangle is dropped when the id is generated again or when the triangle is flipped,
+		 * moving a vertex through `m_Vertices` requires a call to `ClearCircumcircleCache`.
+		 */
+		[[nodiscard]] Circumcircle GetCircumcircle(uint32_t triangleId);
+		/// Compute the circumcircles missing from the cache, in a single batch.
+		void UpdateCircumcircleCache();
+		void ClearCircumcircleCache() { m_Circumcircles.clear(); }
+		/// Enable or disable the circumcircle cache (enabled by default), disabling it releases its memory.
+		void SetCircumcircleCacheEnabled(const bool enabled) { m_CircumcircleCacheEnabled = enabled; if (!enabled) ClearCircumcircleCache(); }
+		[[nodiscard]] bool IsCircumcircleCacheEnabled() const { return m_CircumcircleCacheEnabled; }
 	public:
 		std::optional<uint32_t> GetClosestPoint(Vector2 point);
+		/**
+		 * Find the triangle containing the point with a remembering stochastic visibility walk.
+		 * The walk start from the hint, or the last triangle created, and follow the edges adjacency toward the point.
+		 * @param point The point to locate.
+		 * @param triangleHint A triangle near the point.
+		 * @return The triangle containing the point (possibly on its border), or nothing if the point is outside the mesh.
+		 */
+		[[nodiscard]] std::optional<uint32_t> LocateTriangle(Vector2 point, std::optional<uint32_t> triangleHint = std::nullopt) const;
+		/// The height of the surface at the point, interpolated over the triangle.
+		[[nodiscard]] T InterpolateHeight(uint32_t triangleId, Vector2 point) const;
+		/// The last triangle created by an insertion, a good hint for the next spatially coherent insertion.
+		[[nodiscard]] std::optional<uint32_t> GetLastTriangle() const { return m_LastTriangle; }
+		/// The edges going out of the vertex, turning counter-clockwise around it, from the border for a vertex of the hull.
+		void GetIncidentEdges(uint32_t vertexId, std::vector<uint32_t> &edges) const;
+		/// The vertices on the border of the mesh, counter-clockwise: the convex hull, collinear vertices included.
+		[[nodiscard]] std::vector<uint32_t> GetConvexHull();
 	public:
 		void clear();
 
 	private:
+		void BulkAddDelaunayPoints(const std::vector<Vector2> &points);
+		/**
+		 * Fill an empty graph with an already computed triangulation.
+		 * @param points The positions of the vertices.
+		 * @param vertices The indices of the points to add as vertices.
+		 * @param triangles The triangles, as counter-clockwise indices into the points.
+		 */
+		void AddTriangles(const std::vector<Vector2> &points, const std::vector<uint32_t> &vertices, const std::vector<std::array<uint32_t, 3>> &triangles);
+		/**
+		 * Connect a vertex already in `m_Vertices` to the triangulation, the end of `AddDelaunayPoint`.
+		 * @param containingTriangle The triangle containing the vertex, nothing when it's outside of the mesh.
+		 * @param borderEdge The border edge crossed by the walk when the vertex is outside of the mesh.
+		 */
+		void ConnectDelaunayVertex(uint32_t vertexId, std::optional<uint32_t> containingTriangle, std::optional<uint32_t> borderEdge);
+		/// Insert the vertex with Bowyer-Watson, the triangle must contain the vertex.
+		void InsertDelaunayVertex(uint32_t vertexId, uint32_t containingTriangle);
+		/// Create the triangles between the vertex and each edge (id, A, B) of the border, A, B & the vertex being counter-clockwise.
+		void FanToVertex(uint32_t vertexId, const std::vector<std::tuple<uint32_t, uint32_t, uint32_t>> &border);
+		/**
+		 * Insert a vertex outside of the convex mesh, or on its border.
+		 * @param visibleEdge A border edge the vertex sees, found by the walk that located the vertex outside of the mesh.
+		 * @return False if the vertex couldn't be placed.
+		 */
+		[[nodiscard]] bool InsertHullVertex(uint32_t vertexId, std::optional<uint32_t> visibleEdge = std::nullopt);
+		/// The border edges the point sees, as (edge, A, B) with the mesh on the left of AB, in the order of the hull ring.
+		void GetVisibleHullEdges(Vector2 point, std::optional<uint32_t> visibleEdge, std::vector<std::tuple<uint32_t, uint32_t, uint32_t>> &edges);
+		/// Insert the constraint from the vertex toward the other one, up to the first vertex on the segment, which is returned.
+		uint32_t InsertConstraintSegment(uint32_t fromId, uint32_t toId);
+		/**
+		 * Triangulate the pseudo-polygon on one side of a new constrained edge with Anglada's recursive split.
+		 * @param chain The vertices of the polygon from A to B, excluded, on a single side of AB.
+		 * @param edgeIds The edges of the polygon, the new edges are added to it.
+		 */
+		void TriangulatePseudoPolygon(uint32_t aId, uint32_t bId, const std::vector<uint32_t> &chain, std::unordered_map<ReversiblePair<uint32_t, uint32_t>, uint32_t, ReversiblePairHash> &edgeIds);
+		/// Whether the edge bounds the domain of the refinement: a constrained edge or a border edge.
+		[[nodiscard]] bool IsSegment(uint32_t edgeId) const;
+		/// Whether the opposite vertex of a triangle next to the segment is inside its diametral circle.
+		[[nodiscard]] bool IsSegmentEncroached(uint32_t edgeId) const;
+		/// Split the segment with a vertex in its middle, the halves of a constrained edge are constrained. Return the new vertex, if the rounded middle could be connected.
+		std::optional<uint32_t> SplitSegment(uint32_t edgeId);
+		/// The segments around the cavity of the point whose diametral circle contains it.
+		void GetEncroachedSegments(Vector2 point, uint32_t containingTriangle, std::vector<uint32_t> &segments) const;
+		/// Remove the vertex & its edges, the constraints going through it included.
+		void RemoveDelaunayVertex(uint32_t pointId);
+		/// Whether the vertex can move to the position without folding its star or making the border concave.
+		[[nodiscard]] bool CanMoveInStar(uint32_t vertexId, Vector2 position, const std::vector<uint32_t> &edges, const std::vector<uint32_t> &triangles) const;
+		/// The edges & the triangles around the vertex, counter-clockwise.
+		void GetStar(uint32_t vertexId, std::vector<uint32_t> &edges, std::vector<uint32_t> &triangles) const;
+		/**
+		 * Triangulate the polygon left by the removal of an inner vertex.
+		 * @param removedPosition The position of the removed vertex.
+		 * @param polygon The vertices of the counter-clockwise polygon.
+		 * @param polygonEdges The edge from each vertex of the polygon to the next one.
+		 */
+		void FillStarPolygon(Vector2 removedPosition, const std::vector<uint32_t> &polygon, const std::vector<uint32_t> &polygonEdges);
+		/// Triangulate the pockets left by the removal of a hull vertex, the chain going counter-clockwise around it.
+		void FillHullPocket(const std::vector<uint32_t> &chain, const std::vector<uint32_t> &chainEdges);
+		/// Add the triangles in the concavities of the border so the mesh covers the convex hull.
+		[[nodiscard]] bool CompleteConvexHull();
+		/// Create the triangle ABC from existing edges, the vertices A, B & C must be counter-clockwise.
+		uint32_t AddOrientedTriangle(uint32_t aId, uint32_t bId, uint32_t cId, uint32_t abId, uint32_t bcId, uint32_t caId);
+		/// Flip the edges until all of them, and the ones affected by the flips, respect the Delaunay criteria.
+		void LegalizeEdges(std::queue<uint32_t> &edgeToCheck);
+		/// Like the public one, the border edge crossed by the walk is kept when the point is outside of the mesh.
+		[[nodiscard]] std::optional<uint32_t> LocateTriangle(Vector2 point, std::optional<uint32_t> triangleHint, std::optional<uint32_t> &borderEdge) const;
+
+		/// Make the edge the incident edge of both its vertices, to call for the edges of the vertices whose edges changed.
+		void SetIncidentEdge(uint32_t edgeId);
+		/// The incident edge of the vertex, nothing if the vertex doesn't have any edge.
+		[[nodiscard]] std::optional<uint32_t> GetIncidentEdge(uint32_t vertexId) const;
+		/// The next edge around the vertex, through the triangle after the edge, or nothing when the edge is on the border.
+		[[nodiscard]] std::optional<uint32_t> RotateAroundVertex(uint32_t vertexId, uint32_t edgeId, bool counterClockwise) const;
+		/// A border edge, the entry of the hull ring.
+		[[nodiscard]] std::optional<uint32_t> GetHullEdge();
+		/// The next border edge on the hull ring, the mesh being on the left of the ring.
+		[[nodiscard]] uint32_t GetNextHullEdge(uint32_t edgeId) const;
+		[[nodiscard]] uint32_t GetPreviousHullEdge(uint32_t edgeId) const;
+
 		void ReverseEdge(uint32_t edgeId);
 
 		std::tuple<bool, uint32_t, uint32_t, uint32_t, uint32_t> RespectDelaunay(uint32_t edgeId);
 
 		std::optional<std::tuple<uint32_t, uint32_t, uint32_t> > GetOrientedVerticesOfTriangle(uint32_t triangleId);
 
+		/// The vertices A & B of the edge AB, then the third vertex C, in no particular orientation.
+		[[nodiscard]] std::tuple<uint32_t, uint32_t, uint32_t> GetTriangleVertices(uint32_t triangleId) const;
+
+		[[nodiscard]] Circumcircle CalculateCircumcircle(uint32_t triangleId) const;
+		[[nodiscard]] std::optional<VoronoiEdge> CalculateVoronoiEdge(uint32_t edgeId) const;
+		/// Drop what is derived from the triangle, to call when the triangle is created or changed.
+		void InvalidateTriangle(uint32_t triangleId);
+		/// Remove the triangle, the edges keep their reference to it.
+		void EraseTriangle(uint32_t triangleId);
+		/// Remove the edge, the vertices it was the incident edge of are left without one until they're given another.
+		void EraseEdge(uint32_t edgeId);
+		/// Drop everything derived from the positions of the vertices, to call after moving them.
+		void InvalidateGeometry();
+		/// Whether the triangle is flat or doesn't have the orientation its edges expect anymore.
+		[[nodiscard]] bool IsTriangleFolded(uint32_t triangleId) const;
+		/// The neighbours of the vertex i are neighbours[offsets[i]] to neighbours[offsets[i + 1]].
+		void GetNeighbours(std::vector<uint32_t> &offsets, std::vector<uint32_t> &neighbours) const;
+		/// Clip the polygon to the Voronoi cell of the vertex, the clipped, segments & sides buffers are scratch buffers.
+		void ClipVoronoiCell(uint32_t vertexId, const std::vector<uint32_t> &offsets, const std::vector<uint32_t> &neighbours, std::vector<Vector2> &polygon, std::vector<Vector2> &clipped,
+		                     SegmentBuffer &segments, std::vector<int8_t> &sides) const;
+
 	private:
-		[[nodiscard]] uint32_t GenerateVertexId() { return m_VertexIdGenerator++; };
-		[[nodiscard]] uint32_t GenerateEdgeId() { return m_EdgeIdGenerator++; };
-		[[nodiscard]] uint32_t GenerateTriangleId() { return m_TriangleIdGenerator++; };
+		// The generated ids are already alive (default constructed) in their container.
+		// Beware that generating an id can reallocate the container and invalidate the references into it.
+		[[nodiscard]] uint32_t GenerateVertexId() { return m_Vertices.emplace(); };
+		[[nodiscard]] uint32_t GenerateEdgeId() { return m_Edges.emplace(); };
+		[[nodiscard]] uint32_t GenerateTriangleId() {
+			const uint32_t triangleId = m_Triangles.emplace();
+			InvalidateTriangle(triangleId);
+			return (m_LastTriangle = triangleId).value();
+		};
 
 	public:
-		std::map<uint32_t, Vertex> m_Vertices;
-		std::map<uint32_t, Edge> m_Edges;
-		std::map<uint32_t, Triangle> m_Triangles;
+		FreeListVector<Vertex> m_Vertices;
+		FreeListVector<Edge> m_Edges;
+		FreeListVector<Triangle> m_Triangles;
 
 	private:
-		uint32_t m_VertexIdGenerator{0};
-		uint32_t m_EdgeIdGenerator{0};
-		uint32_t m_TriangleIdGenerator{0};
+		std::optional<uint32_t> m_LastTriangle{std::nullopt};
+		// The last border edge found, the hull ring is walked from it as long as it's still on the border.
+		std::optional<uint32_t> m_HullEdge{std::nullopt};
+		// Once an edge is constrained, the star of a vertex isn't always Delaunay anymore and the removals check more.
+		bool m_HasConstraints{false};
+		// Indexed by the triangle ids.
+		std::vector<std::optional<Circumcircle>> m_Circumcircles;
+		bool m_CircumcircleCacheEnabled{true};
+		uint64_t m_Version{0};
+		VoronoiDiagram m_Voronoi;
+		// The dirty triangles & edges are only recorded once the diagram has been requested.
+		bool m_VoronoiTracked{false};
+		std::vector<uint32_t> m_VoronoiDirtyTriangles;
+		std::vector<uint32_t> m_VoronoiDirtyEdges;
+		// Scratch of the cavity search, kept to not allocate on each insertion.
+		SegmentBuffer m_CavityEdges;
+		TriangleBuffer m_CavityNeighbours;
+		std::vector<int8_t> m_CavityEdgeSides;
+		std::vector<uint8_t> m_CavityNeighbourInside;
 	};
 
 	inline std::pair<std::unordered_map<uint32_t, MeshGraph::Vector2>, std::unordered_set<ReversiblePair<uint32_t, uint32_t>, ReversiblePairHash>> MeshGraph::GetVoronoi() {
-		uint32_t localGenerator = m_TriangleIdGenerator;
-		std::unordered_map<uint32_t, uint32_t> exteriorsPoints;
+		const VoronoiDiagram &diagram = GetVoronoiDiagram();
+		uint32_t localGenerator = m_Triangles.id_bound();
 		std::unordered_map<uint32_t, Vector2> trianglePoints;
 		std::unordered_set<ReversiblePair<uint32_t, uint32_t>, ReversiblePairHash> lines;
 
 		for (const auto& [triangleId, triangle]: m_Triangles) {
-			const auto abId = triangle.EdgeAB;
-			const auto bcId = triangle.EdgeBC;
-			const auto caId = triangle.EdgeCA;
-
-			const auto& AB = m_Edges.at(abId);
-			const auto& BC = m_Edges.at(bcId);
-			const auto& CA = m_Edges.at(caId);
-
-			const auto aId = AB.VertexA;
-			const auto bId = AB.VertexB;
-			const auto cId = BC.VertexA == aId || BC.VertexA == bId ? BC.VertexB : BC.VertexA;
-
-			const auto& A = m_Vertices.at(aId);
-			const auto& B = m_Vertices.at(bId);
-			const auto& C = m_Vertices.at(cId);
-
-			const auto barycenter = (A.Position + B.Position + C.Position) * static_cast<T>(1.0f/3.0f);
-			const auto circle = Math::GetCircle(A.Position, B.Position, C.Position);
-			trianglePoints[triangleId] = circle.Center;
-			if (AB.TriangleLeft && AB.TriangleRight) {
-				lines.insert({AB.TriangleLeft.value(), AB.TriangleRight.value()});
+			trianglePoints[triangleId] = diagram.Vertices[triangleId].value();
+		}
+		for (const auto& [edgeId, edge]: m_Edges) {
+			if (!diagram.Edges[edgeId]) continue;
+			const VoronoiEdge &voronoiEdge = diagram.Edges[edgeId].value();
+			if (!voronoiEdge.Infinite) {
+				lines.insert({edge.TriangleLeft.value(), edge.TriangleRight.value()});
 			} else {
-				assert(AB.TriangleLeft || AB.TriangleRight);
-				const uint32_t exteriorId = exteriorsPoints.contains(abId) ? exteriorsPoints.at(abId) : localGenerator++;
-				if(!exteriorsPoints.contains(abId)) {
-					exteriorsPoints[abId] = exteriorId;
-					const Vector2 middle = (m_Vertices.at(AB.VertexA).Position + m_Vertices.at(AB.VertexB).Position) * static_cast<T>(0.5);
-					const Vector2 middleToCircle = circle.Center - middle;
-					const Vector2 middleToBarycenter = barycenter - middle;
-					const bool mtcPointInside = Math::Dot(Math::Normalize(middleToBarycenter), Math::Normalize(middleToCircle)) >= 0;
-					const Vector2 exterior = circle.Center + (mtcPointInside ? -middleToCircle * static_cast<T>(2) : middleToCircle * static_cast<T>(2));
-					trianglePoints[exteriorId] = exterior;
-				}
-				const uint32_t otherTriangleId = AB.TriangleLeft ? AB.TriangleLeft.value() : AB.TriangleRight.value();
-				lines.insert({otherTriangleId, exteriorId});
+				const uint32_t exteriorId = localGenerator++;
+				trianglePoints[exteriorId] = voronoiEdge.To;
+				lines.insert({edge.TriangleLeft ? edge.TriangleLeft.value() : edge.TriangleRight.value(), exteriorId});
 			}
-			if (BC.TriangleLeft && BC.TriangleRight) {
-				lines.insert({BC.TriangleLeft.value(), BC.TriangleRight.value()});
-			} else {
-				assert(BC.TriangleLeft || BC.TriangleRight);
-				const uint32_t exteriorId = exteriorsPoints.contains(bcId) ? exteriorsPoints.at(bcId) : localGenerator++;
-				if(!exteriorsPoints.contains(bcId)) {
-					exteriorsPoints[bcId] = exteriorId;
-					const Vector2 middle = (m_Vertices.at(BC.VertexA).Position + m_Vertices.at(BC.VertexB).Position) * static_cast<T>(0.5);
-					const Vector2 middleToCircle = circle.Center - middle;
-					const Vector2 middleToBarycenter = barycenter - middle;
-					const bool mtcPointInside = Math::Dot(Math::Normalize(middleToBarycenter), Math::Normalize(middleToCircle)) >= 0;
-					const Vector2 exterior = circle.Center + (mtcPointInside ? -middleToCircle * static_cast<T>(2) : middleToCircle * static_cast<T>(2));
-					trianglePoints[exteriorId] = exterior;
+		}
+
+		return {trianglePoints, lines};
+	}
+
+	inline const MeshGraph::VoronoiDiagram& MeshGraph::GetVoronoiDiagram() {
+		if (!m_VoronoiTracked) {
+			// First request, every triangle is dirty.
+			m_VoronoiTracked = true;
+			m_VoronoiDirtyTriangles.clear();
+			m_VoronoiDirtyEdges.clear();
+			for (const auto& [triangleId, triangle]: m_Triangles) m_VoronoiDirtyTriangles.push_back(triangleId);
+		} else if (m_Voronoi.Version == m_Version) {
+			return m_Voronoi;
+		}
+
+		UpdateCircumcircleCache();
+		if (m_Voronoi.Vertices.size() < m_Triangles.id_bound()) m_Voronoi.Vertices.resize(m_Triangles.id_bound());
+		if (m_Voronoi.Edges.size() < m_Edges.id_bound()) m_Voronoi.Edges.resize(m_Edges.id_bound());
+
+		// The circumcenters first, the edges are computed from them.
+		for (const uint32_t triangleId: m_VoronoiDirtyTriangles) {
+			if (!m_Triangles.contains(triangleId)) {
+				if (triangleId < m_Voronoi.Vertices.size()) m_Voronoi.Vertices[triangleId] = std::nullopt;
+				continue;
+			}
+			m_Voronoi.Vertices[triangleId] = GetCircumcircle(triangleId).Center;
+			const Triangle &triangle = m_Triangles[triangleId];
+			m_VoronoiDirtyEdges.insert(m_VoronoiDirtyEdges.end(), {triangle.EdgeAB, triangle.EdgeBC, triangle.EdgeCA});
+		}
+
+		std::sort(m_VoronoiDirtyEdges.begin(), m_VoronoiDirtyEdges.end());
+		m_VoronoiDirtyEdges.erase(std::unique(m_VoronoiDirtyEdges.begin(), m_VoronoiDirtyEdges.end()), m_VoronoiDirtyEdges.end());
+		for (const uint32_t edgeId: m_VoronoiDirtyEdges) {
+			if (edgeId >= m_Voronoi.Edges.size()) continue;
+			m_Voronoi.Edges[edgeId] = m_Edges.contains(edgeId) ? CalculateVoronoiEdge(edgeId) : std::nullopt;
+		}
+
+		m_VoronoiDirtyTriangles.clear();
+		m_VoronoiDirtyEdges.clear();
+		m_Voronoi.Version = m_Version;
+		return m_Voronoi;
+	}
+
+	inline void MeshGraph::GetVoronoiCells(const std::span<const Vector2> clip, VoronoiCells &cells) const {
+		if (clip.size() < 3) throw std::invalid_argument("MeshGraph::GetVoronoiCells: the clipping polygon needs at least 3 points");
+		cells.Sites.clear();
+		cells.Offsets.clear();
+		cells.Points.clear();
+		cells.Offsets.push_back(0);
+
+		std::vector<uint32_t> offsets;
+		std::vector<uint32_t> neighbours;
+		GetNeighbours(offsets, neighbours);
+
+		std::vector<Vector2> polygon;
+		std::vector<Vector2> clipped;
+		SegmentBuffer segments;
+		std::vector<int8_t> sides;
+		for (const auto &[vertexId, vertex]: m_Vertices) {
+			polygon.assign(clip.begin(), clip.end());
+			ClipVoronoiCell(vertexId, offsets, neighbours, polygon, clipped, segments, sides);
+			cells.Sites.push_back(vertexId);
+			cells.Points.insert(cells.Points.end(), polygon.begin(), polygon.end());
+			cells.Offsets.push_back(static_cast<uint32_t>(cells.Points.size()));
+		}
+	}
+
+	inline void MeshGraph::GetVoronoiCells(const Vector2 min, const Vector2 max, VoronoiCells &cells) const {
+		const std::array<Vector2, 4> rectangle{min, Vector2{max.x, min.y}, max, Vector2{min.x, max.y}};
+		GetVoronoiCells(rectangle, cells);
+	}
+
+	inline void MeshGraph::GetNeighbours(std::vector<uint32_t> &offsets, std::vector<uint32_t> &neighbours) const {
+		const uint32_t vertexBound = m_Vertices.id_bound();
+		offsets.assign(vertexBound + 1, 0);
+		for (const auto &[edgeId, edge]: m_Edges) {
+			++offsets[edge.VertexA + 1];
+			++offsets[edge.VertexB + 1];
+		}
+		for (uint32_t i = 0; i < vertexBound; ++i) offsets[i + 1] += offsets[i];
+		neighbours.resize(offsets.back());
+		std::vector<uint32_t> cursors(offsets.begin(), offsets.end() - 1);
+		for (const auto &[edgeId, edge]: m_Edges) {
+			neighbours[cursors[edge.VertexA]++] = edge.VertexB;
+			neighbours[cursors[edge.VertexB]++] = edge.VertexA;
+		}
+	}
+
+	inline void MeshGraph::ClipVoronoiCell(const uint32_t vertexId, const std::vector<uint32_t> &offsets, const std::vector<uint32_t> &neighbours, std::vector<Vector2> &polygon, std::vector<Vector2> &clipped,
+	                                       SegmentBuffer &segments, std::vector<int8_t> &sides) const {
+		// Every Voronoi neighbour is a Delaunay neighbour, so the cell is the polygon cut by the bisectors with the neighbours.
+		// The points of the polygon are sorted out by the batch orientation against the bisector, taken from the middle
+		// toward the left of the site: the site side is on the left, and a point is never on both sides.
+		const Vector2 &site = m_Vertices[vertexId].Position;
+		for (uint32_t i = offsets[vertexId]; i < offsets[vertexId + 1] && !polygon.empty(); ++i) {
+			const Vector2 &neighbour = m_Vertices[neighbours[i]].Position;
+			const Vector2 middle = (site + neighbour) * static_cast<T>(0.5);
+			const Vector2 normal = neighbour - site;
+			segments.Clear();
+			for (const Vector2 &point: polygon) segments.Add(point, middle);
+			sides.resize(polygon.size());
+			OrientBatch(middle + Vector2{-normal.y, normal.x}, segments, sides.data());
+
+			clipped.clear();
+			for (size_t j = 0; j < polygon.size(); ++j) {
+				const size_t next = (j + 1) % polygon.size();
+				if (sides[j] >= 0) clipped.push_back(polygon[j]);
+				if (sides[j] * sides[next] < 0) {
+					const T currentDistance = Math::Dot(polygon[j] - middle, normal);
+					const T denominator = currentDistance - Math::Dot(polygon[next] - middle, normal);
+					const T t = denominator != 0 ? std::clamp(currentDistance / denominator, static_cast<T>(0), static_cast<T>(1)) : static_cast<T>(0);
+					clipped.push_back(polygon[j] + (polygon[next] - polygon[j]) * t);
 				}
-				const uint32_t otherTriangleId = BC.TriangleLeft ? BC.TriangleLeft.value() : BC.TriangleRight.value();
-				lines.insert({otherTriangleId, exteriorId});
 			}
-			if (CA.TriangleLeft && CA.TriangleRight) {
-				lines.insert({CA.TriangleLeft.value(), CA.TriangleRight.value()});
-			} else {
-				assert(CA.TriangleLeft || CA.TriangleRight);
-				const uint32_t exteriorId = exteriorsPoints.contains(caId) ? exteriorsPoints.at(caId) : localGenerator++;
-				if(!exteriorsPoints.contains(caId)) {
-					exteriorsPoints[caId] = exteriorId;
-					const Vector2 middle = (m_Vertices.at(CA.VertexA).Position + m_Vertices.at(CA.VertexB).Position) * static_cast<T>(0.5);
-					const Vector2 middleToCircle = circle.Center - middle;
-					const Vector2 middleToBarycenter = barycenter - middle;
-					const bool mtcPointInside = Math::Dot(Math::Normalize(middleToBarycenter), Math::Normalize(middleToCircle)) >= 0;
-					const Vector2 exterior = circle.Center + (mtcPointInside ? -middleToCircle * static_cast<T>(2) : middleToCircle * static_cast<T>(2));
-					trianglePoints[exteriorId] = exterior;
+			std::swap(polygon, clipped);
+		}
+	}
+
+	inline uint32_t MeshGraph::RelaxLloyd(const std::span<const Vector2> clip, const uint32_t iterations, const T tolerance, const uint32_t threadCount) {
+		if (clip.size() < 3) throw std::invalid_argument("MeshGraph::RelaxLloyd: the clipping polygon needs at least 3 points");
+		if (m_Triangles.empty()) return 0;
+
+		std::vector<uint32_t> offsets;
+		std::vector<uint32_t> neighbours;
+		std::vector<Vector2> previous(m_Vertices.id_bound());
+		std::vector<std::optional<Vector2>> centroids(m_Vertices.id_bound());
+		std::vector<uint32_t> folded;
+
+		// Each thread compute the centroids of a range of vertex ids, with its own scratch buffers.
+		const auto computeCentroids = [&](const uint32_t begin, const uint32_t end) {
+			std::vector<Vector2> polygon;
+			std::vector<Vector2> clipped;
+			SegmentBuffer segments;
+			std::vector<int8_t> sides;
+			for (uint32_t vertexId = begin; vertexId < end; ++vertexId) {
+				centroids[vertexId] = std::nullopt;
+				// The isolated vertices (e.g. collinear with the others) don't have a cell of their own.
+				if (!m_Vertices.contains(vertexId) || offsets[vertexId] == offsets[vertexId + 1]) continue;
+				polygon.assign(clip.begin(), clip.end());
+				ClipVoronoiCell(vertexId, offsets, neighbours, polygon, clipped, segments, sides);
+				if (polygon.size() >= 3) centroids[vertexId] = Math::GetPolygonCentroid(std::span<const Vector2>{polygon});
+			}
+		};
+
+		for (uint32_t iteration = 0; iteration < iterations; ++iteration) {
+			GetNeighbours(offsets, neighbours);
+			const uint32_t vertexBound = m_Vertices.id_bound();
+			const uint32_t workerCount = std::clamp(threadCount, 1u, std::max(1u, vertexBound / 1024));
+			std::vector<std::thread> workers;
+			for (uint32_t worker = 1; worker < workerCount; ++worker) {
+				workers.emplace_back(computeCentroids, vertexBound * worker / workerCount, vertexBound * (worker + 1) / workerCount);
+			}
+			computeCentroids(0, vertexBound / workerCount);
+			for (std::thread &worker: workers) worker.join();
+
+			for (const auto &[vertexId, vertex]: m_Vertices) {
+				previous[vertexId] = vertex.Position;
+				if (centroids[vertexId]) m_Vertices[vertexId].Position = centroids[vertexId].value();
+			}
+
+			// Put back the vertices of the folded triangles until none are left, the previous positions being a valid mesh.
+			bool hasFolded = true;
+			while (hasFolded) {
+				hasFolded = false;
+				for (const auto &[triangleId, triangle]: m_Triangles) {
+					if (!IsTriangleFolded(triangleId)) continue;
+					const auto [aId, bId, cId] = GetTriangleVertices(triangleId);
+					for (const uint32_t vertexId: {aId, bId, cId}) {
+						if (m_Vertices[vertexId].Position == previous[vertexId]) continue;
+						m_Vertices[vertexId].Position = previous[vertexId];
+						hasFolded = true;
+					}
 				}
-				const uint32_t otherTriangleId = CA.TriangleLeft ? CA.TriangleLeft.value() : CA.TriangleRight.value();
-				lines.insert({otherTriangleId, exteriorId});
 			}
+
+			T maxDistance2 = 0;
+			for (const auto &[vertexId, vertex]: m_Vertices) {
+				maxDistance2 = std::max(maxDistance2, Math::Distance2(vertex.Position, previous[vertexId]));
+			}
+			InvalidateGeometry();
+
+			// The hull vertices moving inward leave concavities on the border.
+			if (!CompleteConvexHull()) {
+				for (const auto &[vertexId, vertex]: m_Vertices) m_Vertices[vertexId].Position = previous[vertexId];
+				InvalidateGeometry();
+				return iteration;
+			}
+			DelaunayTriangulation();
+
+			if (maxDistance2 <= tolerance * tolerance) return iteration + 1;
 		}
+		return iterations;
+	}
 
-		return {trianglePoints, lines};
+	inline bool MeshGraph::IsTriangleFolded(const uint32_t triangleId) const {
+		const auto [aId, bId, cId] = GetTriangleVertices(triangleId);
+		const Edge &AB = m_Edges[m_Triangles[triangleId].EdgeAB];
+		const double orientation = Math::Orient2D(m_Vertices[aId].Position, m_Vertices[bId].Position, m_Vertices[cId].Position);
+		return AB.TriangleLeft == triangleId ? orientation <= 0 : orientation >= 0;
 	}
 
-	inline void MeshGraph::AddPoint(const Vector2 point) {
-		auto it = std::find_if(m_Vertices.begin(), m_Vertices.end(), [point](std::pair<uint32_t, Vertex> vert) {
-			return vert.second.Position == point;
-		});
-		if (it != m_Vertices.end()) return;
+	inline void MeshGraph::InvalidateGeometry() {
+		++m_Version;
+		m_Circumcircles.clear();
+		m_VoronoiTracked = false;
+		m_VoronoiDirtyTriangles.clear();
+		m_VoronoiDirtyEdges.clear();
+	}
+
+	inline std::optional<MeshGraph::VoronoiEdge> MeshGraph::CalculateVoronoiEdge(const uint32_t edgeId) const {
+		const Edge &edge = m_Edges[edgeId];
+		const auto getCenter = [this](const std::optional<uint32_t> triangleId) -> std::optional<Vector2> {
+			if (!triangleId || !m_Triangles.contains(triangleId.value())) return std::nullopt;
+			return m_Voronoi.Vertices[triangleId.value()];
+		};
+		const std::optional<Vector2> left = getCenter(edge.TriangleLeft);
+		const std::optional<Vector2> right = getCenter(edge.TriangleRight);
+		if (left && right) return VoronoiEdge{left.value(), right.value(), false};
+		if (!left && !right) return std::nullopt;
+
+		// The ray goes from the circumcenter through the edge, away from the triangle.
+		const Vector2 center = left ? left.value() : right.value();
+		const auto [aId, bId, cId] = GetTriangleVertices(left ? edge.TriangleLeft.value() : edge.TriangleRight.value());
+		const Vector2 barycenter = (m_Vertices[aId].Position + m_Vertices[bId].Position + m_Vertices[cId].Position) * static_cast<T>(1.0f/3.0f);
+		const Vector2 middle = (m_Vertices[edge.VertexA].Position + m_Vertices[edge.VertexB].Position) * static_cast<T>(0.5);
+		const Vector2 middleToCircle = center - middle;
+		const Vector2 middleToBarycenter = barycenter - middle;
+		const bool mtcPointInside = Math::Dot(Math::Normalize(middleToBarycenter), Math::Normalize(middleToCircle)) >= 0;
+		const Vector2 exterior = center + (mtcPointInside ? -middleToCircle * static_cast<T>(2) : middleToCircle * static_cast<T>(2));
+		return VoronoiEdge{center, exterior, true};
+	}
+
+	inline void MeshGraph::InvalidateTriangle(const uint32_t triangleId) {
+		++m_Version;
+		if (triangleId < m_Circumcircles.size()) m_Circumcircles[triangleId] = std::nullopt;
+		if (m_VoronoiTracked) m_VoronoiDirtyTriangles.push_back(triangleId);
+	}
+
+	inline void MeshGraph::EraseTriangle(const uint32_t triangleId) {
+		if (m_VoronoiTracked) {
+			// The edges lose a neighbour, their dual changes even though the triangle won't be found anymore.
+			const Triangle &triangle = m_Triangles[triangleId];
+			m_VoronoiDirtyEdges.insert(m_VoronoiDirtyEdges.end(), {triangle.EdgeAB, triangle.EdgeBC, triangle.EdgeCA});
+		}
+		InvalidateTriangle(triangleId);
+		m_Triangles.erase(triangleId);
+	}
+
+	inline void MeshGraph::EraseEdge(const uint32_t edgeId) {
+		const Edge &edge = m_Edges[edgeId];
+		for (const uint32_t vertexId: {edge.VertexA, edge.VertexB}) {
+			if (m_Vertices.contains(vertexId) && m_Vertices[vertexId].IncidentEdge == edgeId) m_Vertices[vertexId].IncidentEdge = std::nullopt;
+		}
+		m_Edges.erase(edgeId);
+	}
+
+	inline void MeshGraph::AddPoint(const Vector2 point, const std::optional<uint32_t> triangleHint) {
+		std::optional<uint32_t> borderEdge{std::nullopt};
+		const std::optional<uint32_t> containingTriangle = LocateTriangle(point, triangleHint, borderEdge);
+		if (containingTriangle) {
+			// A duplicate can only be one of the vertices of the triangle containing the point.
+			const auto [aId, bId, cId] = GetTriangleVertices(containingTriangle.value());
+			if (m_Vertices[aId].Position == point || m_Vertices[bId].Position == point || m_Vertices[cId].Position == point) return;
+		} else if (m_Triangles.empty()) {
+			auto it = std::find_if(m_Vertices.begin(), m_Vertices.end(), [point](const std::pair<uint32_t, Vertex>& vert) {
+				return vert.second.Position == point;
+			});
+			if (it != m_Vertices.end()) return;
+		}
 
 
 		const uint32_t newVertId = GenerateVertexId();
@@ -215,7 +754,9 @@ namespace TRG::Math {
 			compatibleEdges.reserve(m_Edges.size());
 
 			// Check if inside
-			for (auto [trId, ABC]: m_Triangles) {
+			if (containingTriangle) {
+				const uint32_t trId = containingTriangle.value();
+				const Triangle ABC = m_Triangles[trId];
 				Edge &AB = m_Edges[ABC.EdgeAB];
 				Edge &secondEdge = m_Edges[ABC.EdgeBC];
 				Edge &thirdEdge = m_Edges[ABC.EdgeCA];
@@ -232,7 +773,7 @@ namespace TRG::Math {
 
 				if (Math::PointIsInsideTriangle(A.Position, B.Position, C.Position, point)) {
 					// Remove existance of triangle.
-					m_Triangles.erase(m_Triangles.find(trId));
+					EraseTriangle(trId);
 
 					compatibleVertices.insert(aId);
 					compatibleVertices.insert(bId);
@@ -250,31 +791,27 @@ namespace TRG::Math {
 					compatibleEdges.push_back(ABC.EdgeAB);
 					compatibleEdges.push_back(ABC.EdgeBC);
 					compatibleEdges.push_back(ABC.EdgeCA);
-					break;
 				}
 			}
 
-			if (compatibleEdges.empty()) {
-				for (auto &[ABId, edgeAB]: m_Edges) {
-					if (edgeAB.TriangleLeft && edgeAB.TriangleRight) continue;
-
-					const auto &vertA = m_Vertices.at(edgeAB.VertexA);
-					const auto &vertB = m_Vertices.at(edgeAB.VertexB);
-
-					const auto aToB = vertB.Position - vertA.Position;
-					const auto aToC = point - vertA.Position;
-
-					const bool isAligned = std::abs(Math::Dot(Math::Normalize(aToB), Math::Normalize(aToC))) >= 1 -
-					                       REAL_EPSILON;
-					if (isAligned) continue;
-
-					const bool isLeft = Math::IsTriangleOriented(aToB, aToC);
-					if (isLeft && edgeAB.TriangleLeft) continue;
-					if (!isLeft && edgeAB.TriangleRight) continue;
-
+			if (compatibleEdges.empty() && !m_Triangles.empty()) {
+				// Outside of the mesh, the hull ring is followed from the border edge the walk crossed.
+				std::vector<std::tuple<uint32_t, uint32_t, uint32_t>> visibleEdges;
+				GetVisibleHullEdges(point, borderEdge, visibleEdges);
+				for (const auto &[ABId, aId, bId]: visibleEdges) {
 					compatibleEdges.push_back(ABId);
-					compatibleVertices.insert(edgeAB.VertexA);
-					compatibleVertices.insert(edgeAB.VertexB);
+					compatibleVertices.insert(aId);
+					compatibleVertices.insert(bId);
+				}
+			} else if (compatibleEdges.empty() && !m_Edges.empty()) {
+				// Without triangles the edges are a chain on a line, the point sees all of them or none of them if it's on the line.
+				const Edge &edge = m_Edges.begin()->second;
+				if (Math::Orient2D(m_Vertices[edge.VertexA].Position, m_Vertices[edge.VertexB].Position, point) != 0) {
+					for (const auto &[ABId, edgeAB]: m_Edges) {
+						compatibleEdges.push_back(ABId);
+						compatibleVertices.insert(edgeAB.VertexA);
+						compatibleVertices.insert(edgeAB.VertexB);
+					}
 				}
 			}
 
@@ -289,7 +826,9 @@ namespace TRG::Math {
 						distance = d;
 					}
 				}
-				m_Edges[GenerateEdgeId()] = {closest, newVertId};
+				const uint32_t newEdgeId = GenerateEdgeId();
+				m_Edges[newEdgeId] = {closest, newVertId};
+				SetIncidentEdge(newEdgeId);
 			} else {
 				std::unordered_map<uint32_t, uint32_t> verticeToPromotedVertices;
 				verticeToPromotedVertices.reserve(compatibleVertices.size());
@@ -298,6 +837,7 @@ namespace TRG::Math {
 					const auto newEdgeId = GenerateEdgeId();
 					verticeToPromotedVertices[vertId] = newEdgeId;
 					m_Edges[newEdgeId] = {vertId, newVertId};
+					SetIncidentEdge(newEdgeId);
 				}
 
 				for (const auto ABId: compatibleEdges) {
@@ -341,177 +881,44 @@ namespace TRG::Math {
 			if (otherId == -1) return; // Too much safety but is okay.
 			const uint32_t newEdge = GenerateEdgeId();
 			m_Edges[newEdge] = {otherId, newVertId};
+			SetIncidentEdge(newEdge);
 		}
 	}
 
-	inline void MeshGraph::AddDelaunayPoint(const Vector2 point) {
-		const uint32_t newVertId = GenerateVertexId();
-		m_Vertices[newVertId] = {point};
-		if (m_Vertices.size() > 2 && !m_Triangles.empty()) {
-			std::vector<uint32_t> edgeToTriangulate;
-			std::unordered_map<ReversiblePair<uint32_t, uint32_t>, uint32_t, ReversiblePairHash> vertexPairToEdge;
-			edgeToTriangulate.reserve(1024);
-			vertexPairToEdge.reserve(1024);
-
-			// Handle Point is inside a triangle
-			for (auto [trId, triangle]: m_Triangles) {
-				Edge &AB = m_Edges[triangle.EdgeAB];
-				Edge &secondEdge = m_Edges[triangle.EdgeBC];
-				Edge &thirdEdge = m_Edges[triangle.EdgeCA];
-
-				const uint32_t aId = AB.VertexA;
-				const uint32_t bId = AB.VertexB;
-				const uint32_t cId = (secondEdge.VertexA != AB.VertexB) && (secondEdge.VertexA != AB.VertexA)
-					                     ? secondEdge.VertexA
-					                     : secondEdge.VertexB;
-
-				const Vertex &A = m_Vertices[aId];
-				const Vertex &B = m_Vertices[bId];
-				const Vertex &C = m_Vertices[cId];
-
-
-				if (Math::PointIsInsideTriangle(A.Position, B.Position, C.Position, point)) {
-					// Remove existence of triangle.
-					m_Triangles.erase(m_Triangles.find(trId));
-
-					edgeToTriangulate.push_back(triangle.EdgeAB);
-					vertexPairToEdge[ReversiblePair{aId, bId}] = triangle.EdgeAB;
-					edgeToTriangulate.push_back(triangle.EdgeBC);
-					vertexPairToEdge[ReversiblePair{bId, cId}] = triangle.EdgeBC;
-					edgeToTriangulate.push_back(triangle.EdgeCA);
-					vertexPairToEdge[ReversiblePair{cId, aId}] = triangle.EdgeCA;
-
-					if (AB.TriangleLeft == trId) AB.TriangleLeft = std::nullopt;
-					else AB.TriangleRight = std::nullopt;
-
-					if (secondEdge.TriangleLeft == trId) secondEdge.TriangleLeft = std::nullopt;
-					else secondEdge.TriangleRight = std::nullopt;
-
-					if (thirdEdge.TriangleLeft == trId) thirdEdge.TriangleLeft = std::nullopt;
-					else thirdEdge.TriangleRight = std::nullopt;
-					break;
-				}
-			}
-
-			// Handle Point is outside triangles
-			if (edgeToTriangulate.empty()) {
-				for (auto &[edgeId, edge]: m_Edges) {
-					if (edge.TriangleLeft && edge.TriangleRight) continue;
-
-					const auto &A = m_Vertices.at(edge.VertexA);
-					const auto &B = m_Vertices.at(edge.VertexB);
-
-					const auto ABCIsOriented = Math::IsTriangleOriented(A.Position, B.Position, point);
-					if (!edge.TriangleLeft && ABCIsOriented) {
-						edgeToTriangulate.push_back(edgeId);
-						vertexPairToEdge[ReversiblePair{edge.VertexA, edge.VertexB}] = edgeId;
-					} else if (!edge.TriangleRight && !ABCIsOriented) {
-						edgeToTriangulate.push_back(edgeId);
-						vertexPairToEdge[ReversiblePair{edge.VertexA, edge.VertexB}] = edgeId;
-					}
-				}
-			}
-
-			while (!edgeToTriangulate.empty()) {
-				const uint32_t edgeId = edgeToTriangulate.back();
-				edgeToTriangulate.pop_back();
-				Edge &edge = m_Edges.at(edgeId);
-
-				const uint32_t aId = edge.VertexA;
-				const uint32_t bId = edge.VertexB;
-				const auto &[APos] = m_Vertices.at(aId);
-				const auto &[BPos] = m_Vertices.at(bId);
-
-				const bool isOriented = Math::IsTriangleOriented(APos, BPos, point);
-				const std::optional<uint32_t> triangleToCheck = isOriented ? edge.TriangleRight : edge.TriangleLeft;
-
-				bool edgeIsValid = true;
-				if (triangleToCheck) {
-					const auto triangleId = triangleToCheck.value();
-					const Triangle &ABC = m_Triangles.at(triangleId);
-					const uint32_t abId = ABC.EdgeAB;
-					const uint32_t bcId = ABC.EdgeBC;
-					const uint32_t caId = ABC.EdgeCA;
-					const bool edgeIsAB = edgeId == abId;
-					const bool edgeIsBC = edgeId == bcId;
-					const bool edgeIsCA = edgeId == caId;
-
-					uint32_t cId; {
-						const Edge &AB = m_Edges.at(abId);
-						const Edge &BC = m_Edges.at(bcId);
-						if (edgeIsAB) {
-							cId = BC.VertexA == aId || BC.VertexA == bId ? BC.VertexB : BC.VertexA;
-						} else {
-							cId = AB.VertexA == aId || AB.VertexA == bId ? AB.VertexB : AB.VertexA;
-						}
-					}
-					const auto &[CPos] = m_Vertices.at(cId);
-					const Circle circle = Math::GetCircle(APos, BPos, CPos);
-					edgeIsValid = !Math::IsPointInsideCircle(circle, point);
-					if (!edgeIsValid) {
-						{
-							auto &firstEdge = m_Edges.at(ABC.EdgeAB);
-							if (firstEdge.TriangleLeft == triangleId) firstEdge.TriangleLeft = std::nullopt;
-							else firstEdge.TriangleRight = std::nullopt;
-						} {
-							auto &secondEdge = m_Edges.at(ABC.EdgeBC);
-							if (secondEdge.TriangleLeft == triangleId) secondEdge.TriangleLeft = std::nullopt;
-							else secondEdge.TriangleRight = std::nullopt;
-						} {
-							auto &thirdEdge = m_Edges.at(ABC.EdgeCA);
-							if (thirdEdge.TriangleLeft == triangleId) thirdEdge.TriangleLeft = std::nullopt;
-							else thirdEdge.TriangleRight = std::nullopt;
-						}
-						m_Edges.erase(m_Edges.find(edgeId));
-						m_Triangles.erase(m_Triangles.find(triangleId));
-						if (!edgeIsAB) edgeToTriangulate.push_back(abId);
-						if (!edgeIsBC) edgeToTriangulate.push_back(bcId);
-						if (!edgeIsCA) edgeToTriangulate.push_back(caId);
-					}
-				}
-
-				if (edgeIsValid) {
-					uint32_t edgeBCId;
-					if (vertexPairToEdge.contains({bId, newVertId})) {
-						edgeBCId = vertexPairToEdge.at({bId, newVertId});
-					} else {
-						const uint32_t bcId = GenerateEdgeId();
-						m_Edges[bcId] = {bId, newVertId};
-						edgeBCId = (vertexPairToEdge[{bId, newVertId}] = bcId);
-					}
-
-					uint32_t edgeACId;
-					if (vertexPairToEdge.contains({aId, newVertId})) {
-						edgeACId = vertexPairToEdge.at({aId, newVertId});
-					} else {
-						const uint32_t acId = GenerateEdgeId();
-						m_Edges[acId] = {aId, newVertId};
-						edgeACId = (vertexPairToEdge[{aId, newVertId}] = acId);
-					}
-					Edge &edgeAC = m_Edges[edgeACId];
-					Edge &edgeBC = m_Edges[edgeBCId];
-
-					uint32_t trId = GenerateTriangleId();
-					if (isOriented) {
-						m_Triangles[trId] = {edgeId, edgeBCId, edgeACId};
-						edge.TriangleLeft = trId;
-
-						if (edgeBC.VertexA == bId) edgeBC.TriangleLeft = trId;
-						else edgeBC.TriangleRight = trId;
+	inline void MeshGraph::AddDelaunayPoint(const Vector2 point, const std::optional<uint32_t> triangleHint) {
+		AddDelaunayPoint(Vector3{point.x, point.y, 0}, triangleHint);
+	}
 
-						if (edgeAC.VertexA == aId) edgeAC.TriangleRight = trId;
-						else edgeAC.TriangleLeft = trId;
-					} else {
-						m_Triangles[trId] = {edgeId, edgeACId, edgeBCId};
-						edge.TriangleRight = trId;
+	inline void MeshGraph::AddDelaunayPoint(const Vector3 position, const std::optional<uint32_t> triangleHint) {
+		const Vector2 point{position.x, position.y};
+		std::optional<uint32_t> borderEdge{std::nullopt};
+		const std::optional<uint32_t> containingTriangle = LocateTriangle(point, triangleHint, borderEdge);
+		if (containingTriangle) {
+			// A duplicate can only be one of the vertices of the triangle containing the point.
+			const auto [aId, bId, cId] = GetTriangleVertices(containingTriangle.value());
+			if (m_Vertices[aId].Position == point || m_Vertices[bId].Position == point || m_Vertices[cId].Position == point) return;
+		} else if (m_Triangles.empty()) {
+			auto it = std::find_if(m_Vertices.begin(), m_Vertices.end(), [point](const std::pair<uint32_t, Vertex>& vert) {
+				return vert.second.Position == point;
+			});
+			if (it != m_Vertices.end()) return;
+		}
 
-						if (edgeBC.VertexA == bId) edgeBC.TriangleRight = trId;
-						else edgeBC.TriangleLeft = trId;
+		const uint32_t newVertId = GenerateVertexId();
+		m_Vertices[newVertId] = {point, position.z};
+		ConnectDelaunayVertex(newVertId, containingTriangle, borderEdge);
+	}
 
-						if (edgeAC.VertexA == aId) edgeAC.TriangleLeft = trId;
-						else edgeAC.TriangleRight = trId;
-					}
-				}
+	inline void MeshGraph::ConnectDelaunayVertex(const uint32_t newVertId, const std::optional<uint32_t> containingTriangle, const std::optional<uint32_t> borderEdge) {
+		const Vector2 point = m_Vertices[newVertId].Position;
+		if (m_Vertices.size() > 2 && !m_Triangles.empty()) {
+			// The point is inside the mesh or on one of its edges, the cavity of Bowyer-Watson splits the edge if needed.
+			if (containingTriangle) {
+				InsertDelaunayVertex(newVertId, containingTriangle.value());
+			} else {
+				// The mesh is convex and the predicates are exact, so a point the walk leaves outside always sees the border edge it crossed.
+				[[maybe_unused]] const bool isConnected = InsertHullVertex(newVertId, borderEdge);
+				assert(isConnected);
 			}
 		} else if (m_Vertices.size() > 2 && m_Triangles.empty()) {
 
@@ -525,7 +932,7 @@ namespace TRG::Math {
 					if (oit->first == newVertId) continue;
 					const auto b = oit->second.Position;
 
-					if (std::abs(Math::Dot(Math::Normalize(b - a), Math::Normalize(point - a))) < 1-std::numeric_limits<T>::epsilon()) {
+					if (!Math::AreCollinear(a, b, point)) {
 						createAllTheTriangles = true;
 						break;
 					}
@@ -548,21 +955,22 @@ namespace TRG::Math {
 					if (a.first.x < b.first.x) {
 						return true;
 					} else if (a.first.x == b.first.x) {
-						return a.first.x <= b.first.y;
+						return a.first.y < b.first.y;
 					} else /* if (a.first.x > b.first.x)*/ {
 						return false;
 					}
 				});
 
+				std::vector<uint32_t> chainEdges;
+				chainEdges.reserve(pointOrdered.size());
 				for (uint32_t i = 1; i < pointOrdered.size(); ++i) {
-					m_Edges.insert({GenerateEdgeId(), {pointOrdered[i-1].second, pointOrdered[i].second}});
+					chainEdges.push_back(m_Edges.emplace({pointOrdered[i-1].second, pointOrdered[i].second}));
 				}
 
-				for (auto& [abId, AB]: m_Edges) {
-					if (AB.VertexA == newVertId || AB.VertexB == newVertId) continue;
-					auto aId = AB.VertexA;
+				for (const uint32_t abId: chainEdges) {
+					const auto aId = m_Edges.at(abId).VertexA;
 					auto a = m_Vertices.at(aId);
-					auto bId = AB.VertexB;
+					const auto bId = m_Edges.at(abId).VertexB;
 					auto b = m_Vertices.at(bId);
 
 					uint32_t bcId;
@@ -584,8 +992,11 @@ namespace TRG::Math {
 						VertexPairToEdge[{aId, newVertId}] = acId;
 					}
 
+					auto& AB = m_Edges[abId];
 					auto& BC = m_Edges[bcId];
 					auto& AC = m_Edges[acId];
+					SetIncidentEdge(abId);
+					SetIncidentEdge(acId);
 
 
 					if (Math::IsTriangleOriented(a.Position, b.Position, point)) {
@@ -617,253 +1028,1029 @@ namespace TRG::Math {
 
 	inline void MeshGraph::RemoveDelaunayPoint(const uint32_t pointId) {
 		if (!m_Vertices.contains(pointId)) return;
+		if (!m_HasConstraints) {
+			RemoveDelaunayVertex(pointId);
+			return;
+		}
+
+		// A vertex in the middle of a constraint leaves the constraint between its two neighbours on it.
+		// Two constraints crossing at the vertex can't both be kept without it, they're both cut.
+		std::vector<uint32_t> constrainedNeighbours;
+		std::vector<uint32_t> edges;
+		GetIncidentEdges(pointId, edges);
+		for (const uint32_t edgeId: edges) {
+			const Edge &edge = m_Edges[edgeId];
+			if (edge.Constrained) constrainedNeighbours.push_back(edge.VertexA == pointId ? edge.VertexB : edge.VertexA);
+		}
+		const Vector2 position = m_Vertices[pointId].Position;
+		std::vector<std::pair<uint32_t, uint32_t>> constraints;
+		for (size_t i = 0; i < constrainedNeighbours.size(); ++i) {
+			for (size_t j = i + 1; j < constrainedNeighbours.size(); ++j) {
+				const Vector2 &a = m_Vertices[constrainedNeighbours[i]].Position;
+				const Vector2 &b = m_Vertices[constrainedNeighbours[j]].Position;
+				if (Math::Orient2D(a, b, position) == 0 && Math::Dot(a - position, b - position) < 0) constraints.emplace_back(constrainedNeighbours[i], constrainedNeighbours[j]);
+			}
+		}
+		RemoveDelaunayVertex(pointId);
+		if (constraints.size() == 1) InsertConstraint(constraints.front().first, constraints.front().second);
+	}
+
+	inline void MeshGraph::RemoveDelaunayVertex(const uint32_t pointId) {
 		if (m_Triangles.empty()) {
 			assert(m_Edges.empty());
-			m_Vertices.erase(m_Vertices.find(pointId));
+			m_Vertices.erase(pointId);
+			return;
+		}
+
+		std::vector<uint32_t> starEdges;
+		std::vector<uint32_t> starTriangles;
+		GetStar(pointId, starEdges, starTriangles);
+
+		// The link of the vertex: for each triangle (vertex, x, y) counter-clockwise, the edge xy goes from x to y.
+		std::unordered_map<uint32_t, std::pair<uint32_t, uint32_t>> nextInLink;
+		std::unordered_set<uint32_t> hasPrevious;
+		for (const uint32_t triangleId: starTriangles) {
+			const Triangle &triangle = m_Triangles[triangleId];
+			for (const uint32_t edgeId: {triangle.EdgeAB, triangle.EdgeBC, triangle.EdgeCA}) {
+				Edge &edge = m_Edges[edgeId];
+				if (edge.VertexA == pointId || edge.VertexB == pointId) continue;
+				if (edge.TriangleLeft == triangleId) {
+					nextInLink[edge.VertexA] = {edge.VertexB, edgeId};
+					hasPrevious.insert(edge.VertexB);
+					edge.TriangleLeft = std::nullopt;
+				} else {
+					nextInLink[edge.VertexB] = {edge.VertexA, edgeId};
+					hasPrevious.insert(edge.VertexA);
+					edge.TriangleRight = std::nullopt;
+				}
+			}
+		}
+
+		const Vector2 position = m_Vertices[pointId].Position;
+		for (const uint32_t triangleId: starTriangles) EraseTriangle(triangleId);
+		for (const uint32_t edgeId: starEdges) EraseEdge(edgeId);
+		m_Vertices.erase(pointId);
+		if (starTriangles.empty()) return;
+
+		// A vertex of the hull has an open link, which starts at the only vertex without a previous one.
+		uint32_t startId = nextInLink.begin()->first;
+		bool isClosed = true;
+		for (const auto &[vertexId, next]: nextInLink) {
+			if (hasPrevious.contains(vertexId)) continue;
+			startId = vertexId;
+			isClosed = false;
+			break;
+		}
+
+		std::vector<uint32_t> polygon{startId};
+		std::vector<uint32_t> polygonEdges;
+		for (auto it = nextInLink.find(startId); it != nextInLink.end(); it = nextInLink.find(it->second.first)) {
+			polygonEdges.push_back(it->second.second);
+			if (it->second.first == startId) break;
+			polygon.push_back(it->second.first);
+		}
+		assert(polygonEdges.size() == starTriangles.size());
+
+		if (isClosed) {
+			FillStarPolygon(position, polygon, polygonEdges);
 		} else {
-			std::set<uint32_t> edgeList2;
-			std::unordered_map<uint32_t, std::unordered_set<uint32_t>> vertexToEdgeMap;
+			FillHullPocket(polygon, polygonEdges);
+		}
+	}
 
-			{
-				std::set<uint32_t> edgeList1;
-				std::set<uint32_t> triangleList;
+	inline void MeshGraph::RemoveDelaunayPoints(const std::span<const uint32_t> pointIds) {
+		std::unordered_set<uint32_t> removed;
+		for (const uint32_t pointId: pointIds) {
+			if (m_Vertices.contains(pointId)) removed.insert(pointId);
+		}
+		if (removed.empty()) return;
+		if (m_Triangles.empty()) {
+			assert(m_Edges.empty());
+			for (const uint32_t pointId: removed) m_Vertices.erase(pointId);
+			return;
+		}
+		if (removed.size() == 1) {
+			RemoveDelaunayPoint(*removed.begin());
+			return;
+		}
 
-				for (const auto& [edgeId, edge] : m_Edges) {
-					if (edge.VertexA != pointId && edge.VertexB != pointId) {
-						continue;
-					}
+		// Along a Hilbert curve, the stars of neighbouring vertices are read one after the other, as are the single removals.
+		std::vector<uint32_t> order(removed.begin(), removed.end());
+		{
+			std::vector<Vector2> positions;
+			positions.reserve(order.size());
+			for (const uint32_t pointId: order) positions.push_back(m_Vertices[pointId].Position);
+			const std::vector<uint64_t> hilbert = HilbertIndices(positions.cbegin(), positions.cend());
+			std::vector<uint32_t> sorted(order.size());
+			std::iota(sorted.begin(), sorted.end(), 0u);
+			std::sort(sorted.begin(), sorted.end(), [&hilbert](const uint32_t a, const uint32_t b) { return hilbert[a] < hilbert[b]; });
+			for (uint32_t &index: sorted) index = order[index];
+			order.swap(sorted);
+		}
 
-					edgeList1.insert(edgeId);
-					if (edge.TriangleLeft) triangleList.insert(edge.TriangleLeft.value());
-					if (edge.TriangleRight) triangleList.insert(edge.TriangleRight.value());
+		// The cavity is every triangle touching a removed vertex, the stars of neighbouring vertices merge in it.
+		// A large batch touches most of the mesh, a single pass over the triangles is cheaper than the stars.
+		std::vector<uint32_t> cavity;
+		bool touchesConstraint = false;
+		if (8 * removed.size() < m_Triangles.size()) {
+			std::vector<uint32_t> starEdges;
+			std::vector<uint32_t> starTriangles;
+			for (const uint32_t pointId: order) {
+				GetStar(pointId, starEdges, starTriangles);
+				cavity.insert(cavity.end(), starTriangles.begin(), starTriangles.end());
+				for (const uint32_t edgeId: starEdges) touchesConstraint |= m_Edges[edgeId].Constrained;
+			}
+		} else {
+			for (const auto &[triangleId, triangle]: m_Triangles) {
+				const auto [aId, bId, cId] = GetTriangleVertices(triangleId);
+				if (removed.contains(aId) || removed.contains(bId) || removed.contains(cId)) cavity.push_back(triangleId);
+			}
+			if (m_HasConstraints) {
+				for (const auto &[edgeId, edge]: m_Edges) {
+					touchesConstraint |= edge.Constrained && (removed.contains(edge.VertexA) || removed.contains(edge.VertexB));
 				}
+			}
+		}
+		// The constraints broken by the removal are mended one vertex at a time.
+		if (touchesConstraint) {
+			for (const uint32_t pointId: order) RemoveDelaunayPoint(pointId);
+			return;
+		}
+		std::sort(cavity.begin(), cavity.end());
+		cavity.erase(std::unique(cavity.begin(), cavity.end()), cavity.end());
+		const std::unordered_set<uint32_t> inCavity(cavity.begin(), cavity.end());
+		const bool keepsTriangles = inCavity.size() < m_Triangles.size();
+
+		// The kept vertices of the cavity, and its border with the kept triangles, going counter-clockwise around the cavity.
+		std::vector<Vector2> points;
+		std::vector<uint32_t> localToVertex;
+		std::unordered_map<uint32_t, uint32_t> vertexToLocal;
+		std::vector<std::pair<uint32_t, uint32_t>> border;
+		std::unordered_map<ReversiblePair<uint32_t, uint32_t>, uint32_t, ReversiblePairHash> keptEdges;
+		std::vector<uint32_t> removedEdges;
+		for (const uint32_t triangleId: cavity) {
+			// A kept vertex can be surrounded by removed ones, without any kept edge.
+			const auto [aId, bId, cId] = GetTriangleVertices(triangleId);
+			for (const uint32_t vertexId: {aId, bId, cId}) {
+				if (removed.contains(vertexId) || !vertexToLocal.try_emplace(vertexId, static_cast<uint32_t>(points.size())).second) continue;
+				points.push_back(m_Vertices[vertexId].Position);
+				localToVertex.push_back(vertexId);
+			}
+			const Triangle &triangle = m_Triangles[triangleId];
+			for (const uint32_t edgeId: {triangle.EdgeAB, triangle.EdgeBC, triangle.EdgeCA}) {
+				const Edge &edge = m_Edges[edgeId];
+				if (removed.contains(edge.VertexA) || removed.contains(edge.VertexB)) {
+					removedEdges.push_back(edgeId);
+					continue;
+				}
+				keptEdges.emplace(ReversiblePair{edge.VertexA, edge.VertexB}, edgeId);
+				const bool cavityOnLeft = edge.TriangleLeft == triangleId;
+				const std::optional<uint32_t> &other = cavityOnLeft ? edge.TriangleRight : edge.TriangleLeft;
+				if (!other || inCavity.contains(other.value())) continue;
+				const uint32_t from = vertexToLocal[cavityOnLeft ? edge.VertexA : edge.VertexB];
+				const uint32_t to = vertexToLocal[cavityOnLeft ? edge.VertexB : edge.VertexA];
+				border.emplace_back(from, to);
+			}
+		}
+		const auto directed = [](const uint32_t from, const uint32_t to) { return (static_cast<uint64_t>(from) << 32) | to; };
+
+		// The Delaunay triangulation of the kept vertices keeps the border, the edges of the cavity being Delaunay without the removed vertices.
+		// The holes are its triangles reached from the border without crossing it.
+		std::vector<std::array<uint32_t, 3>> triangles;
+		if (points.size() >= 3) triangles = DivideAndConquerDelaunay(points).GetTriangles();
+		std::unordered_map<uint64_t, uint32_t> sideToTriangle;
+		sideToTriangle.reserve(3 * triangles.size());
+		for (uint32_t i = 0; i < triangles.size(); ++i) {
+			const auto [a, b, c] = triangles[i];
+			sideToTriangle.emplace(directed(a, b), i);
+			sideToTriangle.emplace(directed(b, c), i);
+			sideToTriangle.emplace(directed(c, a), i);
+		}
 
-				for (const auto triangleId : triangleList) {
-					const auto& triangle = m_Triangles.at(triangleId);
+		std::vector<bool> isHole(triangles.size(), !keepsTriangles);
+		bool isValid = keepsTriangles ? !triangles.empty() : true;
+		std::unordered_set<uint64_t> borderSides;
+		std::vector<uint32_t> holeToVisit;
+		for (const auto &[from, to]: border) {
+			const auto it = sideToTriangle.find(directed(from, to));
+			// With cocircular vertices the triangulation can pick a diagonal crossing the border.
+			if (it == sideToTriangle.end()) {
+				isValid = false;
+				break;
+			}
+			borderSides.insert(directed(from, to));
+			if (!isHole[it->second]) {
+				isHole[it->second] = true;
+				holeToVisit.push_back(it->second);
+			}
+		}
+		if (!isValid) {
+			for (const uint32_t pointId: order) RemoveDelaunayPoint(pointId);
+			return;
+		}
+		while (!holeToVisit.empty()) {
+			const auto [a, b, c] = triangles[holeToVisit.back()];
+			holeToVisit.pop_back();
+			for (const auto &[from, to]: {std::pair{a, b}, std::pair{b, c}, std::pair{c, a}}) {
+				if (borderSides.contains(directed(from, to))) continue;
+				const auto it = sideToTriangle.find(directed(to, from));
+				if (it == sideToTriangle.end() || isHole[it->second]) continue;
+				isHole[it->second] = true;
+				holeToVisit.push_back(it->second);
+			}
+		}
 
-					if(!edgeList1.contains(triangle.EdgeAB)) {
-						Edge& AB = m_Edges.at(triangle.EdgeAB);
-						if (AB.TriangleLeft && triangleList.contains(AB.TriangleLeft.value())) AB.TriangleLeft = std::nullopt;
-						if (AB.TriangleRight && triangleList.contains(AB.TriangleRight.value())) AB.TriangleRight = std::nullopt;
-						vertexToEdgeMap[AB.VertexA].insert(triangle.EdgeAB);
-						vertexToEdgeMap[AB.VertexB].insert(triangle.EdgeAB);
-						edgeList2.insert(triangle.EdgeAB);
-					}
-					if(!edgeList1.contains(triangle.EdgeBC)) {
-						Edge& BC = m_Edges.at(triangle.EdgeBC);
-						if (BC.TriangleLeft && triangleList.contains(BC.TriangleLeft.value())) BC.TriangleLeft = std::nullopt;
-						if (BC.TriangleRight && triangleList.contains(BC.TriangleRight.value())) BC.TriangleRight = std::nullopt;
-						vertexToEdgeMap[BC.VertexA].insert(triangle.EdgeBC);
-						vertexToEdgeMap[BC.VertexB].insert(triangle.EdgeBC);
-						edgeList2.insert(triangle.EdgeBC);
-					}
-					if(!edgeList1.contains(triangle.EdgeCA)) {
-						Edge& CA = m_Edges.at(triangle.EdgeCA);
-						if (CA.TriangleLeft && triangleList.contains(CA.TriangleLeft.value())) CA.TriangleLeft = std::nullopt;
-						if (CA.TriangleRight && triangleList.contains(CA.TriangleRight.value())) CA.TriangleRight = std::nullopt;
-						vertexToEdgeMap[CA.VertexA].insert(triangle.EdgeCA);
-						vertexToEdgeMap[CA.VertexB].insert(triangle.EdgeCA);
-						edgeList2.insert(triangle.EdgeCA);
-					}
-				}
+		// Free the ids first so the triangulation of the holes takes them back.
+		for (const auto &[pair, edgeId]: keptEdges) {
+			Edge &edge = m_Edges[edgeId];
+			if (edge.TriangleLeft && inCavity.contains(edge.TriangleLeft.value())) edge.TriangleLeft = std::nullopt;
+			if (edge.TriangleRight && inCavity.contains(edge.TriangleRight.value())) edge.TriangleRight = std::nullopt;
+		}
+		for (const uint32_t triangleId: cavity) EraseTriangle(triangleId);
+		for (const uint32_t edgeId: removedEdges) {
+			if (m_Edges.contains(edgeId)) EraseEdge(edgeId);
+		}
+		for (const uint32_t pointId: removed) m_Vertices.erase(pointId);
 
-				m_Vertices.erase(m_Vertices.find(pointId));
-				for (const auto edgeId : edgeList1) {
-					const auto it = m_Edges.find(edgeId);
-					if (it != m_Edges.end()) m_Edges.erase(it);
-				}
+		std::queue<uint32_t> edgeToCheck;
+		const auto getEdge = [&](const uint32_t aId, const uint32_t bId) {
+			const auto [it, inserted] = keptEdges.try_emplace(ReversiblePair{aId, bId}, 0);
+			if (inserted) {
+				it->second = GenerateEdgeId();
+				m_Edges[it->second] = {aId, bId};
+				edgeToCheck.push(it->second);
+			}
+			return it->second;
+		};
+		for (uint32_t i = 0; i < triangles.size(); ++i) {
+			if (!isHole[i]) continue;
+			const uint32_t aId = localToVertex[triangles[i][0]];
+			const uint32_t bId = localToVertex[triangles[i][1]];
+			const uint32_t cId = localToVertex[triangles[i][2]];
+			const uint32_t abId = getEdge(aId, bId);
+			const uint32_t bcId = getEdge(bId, cId);
+			const uint32_t caId = getEdge(cId, aId);
+			AddOrientedTriangle(aId, bId, cId, abId, bcId, caId);
+		}
 
-				for (const auto triangleId : triangleList) {
-					const auto it = m_Triangles.find(triangleId);
-					if (it != m_Triangles.end()) m_Triangles.erase(it);
+		// The kept edges crossing the cavity that the new triangulation doesn't use, all of them when the remaining points are collinear.
+		std::vector<std::pair<uint32_t, uint32_t>> constraints;
+		for (const auto &[pair, edgeId]: keptEdges) {
+			const Edge &edge = m_Edges[edgeId];
+			if (edge.TriangleLeft || edge.TriangleRight) {
+				// The border of the cavity is only constrained Delaunay, the new triangles next to it may not be.
+				if (m_HasConstraints) edgeToCheck.push(edgeId);
+				continue;
+			}
+			if (edge.Constrained) constraints.emplace_back(edge.VertexA, edge.VertexB);
+			EraseEdge(edgeId);
+		}
+		LegalizeEdges(edgeToCheck);
+		if (m_Triangles.empty()) return;
+		for (const auto &[aId, bId]: constraints) InsertConstraint(aId, bId);
+	}
+
+	inline bool MeshGraph::MoveDelaunayPoint(const uint32_t pointId, const Vector2 position) {
+		if (!m_Vertices.contains(pointId)) throw std::out_of_range("MeshGraph::MoveDelaunayPoint: invalid vertex id");
+		const Vector2 previous = m_Vertices[pointId].Position;
+		if (previous == position) return true;
+
+		std::vector<uint32_t> starEdges;
+		std::vector<uint32_t> starTriangles;
+		GetStar(pointId, starEdges, starTriangles);
+		if (!starTriangles.empty() && CanMoveInStar(pointId, position, starEdges, starTriangles)) {
+			m_Vertices[pointId].Position = position;
+			// Only the circles of the star changed, so only the spokes & the link can be illegal.
+			std::queue<uint32_t> edgeToCheck;
+			for (const uint32_t edgeId: starEdges) edgeToCheck.push(edgeId);
+			for (const uint32_t triangleId: starTriangles) {
+				InvalidateTriangle(triangleId);
+				const Triangle &triangle = m_Triangles[triangleId];
+				for (const uint32_t edgeId: {triangle.EdgeAB, triangle.EdgeBC, triangle.EdgeCA}) {
+					const Edge &edge = m_Edges[edgeId];
+					if (edge.VertexA != pointId && edge.VertexB != pointId) edgeToCheck.push(edgeId);
 				}
 			}
+			LegalizeEdges(edgeToCheck);
+			return true;
+		}
 
-			const bool polygonIsClosed = std::all_of(vertexToEdgeMap.begin(), vertexToEdgeMap.end(), [](const std::pair<uint32_t, std::unordered_set<uint32_t>>& vToEdge){return vToEdge.second.size() == 2;});
-
-			if (!polygonIsClosed) {
-				throw std::runtime_error("Case where the polygon is not closed is not handled");
-			}
-
-			while (edgeList2.size() > 3) {
-				for (const uint32_t edgeId : edgeList2) {
-					Edge& edge = m_Edges.at(edgeId);
-					const uint32_t aId = edge.VertexA;
-					const uint32_t bId = edge.VertexB;
-					const Vertex& A = m_Vertices.at(edge.VertexA);
-					const Vertex& B = m_Vertices.at(edge.VertexB);
-					const std::array<uint32_t, 2> edgeVerticeIds{aId, bId};
-
-					bool hasAddedTriangle = false;
-
-					for (const auto verticeId : edgeVerticeIds) {
-						if(vertexToEdgeMap.contains(verticeId)) {
-							const auto& vertList = vertexToEdgeMap.at(verticeId);
-							const std::unordered_set<uint32_t>::const_iterator it = std::find_if(vertList.begin(), vertList.end(), [edgeId](const uint32_t id){return id!=edgeId;});
-							if (it == vertList.end()) continue;
-
-							const uint32_t nextEdgeId = *it;
-							Edge& nextEdge = m_Edges.at(nextEdgeId);
-
-							const uint32_t cId = nextEdge.VertexA == edge.VertexA || nextEdge.VertexA == edge.VertexB ? nextEdge.VertexB : nextEdge.VertexA;
-							const Vertex& C = m_Vertices.at(cId);
-
-							const Circle ABC = Math::GetCircle(A.Position, B.Position, C.Position);
-
-							const bool invalidTriangle = std::any_of(vertexToEdgeMap.begin(), vertexToEdgeMap.end(), [this, &ABC,aId,bId,cId](const std::pair<uint32_t, std::unordered_set<uint32_t>>& vertEdgesPair) {
-								const uint32_t pId = vertEdgesPair.first;
-								if (pId == aId) return false;
-								if (pId == bId) return false;
-								if (pId == cId) return false;
-
-								const Vertex& p = m_Vertices.at(vertEdgesPair.first);
-								return Math::IsPointInsideCircle(ABC, p.Position);
-							});
-
-							if (!invalidTriangle) {
-								const bool isOriented = Math::IsTriangleOriented(A.Position,B.Position,C.Position);
-								const bool isAttachedThroughA = aId == nextEdge.VertexA || aId == nextEdge.VertexB;
-
-								const uint32_t newEdgeId = GenerateEdgeId();
-								Edge newEdge = isAttachedThroughA ? Edge{bId, cId} : Edge{aId, cId};
-
-								const uint32_t newTriangleId = GenerateTriangleId();
-								Triangle newTriangle;
-								if (isOriented) {
-									edge.TriangleLeft = newTriangleId;
-									if (isAttachedThroughA) {
-										newEdge.TriangleLeft = newTriangleId; // BC
-										newTriangle = {edgeId, newEdgeId, nextEdgeId}; //AB - BC - AC
-									} else {
-										newEdge.TriangleRight = newTriangleId; // AC;
-										newTriangle = {edgeId, nextEdgeId, newEdgeId}; //AB - BC - AC
-									}
-								} else {
-									edge.TriangleRight = newTriangleId;
-									if (isAttachedThroughA) {
-										newEdge.TriangleRight = newTriangleId; // BC
-										newTriangle = {edgeId, nextEdgeId, newEdgeId}; //AB - AC - BC
-									} else {
-										newEdge.TriangleLeft = newTriangleId; // AC
-										newTriangle = {edgeId, newEdgeId, nextEdgeId}; //AB - AC - BC
-									}
-								}
-
-								{
-									const auto nAId = nextEdge.VertexA;
-									const auto nBId = nextEdge.VertexB;
-									const auto nCId = edge.VertexA == nAId || edge.VertexA == nBId ? edge.VertexB : edge.VertexA;
-
-									if (Math::IsTriangleOriented(m_Vertices.at(nAId).Position,m_Vertices.at(nBId).Position,m_Vertices.at(nCId).Position)) {
-										nextEdge.TriangleLeft = newTriangleId;
-									} else {
-										nextEdge.TriangleRight = newTriangleId;
-									}
-								}
-
-								m_Triangles[newTriangleId] = newTriangle;
-								m_Edges[newEdgeId] = newEdge;
-
-								edgeList2.erase(edgeList2.find(edgeId));
-								edgeList2.erase(edgeList2.find(nextEdgeId));
-								edgeList2.insert(newEdgeId);
-
-								if (isAttachedThroughA) {
-									vertexToEdgeMap.erase(vertexToEdgeMap.find(aId));
-									auto& lstB = vertexToEdgeMap.at(bId);
-									auto& lstC = vertexToEdgeMap.at(cId);
-									lstB.erase(lstB.find(edgeId));
-									lstC.erase(lstC.find(nextEdgeId));
-									lstB.insert(newEdgeId);
-									lstC.insert(newEdgeId);
-								} else {
-									vertexToEdgeMap.erase(vertexToEdgeMap.find(bId));
-									auto& lstA = vertexToEdgeMap.at(aId);
-									auto& lstC = vertexToEdgeMap.at(cId);
-									lstA.erase(lstA.find(edgeId));
-									lstC.erase(lstC.find(nextEdgeId));
-									lstA.insert(newEdgeId);
-									lstC.insert(newEdgeId);
-								}
-
-								hasAddedTriangle = true;
-								break;
-							}
-						}
-					}
+		// A duplicate can only be one of the vertices of the triangle containing the position.
+		if (const std::optional<uint32_t> containingTriangle = LocateTriangle(position)) {
+			const auto [aId, bId, cId] = GetTriangleVertices(containingTriangle.value());
+			for (const uint32_t vertexId: {aId, bId, cId}) {
+				if (vertexId != pointId && m_Vertices[vertexId].Position == position) return false;
+			}
+		} else if (m_Triangles.empty()) {
+			for (const auto &[vertexId, vertex]: m_Vertices) {
+				if (vertexId != pointId && vertex.Position == position) return false;
+			}
+		}
 
-					if (hasAddedTriangle) {
-						break;
+		std::vector<uint32_t> constrainedNeighbours;
+		for (const uint32_t edgeId: starEdges) {
+			const Edge &edge = m_Edges[edgeId];
+			if (edge.Constrained) constrainedNeighbours.push_back(edge.VertexA == pointId ? edge.VertexB : edge.VertexA);
+		}
+		// The constraints are inserted again once the vertex is moved, none of them may cross another constraint.
+		if (!constrainedNeighbours.empty()) {
+			for (const auto &[edgeId, edge]: m_Edges) {
+				if (!edge.Constrained || edge.VertexA == pointId || edge.VertexB == pointId) continue;
+				const Vector2 c = m_Vertices[edge.VertexA].Position;
+				const Vector2 d = m_Vertices[edge.VertexB].Position;
+				for (const uint32_t neighbourId: constrainedNeighbours) {
+					const Vector2 neighbour = m_Vertices[neighbourId].Position;
+					if (Math::Orient2D(position, neighbour, c) * Math::Orient2D(position, neighbour, d) < 0 &&
+					    Math::Orient2D(c, d, position) * Math::Orient2D(c, d, neighbour) < 0) {
+						return false;
 					}
 				}
 			}
+		}
 
-			assert(edgeList2.size() == 3);
-			auto it = edgeList2.cbegin();
-			const uint32_t edge1Id = *(it++);
-			const uint32_t edge2Id =  *(it++);
-			const uint32_t edge3Id =  *(it++);
+		const T height = m_Vertices[pointId].Height;
+		RemoveDelaunayVertex(pointId);
+		m_Vertices.insert({pointId, {position, height}});
+		std::optional<uint32_t> borderEdge{std::nullopt};
+		const std::optional<uint32_t> containingTriangle = LocateTriangle(position, std::nullopt, borderEdge);
+		ConnectDelaunayVertex(pointId, containingTriangle, borderEdge);
+		for (const uint32_t neighbourId: constrainedNeighbours) InsertConstraint(pointId, neighbourId);
+		return true;
+	}
 
-			Edge& edge1 = m_Edges.at(edge1Id);
-			Edge& edge2 = m_Edges.at(edge2Id);
-			Edge& edge3 = m_Edges.at(edge3Id);
+	inline void MeshGraph::InsertConstraint(const uint32_t vertexA, const uint32_t vertexB) {
+		if (!m_Vertices.contains(vertexA) || !m_Vertices.contains(vertexB)) throw std::out_of_range("MeshGraph::InsertConstraint: invalid vertex id");
+		if (vertexA == vertexB) throw std::invalid_argument("MeshGraph::InsertConstraint: the constraint needs two different vertices");
+		if (m_Triangles.empty() || !GetIncidentEdge(vertexA) || !GetIncidentEdge(vertexB)) {
+			throw std::runtime_error("MeshGraph::InsertConstraint: the vertices aren't part of a triangle");
+		}
+		m_HasConstraints = true;
+		for (uint32_t fromId = vertexA; fromId != vertexB;) {
+			fromId = InsertConstraintSegment(fromId, vertexB);
+		}
+	}
 
-			bool edge2IsLinkToEdge1ThroughA = edge1.VertexA == edge2.VertexA || edge1.VertexA == edge2.VertexB;
-			const uint32_t aId = edge1.VertexA;
-			const uint32_t bId = edge1.VertexB;
+	inline uint32_t MeshGraph::InsertConstraintSegment(const uint32_t fromId, const uint32_t toId) {
+		const Vector2 a = m_Vertices[fromId].Position;
+		const Vector2 b = m_Vertices[toId].Position;
+		const auto otherVertex = [this](const uint32_t edgeId, const uint32_t vertexId) {
+			const Edge &edge = m_Edges[edgeId];
+			return edge.VertexA == vertexId ? edge.VertexB : edge.VertexA;
+		};
+		const auto edgeBetween = [this](const uint32_t triangleId, const uint32_t aId, const uint32_t bId) {
+			const Triangle &triangle = m_Triangles[triangleId];
+			for (const uint32_t edgeId: {triangle.EdgeAB, triangle.EdgeBC}) {
+				const Edge &edge = m_Edges[edgeId];
+				if ((edge.VertexA == aId || edge.VertexA == bId) && (edge.VertexB == aId || edge.VertexB == bId)) return edgeId;
+			}
+			return triangle.EdgeCA;
+		};
 
-			const uint32_t triangleId = GenerateTriangleId();
-			Triangle triangle;// = ABCIsOriented ? Triangle{edge1Id, edge2Id, edge3Id} : Triangle{edge1Id, edge3Id, edge2Id};
+		// The segment already is an edge, or goes along one up to a vertex on the segment.
+		std::vector<uint32_t> edges;
+		GetIncidentEdges(fromId, edges);
+		for (const uint32_t edgeId: edges) {
+			const uint32_t otherId = otherVertex(edgeId, fromId);
+			const Vector2 &c = m_Vertices[otherId].Position;
+			if (otherId == toId || (Math::Orient2D(a, b, c) == 0 && Math::Dot(c - a, b - a) > 0)) {
+				m_Edges[edgeId].Constrained = true;
+				return otherId;
+			}
+		}
 
-			{
-				const bool edge2ConnectedToEdge1ThroughB = edge1.VertexB == edge2.VertexA || edge1.VertexB == edge2.VertexB;
-				const uint32_t cId = edge2.VertexA == edge1.VertexA || edge2.VertexA == edge1.VertexB ? edge2.VertexB : edge2.VertexA;
-				const bool ABCOriented = Math::IsTriangleOriented(m_Vertices.at(edge1.VertexA).Position,m_Vertices.at(edge1.VertexB).Position,m_Vertices.at(cId).Position);
+		// The first triangle crossed is the one around the vertex with its two other vertices on each side of the segment.
+		std::optional<uint32_t> firstTriangle{std::nullopt};
+		std::vector<uint32_t> leftChain;
+		std::vector<uint32_t> rightChain;
+		for (size_t i = 0; i < edges.size() && !firstTriangle; ++i) {
+			const Edge &edge = m_Edges[edges[i]];
+			const std::optional<uint32_t> &triangleId = edge.VertexA == fromId ? edge.TriangleLeft : edge.TriangleRight;
+			if (!triangleId) continue;
+			const uint32_t rightId = otherVertex(edges[i], fromId);
+			const uint32_t leftId = otherVertex(edges[(i + 1) % edges.size()], fromId);
+			if (Math::Orient2D(a, b, m_Vertices[rightId].Position) >= 0 || Math::Orient2D(a, b, m_Vertices[leftId].Position) <= 0) continue;
+			firstTriangle = triangleId;
+			leftChain.push_back(leftId);
+			rightChain.push_back(rightId);
+		}
+		if (!firstTriangle) throw std::runtime_error("MeshGraph::InsertConstraint: the segment leaves the mesh");
+
+		// Walk along the segment, the vertices on each side of it bound the two pseudo-polygons.
+		std::vector<uint32_t> corridor{firstTriangle.value()};
+		std::vector<uint32_t> crossedEdges;
+		uint32_t crossedId = edgeBetween(firstTriangle.value(), leftChain.back(), rightChain.back());
+		uint32_t endId;
+		while (true) {
+			const Edge &crossed = m_Edges[crossedId];
+			if (crossed.Constrained) throw std::runtime_error("MeshGraph::InsertConstraint: the segment crosses another constraint");
+			const std::optional<uint32_t> nextId = crossed.TriangleLeft == corridor.back() ? crossed.TriangleRight : crossed.TriangleLeft;
+			if (!nextId) throw std::runtime_error("MeshGraph::InsertConstraint: the segment leaves the mesh");
+			crossedEdges.push_back(crossedId);
+			corridor.push_back(nextId.value());
+
+			const auto [aId, bId, cId] = GetTriangleVertices(nextId.value());
+			const uint32_t vertexId = aId != crossed.VertexA && aId != crossed.VertexB ? aId : bId != crossed.VertexA && bId != crossed.VertexB ? bId : cId;
+			const double orientation = Math::Orient2D(a, b, m_Vertices[vertexId].Position);
+			if (vertexId == toId || orientation == 0) {
+				endId = vertexId;
+				break;
+			}
+			if (orientation > 0) {
+				crossedId = edgeBetween(nextId.value(), rightChain.back(), vertexId);
+				leftChain.push_back(vertexId);
+			} else {
+				crossedId = edgeBetween(nextId.value(), leftChain.back(), vertexId);
+				rightChain.push_back(vertexId);
+			}
+		}
 
-				if (ABCOriented) {
-					if (edge2ConnectedToEdge1ThroughB) {
-						triangle = Triangle{edge1Id, edge2Id, edge3Id};
-					} else {
-						triangle = Triangle{edge1Id, edge3Id, edge2Id};
+		// Free the ids first so the triangulation of the pseudo-polygons takes them back.
+		std::unordered_map<ReversiblePair<uint32_t, uint32_t>, uint32_t, ReversiblePairHash> edgeIds;
+		for (const uint32_t triangleId: corridor) {
+			const Triangle &triangle = m_Triangles[triangleId];
+			for (const uint32_t edgeId: {triangle.EdgeAB, triangle.EdgeBC, triangle.EdgeCA}) {
+				if (std::find(crossedEdges.begin(), crossedEdges.end(), edgeId) != crossedEdges.end()) continue;
+				Edge &edge = m_Edges[edgeId];
+				if (edge.TriangleLeft == triangleId) edge.TriangleLeft = std::nullopt;
+				else edge.TriangleRight = std::nullopt;
+				edgeIds.emplace(ReversiblePair{edge.VertexA, edge.VertexB}, edgeId);
+			}
+		}
+		for (const uint32_t triangleId: corridor) EraseTriangle(triangleId);
+		for (const uint32_t edgeId: crossedEdges) EraseEdge(edgeId);
+
+		const uint32_t constraintId = GenerateEdgeId();
+		m_Edges[constraintId] = {fromId, endId};
+		m_Edges[constraintId].Constrained = true;
+		edgeIds.emplace(ReversiblePair{fromId, endId}, constraintId);
+		TriangulatePseudoPolygon(fromId, endId, leftChain, edgeIds);
+		TriangulatePseudoPolygon(fromId, endId, rightChain, edgeIds);
+		return endId;
+	}
+
+	inline uint32_t MeshGraph::RefineDelaunay(const T minAngle, const T maxArea, const uint32_t maxPoints) {
+		if (minAngle < 0 || minAngle >= pi / 3) throw std::invalid_argument("MeshGraph::RefineDelaunay: the minimum angle must be in [0, 60°)");
+		if (maxArea <= 0) throw std::invalid_argument("MeshGraph::RefineDelaunay: the maximum area must be positive");
+		if (m_Triangles.empty()) return 0;
+
+		// The quality is the ratio to the closest bound, a triangle is bad below 1.
+		// The sine of the smallest angle is its shortest edge over the diameter of its circumcircle.
+		// A smallest angle between two segments comes from the input, splitting it would never end.
+		// A few hundred ulps from each other, the rounded circumcenters and middles drift too far to go on.
+		const T sinMinAngle = std::sin(minAngle);
+		T scale = 0;
+		for (const auto &[vertexId, vertex]: m_Vertices) scale = std::max({scale, std::abs(vertex.Position.x), std::abs(vertex.Position.y)});
+		const T minLength = scale * std::numeric_limits<T>::epsilon() * 256;
+		const T minLength2 = minLength * minLength;
+		const auto length2 = [this](const uint32_t edgeId) {
+			return Math::Distance2(m_Vertices[m_Edges[edgeId].VertexA].Position, m_Vertices[m_Edges[edgeId].VertexB].Position);
+		};
+		const auto isBetweenSegments = [this, &length2](const uint32_t triangleId) {
+			const Triangle &triangle = m_Triangles[triangleId];
+			std::array<uint32_t, 3> edges{triangle.EdgeAB, triangle.EdgeBC, triangle.EdgeCA};
+			std::sort(edges.begin(), edges.end(), [&length2](const uint32_t a, const uint32_t b) { return length2(a) < length2(b); });
+			return IsSegment(edges[1]) && IsSegment(edges[2]);
+		};
+		const auto getQuality = [this, sinMinAngle, minLength2, maxArea, &isBetweenSegments](const uint32_t triangleId) {
+			const auto [aId, bId, cId] = GetTriangleVertices(triangleId);
+			const Vector2 &a = m_Vertices[aId].Position;
+			const Vector2 &b = m_Vertices[bId].Position;
+			const Vector2 &c = m_Vertices[cId].Position;
+			const T shortest2 = std::min({Math::Distance2(a, b), Math::Distance2(b, c), Math::Distance2(c, a)});
+			const T area = static_cast<T>(std::abs(Math::Orient2D(a, b, c)) / 2);
+			T quality = maxArea / area;
+			if (sinMinAngle > 0 && shortest2 >= minLength2 && !isBetweenSegments(triangleId)) quality = std::min(quality, std::sqrt(shortest2 / (4 * GetCircumcircle(triangleId).SquaredRadius)) / sinMinAngle);
+			return quality;
+		};
+		const auto getSortedVertices = [this](const uint32_t triangleId) {
+			const auto [aId, bId, cId] = GetTriangleVertices(triangleId);
+			std::array<uint32_t, 3> vertices{aId, bId, cId};
+			std::sort(vertices.begin(), vertices.end());
+			return vertices;
+		};
+
+		// The ids of the triangles are reused, an entry is only valid while its triangle keeps the same vertices.
+		using BadTriangle = std::tuple<T, uint32_t, std::array<uint32_t, 3>>;
+		std::priority_queue<BadTriangle, std::vector<BadTriangle>, std::greater<>> badTriangles;
+		std::vector<uint32_t> encroachedSegments;
+		const auto pushIfBad = [&](const uint32_t triangleId) {
+			const T quality = getQuality(triangleId);
+			if (quality < 1) badTriangles.emplace(quality, triangleId, getSortedVertices(triangleId));
+		};
+		for (const auto &[edgeId, edge]: m_Edges) {
+			if (IsSegment(edgeId) && IsSegmentEncroached(edgeId)) encroachedSegments.push_back(edgeId);
+		}
+		for (const auto &[triangleId, triangle]: m_Triangles) pushIfBad(triangleId);
+
+		// Only the star of a new vertex changed, with the segments around it.
+		std::vector<uint32_t> starEdges;
+		std::vector<uint32_t> starTriangles;
+		const auto onVertexInserted = [&](const uint32_t vertexId) {
+			GetStar(vertexId, starEdges, starTriangles);
+			for (const uint32_t triangleId: starTriangles) {
+				pushIfBad(triangleId);
+				const Triangle &triangle = m_Triangles[triangleId];
+				for (const uint32_t edgeId: {triangle.EdgeAB, triangle.EdgeBC, triangle.EdgeCA}) {
+					if (IsSegment(edgeId) && IsSegmentEncroached(edgeId)) encroachedSegments.push_back(edgeId);
+				}
+			}
+		};
+
+		uint32_t inserted = 0;
+		const auto splitSegment = [&](const uint32_t edgeId) {
+			if (length2(edgeId) < minLength2) return;
+			const std::optional<uint32_t> vertexId = SplitSegment(edgeId);
+			if (!vertexId) return;
+			onVertexInserted(vertexId.value());
+			++inserted;
+		};
+		std::vector<uint32_t> segments;
+		std::vector<std::pair<uint32_t, uint32_t>> segmentVertices;
+		while (inserted < maxPoints) {
+			// The segments first, so the circumcenters of the bad triangles are inside the mesh.
+			if (!encroachedSegments.empty()) {
+				const uint32_t edgeId = encroachedSegments.back();
+				encroachedSegments.pop_back();
+				if (!m_Edges.contains(edgeId) || !IsSegment(edgeId) || !IsSegmentEncroached(edgeId)) continue;
+				splitSegment(edgeId);
+				continue;
+			}
+			if (badTriangles.empty()) break;
+
+			const auto [quality, triangleId, vertices] = badTriangles.top();
+			badTriangles.pop();
+			if (!m_Triangles.contains(triangleId) || getSortedVertices(triangleId) != vertices) continue;
+
+			const Vector2 center = GetCircumcircle(triangleId).Center;
+			std::optional<uint32_t> borderEdge{std::nullopt};
+			const std::optional<uint32_t> containingTriangle = LocateTriangle(center, triangleId, borderEdge);
+			if (!containingTriangle) {
+				// Only the rounding of a flat triangle's circumcenter can leave the mesh, the border is split under it.
+				segments.clear();
+				if (borderEdge) segments.push_back(borderEdge.value());
+			} else {
+				GetEncroachedSegments(center, containingTriangle.value(), segments);
+			}
+			if (!segments.empty()) {
+				// The segments the circumcenter sees are split right away, the opposite vertices may not see them.
+				// The ids of the split segments are reused, the others are found back by their vertices.
+				const uint32_t insertedBefore = inserted;
+				segmentVertices.clear();
+				for (const uint32_t edgeId: segments) segmentVertices.emplace_back(m_Edges[edgeId].VertexA, m_Edges[edgeId].VertexB);
+				for (size_t i = 0; i < segments.size() && inserted < maxPoints; ++i) {
+					const uint32_t edgeId = segments[i];
+					if (!m_Edges.contains(edgeId) || !IsSegment(edgeId)) continue;
+					if (m_Edges[edgeId].VertexA != segmentVertices[i].first || m_Edges[edgeId].VertexB != segmentVertices[i].second) continue;
+					splitSegment(edgeId);
+				}
+				if (inserted != insertedBefore && m_Triangles.contains(triangleId) && getSortedVertices(triangleId) == vertices) pushIfBad(triangleId);
+				continue;
+			}
+			if (!containingTriangle) continue;
+
+			const auto [aId, bId, cId] = GetTriangleVertices(containingTriangle.value());
+			if (m_Vertices[aId].Position == center || m_Vertices[bId].Position == center || m_Vertices[cId].Position == center) continue;
+			const uint32_t vertexId = GenerateVertexId();
+			m_Vertices[vertexId] = {center, InterpolateHeight(containingTriangle.value(), center)};
+			ConnectDelaunayVertex(vertexId, containingTriangle, std::nullopt);
+			onVertexInserted(vertexId);
+			++inserted;
+		}
+		return inserted;
+	}
+
+	inline MeshGraph MeshGraph::BuildTerrain(const std::span<const T> heights, const uint32_t width, const uint32_t depth, const T tolerance, const Vector2 origin, const Vector2 spacing, const uint32_t maxPoints) {
+		if (width < 2 || depth < 2) throw std::invalid_argument("MeshGraph::BuildTerrain: the grid must have at least 2x2 samples");
+		if (heights.size() != static_cast<size_t>(width) * depth) throw std::invalid_argument("MeshGraph::BuildTerrain: the number of heights doesn't match the size of the grid");
+
+		MeshGraph graph;
+		// The triangles are scanned on the grid, where the point in triangle tests are exact.
+		std::vector<uint32_t> vertexSamples;
+		std::vector<bool> isInserted(heights.size(), false);
+		const auto getSortedVertices = [&graph](const uint32_t triangleId) {
+			const auto [aId, bId, cId] = graph.GetTriangleVertices(triangleId);
+			std::array<uint32_t, 3> vertices{aId, bId, cId};
+			std::sort(vertices.begin(), vertices.end());
+			return vertices;
+		};
+
+		// The ids of the triangles are reused, an entry is only valid while its triangle keeps the same vertices.
+		using Candidate = std::tuple<T, uint32_t, std::array<uint32_t, 3>, uint32_t>;
+		std::priority_queue<Candidate> candidates;
+		const auto scanTriangle = [&](const uint32_t triangleId) {
+			const auto [aId, bId, cId] = graph.GetTriangleVertices(triangleId);
+			std::array<uint32_t, 3> samples{vertexSamples[aId], vertexSamples[bId], vertexSamples[cId]};
+			std::array<int64_t, 3> xs, ys;
+			for (uint32_t i = 0; i < 3; ++i) {
+				xs[i] = samples[i] % width;
+				ys[i] = samples[i] / width;
+			}
+			int64_t area = (xs[1] - xs[0]) * (ys[2] - ys[0]) - (ys[1] - ys[0]) * (xs[2] - xs[0]);
+			if (area == 0) return;
+			if (area < 0) {
+				std::swap(samples[1], samples[2]);
+				std::swap(xs[1], xs[2]);
+				std::swap(ys[1], ys[2]);
+				area = -area;
+			}
+
+			// The weight of a vertex is the area of the triangle made by the sample & the edge in front of the vertex,
+			// it grows by a constant along a row.
+			std::array<int64_t, 3> stepX, stepY, origins;
+			for (uint32_t i = 0; i < 3; ++i) {
+				const uint32_t j = (i + 1) % 3, k = (i + 2) % 3;
+				stepX[i] = ys[j] - ys[k];
+				stepY[i] = xs[k] - xs[j];
+				origins[i] = xs[j] * ys[k] - ys[j] * xs[k];
+			}
+			const auto [minX, maxX] = std::minmax({xs[0], xs[1], xs[2]});
+			const auto [minY, maxY] = std::minmax({ys[0], ys[1], ys[2]});
+			const double scale = 1.0 / static_cast<double>(area);
+			T worstError = -1;
+			uint32_t worstSample = 0;
+			for (int64_t y = minY; y <= maxY; ++y) {
+				std::array<int64_t, 3> weights;
+				for (uint32_t i = 0; i < 3; ++i) weights[i] = origins[i] + stepX[i] * minX + stepY[i] * y;
+				bool wasInside = false;
+				for (int64_t x = minX; x <= maxX; ++x, weights[0] += stepX[0], weights[1] += stepX[1], weights[2] += stepX[2]) {
+					if (weights[0] < 0 || weights[1] < 0 || weights[2] < 0) {
+						// The triangle is convex, the row is over once left.
+						if (wasInside) break;
+						continue;
 					}
-				} else {
-					if (edge2ConnectedToEdge1ThroughB) {
-						triangle = Triangle{edge1Id, edge3Id, edge2Id};
-					} else {
-						triangle = Triangle{edge1Id, edge2Id, edge3Id};
+					wasInside = true;
+					const uint32_t sample = static_cast<uint32_t>(y * width + x);
+					if (isInserted[sample]) continue;
+					const double surface = (static_cast<double>(weights[0]) * heights[samples[0]] + static_cast<double>(weights[1]) * heights[samples[1]] +
+					                        static_cast<double>(weights[2]) * heights[samples[2]]) * scale;
+					const T error = static_cast<T>(std::abs(heights[sample] - surface));
+					if (error > worstError) {
+						worstError = error;
+						worstSample = sample;
 					}
 				}
+			}
+			if (worstError >= 0) candidates.emplace(worstError, triangleId, getSortedVertices(triangleId), worstSample);
+		};
+		const auto insertSample = [&](const uint32_t sample, const std::optional<uint32_t> triangleHint) {
+			const Vector2 point = origin + spacing * Vector2{static_cast<T>(sample % width), static_cast<T>(sample / width)};
+			std::optional<uint32_t> borderEdge{std::nullopt};
+			const std::optional<uint32_t> containingTriangle = graph.LocateTriangle(point, triangleHint, borderEdge);
+			const uint32_t vertexId = graph.GenerateVertexId();
+			graph.m_Vertices[vertexId] = {point, heights[sample]};
+			if (vertexSamples.size() <= vertexId) vertexSamples.resize(vertexId + 1);
+			vertexSamples[vertexId] = sample;
+			isInserted[sample] = true;
+			graph.ConnectDelaunayVertex(vertexId, containingTriangle, borderEdge);
+			return vertexId;
+		};
+
+		for (const uint32_t corner: {0u, width - 1, width * depth - 1, width * (depth - 1)}) insertSample(corner, std::nullopt);
+		for (const auto &[triangleId, triangle]: graph.m_Triangles) scanTriangle(triangleId);
+
+		std::vector<uint32_t> starEdges;
+		std::vector<uint32_t> starTriangles;
+		while (!candidates.empty() && graph.m_Vertices.size() < maxPoints) {
+			const auto [error, triangleId, vertices, sample] = candidates.top();
+			if (error <= tolerance) break;
+			candidates.pop();
+			if (!graph.m_Triangles.contains(triangleId) || getSortedVertices(triangleId) != vertices) continue;
+
+			// Only the star of the new vertex changed.
+			const uint32_t vertexId = insertSample(sample, triangleId);
+			graph.GetStar(vertexId, starEdges, starTriangles);
+			for (const uint32_t starTriangle: starTriangles) scanTriangle(starTriangle);
+		}
+		return graph;
+	}
+
+	inline bool MeshGraph::IsSegment(const uint32_t edgeId) const {
+		const Edge &edge = m_Edges[edgeId];
+		return edge.Constrained || edge.TriangleLeft.has_value() != edge.TriangleRight.has_value();
+	}
 
-				if (ABCOriented) {
-					edge1.TriangleLeft = triangleId;
+	inline bool MeshGraph::IsSegmentEncroached(const uint32_t edgeId) const {
+		const Edge &edge = m_Edges[edgeId];
+		const Vector2 &a = m_Vertices[edge.VertexA].Position;
+		const Vector2 &b = m_Vertices[edge.VertexB].Position;
+		// In a (constrained) Delaunay triangulation, a vertex seeing the segment inside its diametral circle implies one of the opposite vertices is.
+		for (const std::optional<uint32_t> &triangleId: {edge.TriangleLeft, edge.TriangleRight}) {
+			if (!triangleId) continue;
+			const auto [aId, bId, cId] = GetTriangleVertices(triangleId.value());
+			const uint32_t oppositeId = aId != edge.VertexA && aId != edge.VertexB ? aId : bId != edge.VertexA && bId != edge.VertexB ? bId : cId;
+			const Vector2 &p = m_Vertices[oppositeId].Position;
+			if (Math::Dot(a - p, b - p) < 0) return true;
+		}
+		return false;
+	}
+
+	inline std::optional<uint32_t> MeshGraph::SplitSegment(const uint32_t edgeId) {
+		const Edge segment = m_Edges[edgeId];
+		const Vector2 middle = (m_Vertices[segment.VertexA].Position + m_Vertices[segment.VertexB].Position) / static_cast<T>(2);
+
+		// The rounded middle may not be exactly on the segment, it's only connected if it still sees the edges around it.
+		for (const std::optional<uint32_t> &triangleId: {segment.TriangleLeft, segment.TriangleRight}) {
+			if (!triangleId) continue;
+			const Triangle &triangle = m_Triangles[triangleId.value()];
+			for (const uint32_t otherId: {triangle.EdgeAB, triangle.EdgeBC, triangle.EdgeCA}) {
+				if (otherId == edgeId) continue;
+				const Edge &other = m_Edges[otherId];
+				const Vector2 &a = m_Vertices[other.VertexA].Position;
+				const Vector2 &b = m_Vertices[other.VertexB].Position;
+				if (!(other.TriangleLeft == triangleId ? Math::IsTriangleOriented(a, b, middle) : Math::IsTriangleOriented(b, a, middle))) return std::nullopt;
+			}
+		}
+
+		const uint32_t vertexId = GenerateVertexId();
+		m_Vertices[vertexId] = {middle, (m_Vertices[segment.VertexA].Height + m_Vertices[segment.VertexB].Height) / static_cast<T>(2)};
+		std::vector<std::tuple<uint32_t, uint32_t, uint32_t>> border;
+		std::queue<uint32_t> edgeToCheck;
+		for (const std::optional<uint32_t> &triangleId: {segment.TriangleLeft, segment.TriangleRight}) {
+			if (!triangleId) continue;
+			const Triangle triangle = m_Triangles[triangleId.value()];
+			for (const uint32_t otherId: {triangle.EdgeAB, triangle.EdgeBC, triangle.EdgeCA}) {
+				if (otherId == edgeId) continue;
+				Edge &other = m_Edges[otherId];
+				if (other.TriangleLeft == triangleId) {
+					border.emplace_back(otherId, other.VertexA, other.VertexB);
+					other.TriangleLeft = std::nullopt;
 				} else {
-					edge1.TriangleRight = triangleId;
+					border.emplace_back(otherId, other.VertexB, other.VertexA);
+					other.TriangleRight = std::nullopt;
 				}
+				edgeToCheck.push(otherId);
 			}
+			EraseTriangle(triangleId.value());
+		}
+		EraseEdge(edgeId);
+		FanToVertex(vertexId, border);
+
+		if (segment.Constrained) {
+			std::vector<uint32_t> edges;
+			GetIncidentEdges(vertexId, edges);
+			for (const uint32_t halfId: edges) {
+				Edge &half = m_Edges[halfId];
+				if (half.VertexA == segment.VertexA || half.VertexB == segment.VertexA || half.VertexA == segment.VertexB || half.VertexB == segment.VertexB) half.Constrained = true;
+			}
+		}
+		LegalizeEdges(edgeToCheck);
+		return vertexId;
+	}
 
-			{
-				const uint32_t cId = edge3.VertexA == edge2.VertexA || edge3.VertexA == edge2.VertexB ? edge3.VertexB : edge3.VertexA;
-				const bool ABCOriented = Math::IsTriangleOriented(m_Vertices.at(edge2.VertexA).Position,m_Vertices.at(edge2.VertexB).Position,m_Vertices.at(cId).Position);
-
-				if (ABCOriented) {
-					edge2.TriangleLeft = triangleId;
-				} else {
-					edge2.TriangleRight = triangleId;
+	inline void MeshGraph::GetEncroachedSegments(const Vector2 point, const uint32_t containingTriangle, std::vector<uint32_t> &segments) const {
+		segments.clear();
+		// The triangles the point would replace, the segments it could see are around them.
+		std::vector<uint32_t> cavity{containingTriangle};
+		for (size_t i = 0; i < cavity.size(); ++i) {
+			const Triangle &triangle = m_Triangles[cavity[i]];
+			for (const uint32_t edgeId: {triangle.EdgeAB, triangle.EdgeBC, triangle.EdgeCA}) {
+				const Edge &edge = m_Edges[edgeId];
+				if (IsSegment(edgeId)) {
+					const Vector2 &a = m_Vertices[edge.VertexA].Position;
+					const Vector2 &b = m_Vertices[edge.VertexB].Position;
+					if (Math::Dot(a - point, b - point) < 0 && std::find(segments.begin(), segments.end(), edgeId) == segments.end()) segments.push_back(edgeId);
+					if (edge.Constrained) continue;
 				}
+				const std::optional<uint32_t> neighbour = edge.TriangleLeft == cavity[i] ? edge.TriangleRight : edge.TriangleLeft;
+				if (!neighbour || std::find(cavity.begin(), cavity.end(), neighbour.value()) != cavity.end()) continue;
+				const auto [aId, bId, cId] = GetTriangleVertices(neighbour.value());
+				if (Math::IsPointInsideCircumcircle(m_Vertices[aId].Position, m_Vertices[bId].Position, m_Vertices[cId].Position, point)) cavity.push_back(neighbour.value());
 			}
+		}
+	}
 
-			{
-				const uint32_t cId = edge1.VertexA == edge3.VertexA || edge1.VertexA == edge3.VertexB ? edge1.VertexB : edge1.VertexA;
-				const bool ABCOriented = Math::IsTriangleOriented(m_Vertices.at(edge3.VertexA).Position,m_Vertices.at(edge3.VertexB).Position,m_Vertices.at(cId).Position);
+	inline void MeshGraph::TriangulatePseudoPolygon(const uint32_t aId, const uint32_t bId, const std::vector<uint32_t> &chain, std::unordered_map<ReversiblePair<uint32_t, uint32_t>, uint32_t, ReversiblePairHash> &edgeIds) {
+		const auto getEdge = [this, &edgeIds](const uint32_t fromId, const uint32_t toId) {
+			const auto [it, inserted] = edgeIds.try_emplace(ReversiblePair{fromId, toId}, 0);
+			if (inserted) {
+				it->second = GenerateEdgeId();
+				m_Edges[it->second] = {fromId, toId};
+			}
+			return it->second;
+		};
 
-				if (ABCOriented) {
-					edge3.TriangleLeft = triangleId;
-				} else {
-					edge3.TriangleRight = triangleId;
+		// Each part of the chain, between the vertices of its base, is split at the vertex whose circle through the base is empty.
+		// The circles through the base are nested on its side, so a single pass finds the vertex.
+		std::vector<std::tuple<uint32_t, uint32_t, size_t, size_t>> parts{{aId, bId, 0, chain.size()}};
+		while (!parts.empty()) {
+			const auto [uId, wId, begin, end] = parts.back();
+			parts.pop_back();
+			if (begin == end) continue;
+
+			const Vector2 &u = m_Vertices[uId].Position;
+			const Vector2 &w = m_Vertices[wId].Position;
+			size_t split = begin;
+			for (size_t i = begin + 1; i < end; ++i) {
+				if (Math::IsPointInsideCircumcircle(u, w, m_Vertices[chain[split]].Position, m_Vertices[chain[i]].Position)) split = i;
+			}
+			const uint32_t cId = chain[split];
+			parts.emplace_back(uId, cId, begin, split);
+			parts.emplace_back(cId, wId, split + 1, end);
+
+			if (Math::Orient2D(u, w, m_Vertices[cId].Position) > 0) {
+				AddOrientedTriangle(uId, wId, cId, getEdge(uId, wId), getEdge(wId, cId), getEdge(cId, uId));
+			} else {
+				AddOrientedTriangle(wId, uId, cId, getEdge(wId, uId), getEdge(uId, cId), getEdge(cId, wId));
+			}
+		}
+	}
+
+	inline bool MeshGraph::CanMoveInStar(const uint32_t vertexId, const Vector2 position, const std::vector<uint32_t> &edges, const std::vector<uint32_t> &triangles) const {
+		// The triangles of the star keep their orientation: the position is strictly on the left of each edge of the link.
+		SegmentBuffer link;
+		link.Reserve(triangles.size());
+		for (const uint32_t triangleId: triangles) {
+			const Triangle &triangle = m_Triangles[triangleId];
+			for (const uint32_t edgeId: {triangle.EdgeAB, triangle.EdgeBC, triangle.EdgeCA}) {
+				const Edge &edge = m_Edges[edgeId];
+				if (edge.VertexA == vertexId || edge.VertexB == vertexId) continue;
+				const bool isLeft = edge.TriangleLeft == triangleId;
+				link.Add(m_Vertices[isLeft ? edge.VertexA : edge.VertexB].Position, m_Vertices[isLeft ? edge.VertexB : edge.VertexA].Position);
+			}
+		}
+		std::vector<int8_t> sides(link.Size());
+		OrientBatch(position, link, sides.data());
+		if (std::any_of(sides.begin(), sides.end(), [](const int8_t side) { return side <= 0; })) return false;
+		if (edges.size() == triangles.size()) return true;
+
+		// On the hull, the border must stay convex at the vertex and at its two neighbours on the ring.
+		const Edge &next = m_Edges[edges.front()];
+		const Edge &previous = m_Edges[edges.back()];
+		const uint32_t nextId = next.VertexA == vertexId ? next.VertexB : next.VertexA;
+		const uint32_t previousId = previous.VertexA == vertexId ? previous.VertexB : previous.VertexA;
+		const Edge &afterNext = m_Edges[GetNextHullEdge(edges.front())];
+		const Edge &beforePrevious = m_Edges[GetPreviousHullEdge(edges.back())];
+		const uint32_t afterNextId = afterNext.VertexA == nextId ? afterNext.VertexB : afterNext.VertexA;
+		const uint32_t beforePreviousId = beforePrevious.VertexA == previousId ? beforePrevious.VertexB : beforePrevious.VertexA;
+		return Math::Orient2D(m_Vertices[beforePreviousId].Position, m_Vertices[previousId].Position, position) >= 0 &&
+		       Math::Orient2D(m_Vertices[previousId].Position, position, m_Vertices[nextId].Position) >= 0 &&
+		       Math::Orient2D(position, m_Vertices[nextId].Position, m_Vertices[afterNextId].Position) >= 0;
+	}
+
+	inline void MeshGraph::GetStar(const uint32_t vertexId, std::vector<uint32_t> &edges, std::vector<uint32_t> &triangles) const {
+		GetIncidentEdges(vertexId, edges);
+		triangles.clear();
+		// Each triangle of the star is on the left of one of its edges going out of the vertex.
+		for (const uint32_t edgeId: edges) {
+			const Edge &edge = m_Edges[edgeId];
+			const std::optional<uint32_t> &triangleId = edge.VertexA == vertexId ? edge.TriangleLeft : edge.TriangleRight;
+			if (triangleId) triangles.push_back(triangleId.value());
+		}
+	}
+
+	inline void MeshGraph::FillStarPolygon(const Vector2 removedPosition, const std::vector<uint32_t> &polygon, const std::vector<uint32_t> &polygonEdges) {
+		// Devillers' ear queue: the ear whose circumcircle has the largest power with respect to the removed point is Delaunay.
+		// Lifted on the paraboloid, its plane is the lowest above the removed point, so no vertex can be under it.
+		const uint32_t count = static_cast<uint32_t>(polygon.size());
+		std::vector<uint32_t> previous(count);
+		std::vector<uint32_t> next(count);
+		std::vector<uint32_t> edgeToNext(polygonEdges);
+		std::vector<uint32_t> stamps(count, 0);
+		for (uint32_t i = 0; i < count; ++i) {
+			previous[i] = (i + count - 1) % count;
+			next[i] = (i + 1) % count;
+		}
+
+		// Only a reflex vertex of the polygon can be inside one of its ears, & cutting ears never makes a vertex reflex.
+		std::vector<uint32_t> reflex;
+		if (m_HasConstraints) {
+			for (uint32_t i = 0; i < count; ++i) {
+				if (Math::Orient2D(m_Vertices[polygon[previous[i]]].Position, m_Vertices[polygon[i]].Position, m_Vertices[polygon[next[i]]].Position) <= 0) reflex.push_back(i);
+			}
+		}
+
+		// The power of the removed point is -InCircle / Orient2D, the queue gives the largest first.
+		using Ear = std::tuple<double, uint32_t, uint32_t>;
+		std::priority_queue<Ear> ears;
+		const auto pushEar = [&](const uint32_t i) {
+			++stamps[i];
+			const Vector2 &a = m_Vertices[polygon[previous[i]]].Position;
+			const Vector2 &b = m_Vertices[polygon[i]].Position;
+			const Vector2 &c = m_Vertices[polygon[next[i]]].Position;
+			const double orientation = Math::Orient2D(a, b, c);
+			if (orientation <= 0) return;
+			// Next to a constraint the star isn't Delaunay, the ear with the largest power can contain another vertex.
+			// Checking the reflex vertices still in the polygon is enough, in O(r) per ear instead of O(k).
+			if (m_HasConstraints) {
+				for (const uint32_t j: reflex) {
+					if (j == previous[i] || j == i || j == next[i] || next[previous[j]] != j) continue;
+					const Vector2 &p = m_Vertices[polygon[j]].Position;
+					if (Math::Orient2D(a, b, p) >= 0 && Math::Orient2D(b, c, p) >= 0 && Math::Orient2D(c, a, p) >= 0) return;
 				}
 			}
+			ears.emplace(-Math::InCircle(a, b, c, removedPosition) / orientation, stamps[i], i);
+		};
+		for (uint32_t i = 0; i < count; ++i) pushEar(i);
 
-			m_Triangles[triangleId] = triangle;
+		std::queue<uint32_t> edgeToCheck;
+		for (const uint32_t edgeId: polygonEdges) edgeToCheck.push(edgeId);
+
+		uint32_t remaining = count;
+		while (remaining > 3) {
+			// The ears rejected for a vertex cut out since then are only tried again when no other ear is left.
+			if (ears.empty()) {
+				for (uint32_t i = 0; i < count; ++i) {
+					if (next[previous[i]] == i) pushEar(i);
+				}
+				if (ears.empty()) break;
+			}
+			const auto [power, stamp, i] = ears.top();
+			ears.pop();
+			if (stamp != stamps[i]) continue;
+
+			const uint32_t before = previous[i];
+			const uint32_t after = next[i];
+			const uint32_t aId = polygon[before];
+			const uint32_t bId = polygon[i];
+			const uint32_t cId = polygon[after];
+			const uint32_t acId = GenerateEdgeId();
+			m_Edges[acId] = {aId, cId};
+			AddOrientedTriangle(aId, bId, cId, edgeToNext[before], edgeToNext[i], acId);
+			edgeToCheck.push(acId);
+
+			// The vertex is cut out of the polygon, the ears of its neighbours change.
+			++stamps[i];
+			next[before] = after;
+			previous[after] = before;
+			edgeToNext[before] = acId;
+			--remaining;
+			pushEar(before);
+			pushEar(after);
+		}
+
+		// A vertex cut out of the polygon isn't the next of its previous anymore.
+		assert(remaining == 3);
+		uint32_t first = 0;
+		for (uint32_t i = 0; i < count; ++i) {
+			if (next[previous[i]] == i) {
+				first = i;
+				break;
+			}
+		}
+		const uint32_t second = next[first];
+		const uint32_t third = next[second];
+		AddOrientedTriangle(polygon[first], polygon[second], polygon[third], edgeToNext[first], edgeToNext[second], edgeToNext[third]);
+
+		// Only needed when the rounding of the powers made a wrong choice between two nearly cocircular ears.
+		LegalizeEdges(edgeToCheck);
+	}
+
+	inline void MeshGraph::FillHullPocket(const std::vector<uint32_t> &chain, const std::vector<uint32_t> &chainEdges) {
+		// The chain is sorted by angle around the removed vertex, so a Graham scan fills the pockets between it and the new hull.
+		std::queue<uint32_t> edgeToCheck;
+		for (const uint32_t edgeId: chainEdges) edgeToCheck.push(edgeId);
+
+		std::vector<uint32_t> hullVertices{chain.front()};
+		std::vector<uint32_t> hullEdges;
+		for (size_t i = 1; i < chain.size(); ++i) {
+			const uint32_t cId = chain[i];
+			uint32_t bcId = chainEdges[i - 1];
+			while (hullVertices.size() >= 2) {
+				const uint32_t aId = hullVertices[hullVertices.size() - 2];
+				const uint32_t bId = hullVertices.back();
+				if (!Math::IsTriangleOriented(m_Vertices[aId].Position, m_Vertices[bId].Position, m_Vertices[cId].Position)) break;
+
+				const uint32_t acId = GenerateEdgeId();
+				m_Edges[acId] = {aId, cId};
+				AddOrientedTriangle(aId, bId, cId, hullEdges.back(), bcId, acId);
+				edgeToCheck.push(acId);
+
+				hullVertices.pop_back();
+				hullEdges.pop_back();
+				bcId = acId;
+			}
+			hullVertices.push_back(cId);
+			hullEdges.push_back(bcId);
+		}
+		LegalizeEdges(edgeToCheck);
+
+		// Without the removed vertex the remaining points can be collinear, which is stored without any edge.
+		if (m_Triangles.empty()) {
+			for (const auto &[edgeId, edge]: m_Edges) {
+				m_Vertices[edge.VertexA].IncidentEdge = std::nullopt;
+				m_Vertices[edge.VertexB].IncidentEdge = std::nullopt;
+			}
+			m_Edges.clear();
+			return;
+		}
+
+		// An edge of the chain left without a triangle is a dangling segment on the new hull.
+		std::vector<uint32_t> danglingEdges;
+		for (const uint32_t edgeId: chainEdges) {
+			if (!m_Edges.contains(edgeId)) continue;
+			const Edge &edge = m_Edges[edgeId];
+			if (edge.TriangleLeft || edge.TriangleRight) SetIncidentEdge(edgeId);
+			else danglingEdges.push_back(edgeId);
+		}
+		std::vector<uint32_t> isolatedVertices;
+		for (const uint32_t edgeId: danglingEdges) {
+			isolatedVertices.push_back(m_Edges[edgeId].VertexA);
+			isolatedVertices.push_back(m_Edges[edgeId].VertexB);
+			EraseEdge(edgeId);
+		}
+		for (const uint32_t vertexId: isolatedVertices) {
+			if (GetIncidentEdge(vertexId)) continue;
+			if (!InsertHullVertex(vertexId)) throw std::runtime_error("The vertex couldn't be connected back to the border of the mesh.");
 		}
 	}
 
@@ -882,7 +2069,7 @@ namespace TRG::Math {
 
 	inline std::tuple<bool, uint32_t, uint32_t, uint32_t, uint32_t> MeshGraph::RespectDelaunay(const uint32_t edgeId) {
 		const auto &edge = m_Edges.at(edgeId);
-		if (!edge.TriangleLeft || !edge.TriangleRight) return {true, -1, -1, -1, -1};
+		if (edge.Constrained || !edge.TriangleLeft || !edge.TriangleRight) return {true, -1, -1, -1, -1};
 
 		const uint32_t s1Id = edge.VertexB;
 		const uint32_t s2Id = edge.VertexA;
@@ -907,7 +2094,6 @@ namespace TRG::Math {
 		const Edge &a1 = m_Edges.at(a1Id);
 		const uint32_t s4Id = a1.VertexA == s1Id || a1.VertexA == s2Id ? a1.VertexB : a1.VertexA;
 		const Vertex &s4 = m_Vertices.at(s4Id);
-		const Circle t1Circle = Math::GetCircle(s1.Position, s4.Position, s2.Position);
 
 		const uint32_t t2Id = edge.TriangleRight.value();
 		const Triangle &t2 = m_Triangles.at(t2Id);
@@ -926,11 +2112,14 @@ namespace TRG::Math {
 		const Edge &a2 = m_Edges.at(a2Id);
 		const uint32_t s3Id = a2.VertexA == s1Id || a2.VertexA == s2Id ? a2.VertexB : a2.VertexA;
 		const Vertex &s3 = m_Vertices.at(s3Id);
-		const Circle t2Circle = Math::GetCircle(s1.Position, s2.Position, s3.Position);
 
 
-		const bool shouldInvert = IsPointInsideCircle(t1Circle, s3.Position) || IsPointInsideCircle(
-			                          t2Circle, s4.Position);
+		// With rounding errors, a flat quad can look non-Delaunay: only flip when the other diagonal is inside the quad.
+		const bool quadIsConvex = Math::IsTriangleOriented(s3.Position, s4.Position, s1.Position)
+			                          ? Math::IsTriangleOriented(s4.Position, s3.Position, s2.Position)
+			                          : Math::IsTriangleOriented(s3.Position, s4.Position, s2.Position) && Math::IsTriangleOriented(s4.Position, s3.Position, s1.Position);
+		// For a convex quad, s3 is inside the circle of t1 exactly when s4 is inside the circle of t2, testing one is enough.
+		const bool shouldInvert = quadIsConvex && Math::IsPointInsideCircumcircle(s1.Position, s4.Position, s2.Position, s3.Position);
 		return {!shouldInvert, a1Id, a2Id, a3Id, a4Id};
 	}
 
@@ -965,6 +2154,10 @@ namespace TRG::Math {
 				edgeToCheck.push(id);
 		}
 
+		LegalizeEdges(edgeToCheck);
+	}
+
+	inline void MeshGraph::LegalizeEdges(std::queue<uint32_t> &edgeToCheck) {
 		while (!edgeToCheck.empty()) {
 			const auto edgeId = edgeToCheck.front();
 			edgeToCheck.pop();
@@ -981,10 +2174,630 @@ namespace TRG::Math {
 		}
 	}
 
+	inline void MeshGraph::BulkAddDelaunayPoints(const std::vector<Vector2> &points) {
+		if (points.size() < 3 || !m_Vertices.empty()) {
+			for (const Vector2 &point: points) {
+				AddDelaunayPoint(point);
+			}
+			return;
+		}
+
+		Vector2 min = points.front();
+		Vector2 max = points.front();
+		for (const Vector2 &point: points) {
+			min = glm::min(min, point);
+			max = glm::max(max, point);
+		}
+		const Vector2 center = (min + max) * static_cast<T>(0.5);
+		T size = std::max(max.x - min.x, max.y - min.y);
+		if (size <= 0) size = 1;
+
+		std::vector<Vector2> uniquePoints = points;
+		std::sort(uniquePoints.begin(), uniquePoints.end(), [](const Vector2 &a, const Vector2 &b) {
+			return a.x < b.x || (a.x == b.x && a.y < b.y);
+		});
+		uniquePoints.erase(std::unique(uniquePoints.begin(), uniquePoints.end()), uniquePoints.end());
+
+		// Collinear points are stored without any edge, and would leave nothing of the triangulation once the super-triangle is removed.
+		const auto notCollinear = std::find_if(uniquePoints.begin(), uniquePoints.end(), [&uniquePoints](const Vector2 &point) {
+			return !Math::AreCollinear(uniquePoints.front(), uniquePoints.back(), point);
+		});
+		if (notCollinear == uniquePoints.end()) {
+			for (const Vector2 &point: uniquePoints) m_Vertices.emplace({point});
+			return;
+		}
+
+		m_Vertices.reserve(points.size() + 3);
+		m_Edges.reserve(3 * points.size() + 3);
+		m_Triangles.reserve(2 * points.size() + 1);
+
+		// Super-triangle, far enough to contain every point.
+		const std::array<uint32_t, 3> superIds{
+			m_Vertices.emplace({{center.x - 20 * size, center.y - size}}),
+			m_Vertices.emplace({{center.x + 20 * size, center.y - size}}),
+			m_Vertices.emplace({{center.x, center.y + 20 * size}}),
+		};
+		{
+			const uint32_t e01 = m_Edges.emplace({superIds[0], superIds[1]});
+			const uint32_t e12 = m_Edges.emplace({superIds[1], superIds[2]});
+			const uint32_t e20 = m_Edges.emplace({superIds[2], superIds[0]});
+			AddOrientedTriangle(superIds[0], superIds[1], superIds[2], e01, e12, e20);
+		}
+
+		for (const uint32_t index: BrioOrder(uniquePoints.begin(), uniquePoints.end())) {
+			const Vector2 point = uniquePoints[index];
+			// The last triangle created touch the last inserted point, which is close along the curve.
+			const std::optional<uint32_t> containingTriangle = LocateTriangle(point);
+			// The super-triangle contains every point.
+			if (!containingTriangle) throw std::runtime_error("MeshGraph::BulkAddDelaunayPoints: the point is outside of the super-triangle");
+
+			const uint32_t vertexId = GenerateVertexId();
+			m_Vertices[vertexId] = {point};
+			InsertDelaunayVertex(vertexId, containingTriangle.value());
+		}
+
+		// Removed like any other vertex, the super-triangle leaves the Delaunay triangulation of the points alone:
+		// the pockets between each removed vertex & the new hull are filled, then flipped back to Delaunay.
+		for (const uint32_t vertexId: superIds) {
+			RemoveDelaunayVertex(vertexId);
+		}
+		m_LastTriangle = std::nullopt;
+	}
+
+	inline void MeshGraph::AddTriangles(const std::vector<Vector2> &points, const std::vector<uint32_t> &vertices, const std::vector<std::array<uint32_t, 3>> &triangles) {
+		m_Vertices.reserve(vertices.size());
+		m_Edges.reserve(vertices.size() + triangles.size());
+		m_Triangles.reserve(triangles.size());
+
+		std::vector<uint32_t> pointToVertex(points.size(), FreeListVector<Vertex>::InvalidId);
+		for (const uint32_t pointId: vertices) {
+			pointToVertex[pointId] = m_Vertices.emplace({points[pointId]});
+		}
+
+		// Like the incremental insertion, collinear points are left without any edge.
+		if (triangles.empty()) return;
+
+		// Sort the sides of the triangles by vertex pair, the two sides of an inner edge end up next to each other.
+		std::vector<std::pair<uint64_t, uint32_t>> sides;
+		sides.reserve(3 * triangles.size());
+		for (uint32_t i = 0; i < triangles.size(); ++i) {
+			for (uint32_t k = 0; k < 3; ++k) {
+				const uint32_t aId = pointToVertex[triangles[i][k]];
+				const uint32_t bId = pointToVertex[triangles[i][(k + 1) % 3]];
+				sides.emplace_back((static_cast<uint64_t>(std::min(aId, bId)) << 32) | std::max(aId, bId), 3 * i + k);
+			}
+		}
+		std::sort(sides.begin(), sides.end());
+
+		std::vector<uint32_t> sideToEdge(sides.size());
+		for (size_t i = 0; i < sides.size(); ++i) {
+			if (i > 0 && sides[i].first == sides[i - 1].first) {
+				sideToEdge[sides[i].second] = sideToEdge[sides[i - 1].second];
+				continue;
+			}
+			const uint32_t side = sides[i].second;
+			const uint32_t aId = pointToVertex[triangles[side / 3][side % 3]];
+			const uint32_t bId = pointToVertex[triangles[side / 3][(side % 3 + 1) % 3]];
+			sideToEdge[side] = m_Edges.emplace({aId, bId});
+		}
+
+		for (uint32_t i = 0; i < triangles.size(); ++i) {
+			const uint32_t aId = pointToVertex[triangles[i][0]];
+			const uint32_t bId = pointToVertex[triangles[i][1]];
+			const uint32_t cId = pointToVertex[triangles[i][2]];
+			AddOrientedTriangle(aId, bId, cId, sideToEdge[3 * i], sideToEdge[3 * i + 1], sideToEdge[3 * i + 2]);
+		}
+	}
+
+	inline void MeshGraph::InsertDelaunayVertex(const uint32_t vertexId, const uint32_t containingTriangle) {
+		const Vector2 point = m_Vertices[vertexId].Position;
+
+		// Grow the cavity: every triangle connected to the first one whose circumcircle contains the point.
+		// The triangles behind an edge the point doesn't strictly see are taken too, so whatever the rounding
+		// errors of the circle test, the cavity stays star-shaped around the point. A constrained edge hides the
+		// triangles behind it, unless the point is on it.
+		// The cavity grows one layer at a time, the edges & triangles of a layer are tested together by the batch kernels.
+		std::vector<uint32_t> cavity{containingTriangle};
+		std::vector<std::pair<uint32_t, uint32_t>> candidates;
+		for (size_t layerBegin = 0; layerBegin < cavity.size();) {
+			const size_t layerEnd = cavity.size();
+			candidates.clear();
+			m_CavityEdges.Clear();
+			m_CavityNeighbours.Clear();
+			for (size_t i = layerBegin; i < layerEnd; ++i) {
+				const Triangle triangle = m_Triangles[cavity[i]];
+				for (const uint32_t edgeId: {triangle.EdgeAB, triangle.EdgeBC, triangle.EdgeCA}) {
+					const Edge &edge = m_Edges[edgeId];
+					const bool isLeft = edge.TriangleLeft == cavity[i];
+					const std::optional<uint32_t> neighbour = isLeft ? edge.TriangleRight : edge.TriangleLeft;
+					if (!neighbour || std::find(cavity.begin(), cavity.end(), neighbour.value()) != cavity.end()) continue;
+
+					const Vector2 &A = m_Vertices[edge.VertexA].Position;
+					const Vector2 &B = m_Vertices[edge.VertexB].Position;
+					const auto [aId, bId, cId] = GetTriangleVertices(neighbour.value());
+					candidates.emplace_back(edgeId, neighbour.value());
+					m_CavityEdges.Add(isLeft ? A : B, isLeft ? B : A);
+					m_CavityNeighbours.Add(m_Vertices[aId].Position, m_Vertices[bId].Position, m_Vertices[cId].Position);
+				}
+			}
+			m_CavityEdgeSides.resize(candidates.size());
+			m_CavityNeighbourInside.resize(candidates.size());
+			OrientBatch(point, m_CavityEdges, m_CavityEdgeSides.data());
+			InCircleBatch(point, m_CavityNeighbours, m_CavityNeighbourInside.data());
+
+			layerBegin = layerEnd;
+			for (size_t i = 0; i < candidates.size(); ++i) {
+				const auto &[edgeId, neighbourId] = candidates[i];
+				const bool edgeIsVisible = m_CavityEdgeSides[i] > 0;
+				if (edgeIsVisible && (m_Edges[edgeId].Constrained || !m_CavityNeighbourInside[i])) continue;
+				// A neighbour shared by two triangles of the layer is a candidate twice.
+				if (std::find(cavity.begin() + static_cast<std::ptrdiff_t>(layerEnd), cavity.end(), neighbourId) == cavity.end()) cavity.push_back(neighbourId);
+			}
+		}
+
+		// The border of the cavity, oriented counter-clockwise around the point.
+		std::vector<std::tuple<uint32_t, uint32_t, uint32_t>> border;
+		std::vector<uint32_t> innerEdges;
+		for (const uint32_t triangleId: cavity) {
+			const Triangle triangle = m_Triangles[triangleId];
+			for (const uint32_t edgeId: {triangle.EdgeAB, triangle.EdgeBC, triangle.EdgeCA}) {
+				Edge &edge = m_Edges[edgeId];
+				const bool isLeft = edge.TriangleLeft == triangleId;
+				const std::optional<uint32_t> neighbour = isLeft ? edge.TriangleRight : edge.TriangleLeft;
+				if (neighbour && std::find(cavity.begin(), cavity.end(), neighbour.value()) != cavity.end()) {
+					if (triangleId < neighbour.value()) innerEdges.push_back(edgeId);
+					continue;
+				}
+				// The point is on a border edge of the mesh, the edge is split in two.
+				if (!neighbour && !(isLeft ? Math::IsTriangleOriented(m_Vertices[edge.VertexA].Position, m_Vertices[edge.VertexB].Position, point)
+				                          : Math::IsTriangleOriented(m_Vertices[edge.VertexB].Position, m_Vertices[edge.VertexA].Position, point))) {
+					innerEdges.push_back(edgeId);
+					continue;
+				}
+				if (isLeft) {
+					border.emplace_back(edgeId, edge.VertexA, edge.VertexB);
+					edge.TriangleLeft = std::nullopt;
+				} else {
+					border.emplace_back(edgeId, edge.VertexB, edge.VertexA);
+					edge.TriangleRight = std::nullopt;
+				}
+			}
+		}
+
+		for (const uint32_t triangleId: cavity) {
+			EraseTriangle(triangleId);
+		}
+		// The constraints going through the cavity are split by the point, or inserted back around it.
+		std::vector<std::pair<uint32_t, uint32_t>> constraints;
+		for (const uint32_t edgeId: innerEdges) {
+			const Edge &edge = m_Edges[edgeId];
+			if (edge.Constrained) constraints.emplace_back(edge.VertexA, edge.VertexB);
+			EraseEdge(edgeId);
+		}
+
+		FanToVertex(vertexId, border);
+		for (const auto &[aId, bId]: constraints) InsertConstraint(aId, bId);
+	}
+
+	inline void MeshGraph::FanToVertex(const uint32_t vertexId, const std::vector<std::tuple<uint32_t, uint32_t, uint32_t>> &border) {
+		std::vector<std::pair<uint32_t, uint32_t>> vertexToEdge;
+		vertexToEdge.reserve(border.size() + 1);
+		const auto getEdgeToPoint = [this, vertexId, &vertexToEdge](const uint32_t otherId) {
+			const auto it = std::find_if(vertexToEdge.begin(), vertexToEdge.end(), [otherId](const std::pair<uint32_t, uint32_t> &pair) {
+				return pair.first == otherId;
+			});
+			if (it != vertexToEdge.end()) return it->second;
+			const uint32_t edgeId = GenerateEdgeId();
+			m_Edges[edgeId] = {otherId, vertexId};
+			vertexToEdge.emplace_back(otherId, edgeId);
+			return edgeId;
+		};
+
+		for (const auto &[edgeId, aId, bId]: border) {
+			const uint32_t bpId = getEdgeToPoint(bId);
+			const uint32_t paId = getEdgeToPoint(aId);
+			AddOrientedTriangle(aId, bId, vertexId, edgeId, bpId, paId);
+		}
+	}
+
+	inline bool MeshGraph::InsertHullVertex(const uint32_t vertexId, std::optional<uint32_t> visibleEdge) {
+		const Vector2 point = m_Vertices[vertexId].Position;
+		if (!visibleEdge) {
+			const std::optional<uint32_t> containingTriangle = LocateTriangle(point, std::nullopt, visibleEdge);
+			if (containingTriangle) {
+				// The point is on the border (or inside the mesh), it's a regular insertion.
+				InsertDelaunayVertex(vertexId, containingTriangle.value());
+				return true;
+			}
+		}
+
+		std::vector<std::tuple<uint32_t, uint32_t, uint32_t>> visibleEdges;
+		GetVisibleHullEdges(point, visibleEdge, visibleEdges);
+		if (visibleEdges.empty()) return false;
+
+		// The border edge after the visible ones stays on the border, the hull ring is entered from it.
+		m_HullEdge = GetNextHullEdge(std::get<0>(visibleEdges.back()));
+
+		// Oriented counter-clockwise around the point.
+		std::queue<uint32_t> edgeToCheck;
+		for (auto &[edgeId, aId, bId]: visibleEdges) {
+			std::swap(aId, bId);
+			edgeToCheck.push(edgeId);
+		}
+		FanToVertex(vertexId, visibleEdges);
+		LegalizeEdges(edgeToCheck);
+		return true;
+	}
+
+	inline void MeshGraph::GetVisibleHullEdges(const Vector2 point, std::optional<uint32_t> visibleEdge, std::vector<std::tuple<uint32_t, uint32_t, uint32_t>> &edges) {
+		edges.clear();
+		const auto orient = [this](const uint32_t edgeId) {
+			const Edge &edge = m_Edges[edgeId];
+			return edge.TriangleLeft ? std::pair{edge.VertexA, edge.VertexB} : std::pair{edge.VertexB, edge.VertexA};
+		};
+		const auto isVisible = [this, &orient, point](const uint32_t edgeId) {
+			const auto [aId, bId] = orient(edgeId);
+			return Math::Orient2D(m_Vertices[aId].Position, m_Vertices[bId].Position, point) < 0;
+		};
+
+		// Without the walk, the ring is searched for a visible edge.
+		const std::optional<uint32_t> hullEdge = GetHullEdge();
+		if (!hullEdge) return;
+		if (!visibleEdge) {
+			uint32_t edgeId = hullEdge.value();
+			do {
+				if (isVisible(edgeId)) {
+					visibleEdge = edgeId;
+					break;
+				}
+				edgeId = GetNextHullEdge(edgeId);
+			} while (edgeId != hullEdge.value());
+			if (!visibleEdge) return;
+		}
+
+		// The mesh is convex, the visible edges are consecutive on the ring.
+		uint32_t firstId = visibleEdge.value();
+		for (uint32_t edgeId = GetPreviousHullEdge(firstId); edgeId != visibleEdge.value() && isVisible(edgeId); edgeId = GetPreviousHullEdge(edgeId)) {
+			firstId = edgeId;
+		}
+		uint32_t edgeId = firstId;
+		do {
+			const auto [aId, bId] = orient(edgeId);
+			edges.emplace_back(edgeId, aId, bId);
+			edgeId = GetNextHullEdge(edgeId);
+		} while (edgeId != firstId && isVisible(edgeId));
+	}
+
+	inline bool MeshGraph::CompleteConvexHull() {
+		// Border edges, oriented so the mesh is on their left: the border is walked counter-clockwise.
+		std::unordered_map<uint32_t, std::pair<uint32_t, uint32_t>> nextOnBorder;
+		for (const auto &[edgeId, edge]: m_Edges) {
+			if (edge.TriangleLeft && edge.TriangleRight) continue;
+			if (!edge.TriangleLeft && !edge.TriangleRight) return false;
+			const bool inserted = edge.TriangleLeft
+				                      ? nextOnBorder.insert({edge.VertexA, {edge.VertexB, edgeId}}).second
+				                      : nextOnBorder.insert({edge.VertexB, {edge.VertexA, edgeId}}).second;
+			// A vertex twice on the border, the border isn't a simple polygon.
+			if (!inserted) return false;
+		}
+		if (nextOnBorder.size() < 3) return false;
+
+		// The lowest vertex is on the convex hull, so the scan can start from it.
+		uint32_t startId = nextOnBorder.begin()->first;
+		for (const auto &[vertexId, next]: nextOnBorder) {
+			const Vector2 &p = m_Vertices[vertexId].Position;
+			const Vector2 &start = m_Vertices[startId].Position;
+			if (p.y < start.y || (p.y == start.y && p.x < start.x)) startId = vertexId;
+		}
+
+		std::vector<uint32_t> borderVertices{startId};
+		std::vector<uint32_t> borderEdges;
+		while (true) {
+			const auto it = nextOnBorder.find(borderVertices.back());
+			if (it == nextOnBorder.end()) return false;
+			borderEdges.push_back(it->second.second);
+			if (it->second.first == startId) break;
+			borderVertices.push_back(it->second.first);
+			if (borderVertices.size() > nextOnBorder.size()) return false;
+		}
+		// Several pieces of mesh.
+		if (borderVertices.size() != nextOnBorder.size()) return false;
+
+		// Graham scan along the border, every reflex vertex is covered by a new triangle.
+		std::queue<uint32_t> edgeToCheck;
+		std::vector<uint32_t> hullVertices{startId};
+		std::vector<uint32_t> hullEdges;
+		for (size_t i = 1; i <= borderVertices.size(); ++i) {
+			const uint32_t cId = borderVertices[i % borderVertices.size()];
+			uint32_t bcId = borderEdges[i - 1];
+			while (hullVertices.size() >= 2) {
+				const uint32_t aId = hullVertices[hullVertices.size() - 2];
+				const uint32_t bId = hullVertices.back();
+				const uint32_t abId = hullEdges.back();
+				if (!Math::IsTriangleOriented(m_Vertices[aId].Position, m_Vertices[cId].Position, m_Vertices[bId].Position)) break;
+
+				const uint32_t acId = GenerateEdgeId();
+				m_Edges[acId] = {aId, cId};
+				AddOrientedTriangle(aId, cId, bId, acId, bcId, abId);
+				edgeToCheck.push(abId);
+				edgeToCheck.push(bcId);
+
+				hullVertices.pop_back();
+				hullEdges.pop_back();
+				bcId = acId;
+			}
+			if (i < borderVertices.size()) hullVertices.push_back(cId);
+			hullEdges.push_back(bcId);
+		}
+
+		LegalizeEdges(edgeToCheck);
+		return true;
+	}
+
+	inline uint32_t MeshGraph::AddOrientedTriangle(const uint32_t aId, const uint32_t bId, const uint32_t cId, const uint32_t abId, const uint32_t bcId, const uint32_t caId) {
+		const uint32_t triangleId = GenerateTriangleId();
+		m_Triangles[triangleId] = {abId, bcId, caId};
+		for (const auto &[edgeId, fromId]: {std::pair{abId, aId}, std::pair{bcId, bId}, std::pair{caId, cId}}) {
+			Edge &edge = m_Edges[edgeId];
+			if (edge.VertexA == fromId) edge.TriangleLeft = triangleId;
+			else edge.TriangleRight = triangleId;
+			SetIncidentEdge(edgeId);
+		}
+		return triangleId;
+	}
+
+	inline void MeshGraph::SetIncidentEdge(const uint32_t edgeId) {
+		const Edge &edge = m_Edges[edgeId];
+		m_Vertices[edge.VertexA].IncidentEdge = edgeId;
+		m_Vertices[edge.VertexB].IncidentEdge = edgeId;
+	}
+
+	inline std::optional<uint32_t> MeshGraph::GetIncidentEdge(const uint32_t vertexId) const {
+		// The erased edges are taken from their vertices, & the vertices that keep some edges are always given one of them back.
+		const std::optional<uint32_t> edgeId = m_Vertices[vertexId].IncidentEdge;
+		assert(!edgeId || (m_Edges.contains(edgeId.value()) && (m_Edges[edgeId.value()].VertexA == vertexId || m_Edges[edgeId.value()].VertexB == vertexId)));
+		return edgeId;
+	}
+
+	inline std::optional<uint32_t> MeshGraph::RotateAroundVertex(const uint32_t vertexId, const uint32_t edgeId, const bool counterClockwise) const {
+		// Seen from the vertex, the next edge counter-clockwise is in the triangle on the left of the edge.
+		const Edge &edge = m_Edges[edgeId];
+		const std::optional<uint32_t> &triangleId = (edge.VertexA == vertexId) == counterClockwise ? edge.TriangleLeft : edge.TriangleRight;
+		if (!triangleId) return std::nullopt;
+		const Triangle &triangle = m_Triangles[triangleId.value()];
+		for (const uint32_t otherId: {triangle.EdgeAB, triangle.EdgeBC, triangle.EdgeCA}) {
+			if (otherId == edgeId) continue;
+			const Edge &other = m_Edges[otherId];
+			if (other.VertexA == vertexId || other.VertexB == vertexId) return otherId;
+		}
+		return std::nullopt;
+	}
+
+	inline void MeshGraph::GetIncidentEdges(const uint32_t vertexId, std::vector<uint32_t> &edges) const {
+		edges.clear();
+		const std::optional<uint32_t> incidentEdge = GetIncidentEdge(vertexId);
+		if (!incidentEdge) return;
+
+		// Back to the border first, for a vertex of the hull.
+		uint32_t firstId = incidentEdge.value();
+		for (std::optional<uint32_t> edgeId = RotateAroundVertex(vertexId, firstId, false); edgeId && edgeId != incidentEdge; edgeId = RotateAroundVertex(vertexId, edgeId.value(), false)) {
+			firstId = edgeId.value();
+		}
+		edges.push_back(firstId);
+		for (std::optional<uint32_t> edgeId = RotateAroundVertex(vertexId, firstId, true); edgeId && edgeId != firstId; edgeId = RotateAroundVertex(vertexId, edgeId.value(), true)) {
+			edges.push_back(edgeId.value());
+		}
+	}
+
+	inline std::optional<uint32_t> MeshGraph::GetHullEdge() {
+		if (m_Triangles.empty()) return std::nullopt;
+		if (m_HullEdge && m_Edges.contains(m_HullEdge.value())) {
+			const Edge &edge = m_Edges[m_HullEdge.value()];
+			if (edge.TriangleLeft.has_value() != edge.TriangleRight.has_value()) return m_HullEdge;
+		}
+
+		// An inner vertex is surrounded by its neighbours, one of them is lower: going down ends on the hull.
+		const auto isLower = [this](const uint32_t aId, const uint32_t bId) {
+			const Vector2 &a = m_Vertices[aId].Position;
+			const Vector2 &b = m_Vertices[bId].Position;
+			return a.y < b.y || (a.y == b.y && a.x < b.x);
+		};
+		const uint32_t startTriangle = m_LastTriangle && m_Triangles.contains(m_LastTriangle.value()) ? m_LastTriangle.value() : m_Triangles.begin()->first;
+		uint32_t vertexId = std::get<0>(GetTriangleVertices(startTriangle));
+		std::vector<uint32_t> edges;
+		while (true) {
+			GetIncidentEdges(vertexId, edges);
+			uint32_t lowestId = vertexId;
+			for (const uint32_t edgeId: edges) {
+				const Edge &edge = m_Edges[edgeId];
+				const uint32_t otherId = edge.VertexA == vertexId ? edge.VertexB : edge.VertexA;
+				if (isLower(otherId, lowestId)) lowestId = otherId;
+			}
+			if (lowestId == vertexId) break;
+			vertexId = lowestId;
+		}
+		if (edges.empty()) return std::nullopt;
+		m_HullEdge = edges.front();
+		return m_HullEdge;
+	}
+
+	inline uint32_t MeshGraph::GetNextHullEdge(const uint32_t edgeId) const {
+		const Edge &edge = m_Edges[edgeId];
+		const uint32_t vertexId = edge.TriangleLeft ? edge.VertexB : edge.VertexA;
+		uint32_t nextId = edgeId;
+		for (std::optional<uint32_t> otherId = RotateAroundVertex(vertexId, edgeId, false); otherId; otherId = RotateAroundVertex(vertexId, otherId.value(), false)) {
+			nextId = otherId.value();
+		}
+		return nextId;
+	}
+
+	inline uint32_t MeshGraph::GetPreviousHullEdge(const uint32_t edgeId) const {
+		const Edge &edge = m_Edges[edgeId];
+		const uint32_t vertexId = edge.TriangleLeft ? edge.VertexA : edge.VertexB;
+		uint32_t previousId = edgeId;
+		for (std::optional<uint32_t> otherId = RotateAroundVertex(vertexId, edgeId, true); otherId; otherId = RotateAroundVertex(vertexId, otherId.value(), true)) {
+			previousId = otherId.value();
+		}
+		return previousId;
+	}
+
+	inline std::vector<uint32_t> MeshGraph::GetConvexHull() {
+		std::vector<uint32_t> hull;
+		const std::optional<uint32_t> firstId = GetHullEdge();
+		if (!firstId) return hull;
+		uint32_t edgeId = firstId.value();
+		do {
+			const Edge &edge = m_Edges[edgeId];
+			hull.push_back(edge.TriangleLeft ? edge.VertexA : edge.VertexB);
+			edgeId = GetNextHullEdge(edgeId);
+		} while (edgeId != firstId.value() && hull.size() <= m_Edges.size());
+		return hull;
+	}
+
 	inline void MeshGraph::clear() {
 		m_Vertices.clear();
 		m_Edges.clear();
 		m_Triangles.clear();
+		m_LastTriangle = std::nullopt;
+		m_HullEdge = std::nullopt;
+		m_HasConstraints = false;
+		InvalidateGeometry();
+		m_Voronoi = {};
+	}
+
+	inline MeshGraph::Circumcircle MeshGraph::GetCircumcircle(const uint32_t triangleId) {
+		if (!m_Triangles.contains(triangleId)) throw std::out_of_range("MeshGraph::GetCircumcircle: invalid triangle id");
+		if (!m_CircumcircleCacheEnabled) return CalculateCircumcircle(triangleId);
+
+		if (m_Circumcircles.size() < m_Triangles.id_bound()) m_Circumcircles.resize(m_Triangles.id_bound());
+		std::optional<Circumcircle> &circle = m_Circumcircles[triangleId];
+		if (!circle) circle = CalculateCircumcircle(triangleId);
+		return circle.value();
+	}
+
+	inline void MeshGraph::UpdateCircumcircleCache() {
+		if (!m_CircumcircleCacheEnabled) return;
+		if (m_Circumcircles.size() < m_Triangles.id_bound()) m_Circumcircles.resize(m_Triangles.id_bound());
+
+		std::vector<uint32_t> triangleIds;
+		TriangleBuffer triangles;
+		for (const auto &[triangleId, triangle]: m_Triangles) {
+			if (m_Circumcircles[triangleId]) continue;
+			const auto [aId, bId, cId] = GetTriangleVertices(triangleId);
+			triangleIds.push_back(triangleId);
+			triangles.Add(m_Vertices[aId].Position, m_Vertices[bId].Position, m_Vertices[cId].Position);
+		}
+		if (triangleIds.empty()) return;
+
+		std::vector<double> centerX(triangles.Size());
+		std::vector<double> centerY(triangles.Size());
+		CircumcentersBatch(triangles, centerX.data(), centerY.data());
+		for (size_t i = 0; i < triangleIds.size(); ++i) {
+			const double dx = triangles.AX[i] - centerX[i];
+			const double dy = triangles.AY[i] - centerY[i];
+			m_Circumcircles[triangleIds[i]] = Circumcircle{Vector2{static_cast<T>(centerX[i]), static_cast<T>(centerY[i])}, static_cast<T>(dx * dx + dy * dy)};
+		}
+	}
+
+	inline MeshGraph::Circumcircle MeshGraph::CalculateCircumcircle(const uint32_t triangleId) const {
+		const auto [aId, bId, cId] = GetTriangleVertices(triangleId);
+		const Vector2 &a = m_Vertices[aId].Position;
+		const Vector2 &b = m_Vertices[bId].Position;
+		const Vector2 &c = m_Vertices[cId].Position;
+		double centerX, centerY;
+		Batch::Circumcenter(a.x, a.y, b.x, b.y, c.x, c.y, centerX, centerY);
+		const double dx = static_cast<double>(a.x) - centerX;
+		const double dy = static_cast<double>(a.y) - centerY;
+		return {Vector2{static_cast<T>(centerX), static_cast<T>(centerY)}, static_cast<T>(dx * dx + dy * dy)};
+	}
+
+	inline std::tuple<uint32_t, uint32_t, uint32_t> MeshGraph::GetTriangleVertices(const uint32_t triangleId) const {
+		const Triangle &ABC = m_Triangles[triangleId];
+		const Edge &AB = m_Edges[ABC.EdgeAB];
+		const Edge &BC = m_Edges[ABC.EdgeBC];
+		const uint32_t cId = BC.VertexA == AB.VertexA || BC.VertexA == AB.VertexB ? BC.VertexB : BC.VertexA;
+		return {AB.VertexA, AB.VertexB, cId};
+	}
+
+	inline MeshGraph::T MeshGraph::InterpolateHeight(const uint32_t triangleId, const Vector2 point) const {
+		const auto [aId, bId, cId] = GetTriangleVertices(triangleId);
+		const Vertex &a = m_Vertices[aId];
+		const Vertex &b = m_Vertices[bId];
+		const Vertex &c = m_Vertices[cId];
+		const double area = Math::Orient2D(a.Position, b.Position, c.Position);
+		if (area == 0) return (a.Height + b.Height + c.Height) / static_cast<T>(3);
+		const double surface = Math::Orient2D(point, b.Position, c.Position) * a.Height + Math::Orient2D(a.Position, point, c.Position) * b.Height +
+		                       Math::Orient2D(a.Position, b.Position, point) * c.Height;
+		return static_cast<T>(surface / area);
+	}
+
+	inline std::optional<uint32_t> MeshGraph::LocateTriangle(const Vector2 point, const std::optional<uint32_t> triangleHint) const {
+		std::optional<uint32_t> borderEdge{std::nullopt};
+		return LocateTriangle(point, triangleHint, borderEdge);
+	}
+
+	inline std::optional<uint32_t> MeshGraph::LocateTriangle(const Vector2 point, const std::optional<uint32_t> triangleHint, std::optional<uint32_t> &borderEdge) const {
+		borderEdge = std::nullopt;
+		if (m_Triangles.empty()) return std::nullopt;
+
+		uint32_t current;
+		if (triangleHint && m_Triangles.contains(triangleHint.value())) {
+			current = triangleHint.value();
+		} else if (m_LastTriangle && m_Triangles.contains(m_LastTriangle.value())) {
+			current = m_LastTriangle.value();
+		} else {
+			current = m_Triangles.begin()->first;
+		}
+
+		// The walk always terminate on a Delaunay triangulation, the limit is for the other ones.
+		const uint64_t maxSteps = 4 * static_cast<uint64_t>(m_Triangles.size()) + 16;
+		std::optional<uint32_t> previous{std::nullopt};
+		uint32_t random = 0x9E3779B9u;
+
+		for (uint64_t step = 0; step < maxSteps; ++step) {
+			const Triangle &triangle = m_Triangles[current];
+			const std::array<uint32_t, 3> edges{triangle.EdgeAB, triangle.EdgeBC, triangle.EdgeCA};
+
+			// Xorshift to start from a random edge, it's what prevents the walk from cycling.
+			random ^= random << 13;
+			random ^= random >> 17;
+			random ^= random << 5;
+			const uint32_t offset = random % 3;
+
+			std::optional<uint32_t> next{std::nullopt};
+			for (uint32_t i = 0; i < 3; ++i) {
+				const Edge &edge = m_Edges[edges[(i + offset) % 3]];
+				const bool isLeft = edge.TriangleLeft == current;
+				const std::optional<uint32_t> neighbour = isLeft ? edge.TriangleRight : edge.TriangleLeft;
+				// Remembering walk: no need to test the edge we just came through.
+				if (neighbour && neighbour == previous) continue;
+
+				const Vector2 &A = m_Vertices[edge.VertexA].Position;
+				const Vector2 &B = m_Vertices[edge.VertexB].Position;
+				const bool pointIsBeyondEdge = isLeft ? Math::IsTriangleOriented(B, A, point) : Math::IsTriangleOriented(A, B, point);
+				if (!pointIsBeyondEdge) continue;
+
+				// The mesh is convex, crossing a border edge means we're outside.
+				if (!neighbour) {
+					borderEdge = edges[(i + offset) % 3];
+					return std::nullopt;
+				}
+				next = neighbour;
+				break;
+			}
+
+			if (!next) return current;
+			previous = current;
+			current = next.value();
+		}
+
+		for (const auto &[triangleId, triangle]: m_Triangles) {
+			const auto [aId, bId, cId] = GetTriangleVertices(triangleId);
+			if (Math::PointIsInsideTriangle(m_Vertices[aId].Position, m_Vertices[bId].Position, m_Vertices[cId].Position, point)) {
+				return triangleId;
+			}
+		}
+		return std::nullopt;
 	}
 
 	inline void MeshGraph::ReverseEdge(const uint32_t edgeId) {
@@ -1010,6 +2823,8 @@ namespace TRG::Math {
 
 		Triangle &t1 = m_Triangles.at(t1Id);
 		Triangle &t2 = m_Triangles.at(t2Id);
+		InvalidateTriangle(t1Id);
+		InvalidateTriangle(t2Id);
 
 		uint32_t a1Id = -1;
 		uint32_t a4Id = -1;
@@ -1121,5 +2936,9 @@ namespace TRG::Math {
 
 			m_Edges[edgeId] = {s3Id, s4Id, t1Id, t2Id};
 		}
+		// s1 & s2 lost the flipped edge.
+		for (const uint32_t sideId: {a1Id, a2Id, a3Id, a4Id}) {
+			SetIncidentEdge(sideId);
+		}
 	}
 }
@@ -0,0 +1,283 @@
+#pragma once
+
+#include "Basics.hpp"
+#include "Predicates.hpp"
+#include <numeric>
+#include <set>
+#include <stdexcept>
+#include <vector>
+
+namespace TRG::Math {
+
+	namespace Polygons {
+		/**
+		 * Order of the edges crossing the sweep line, from left to right. The edge i goes down from i to next[i].
+		 * They never cross, so the one starting lower is compared to the line of the other.
+		 * A point is compared to the line of an edge, to look up the edge on its left.
+		 */
+		template<typename T, glm::qualifier Q>
+		struct StatusLess {
+			using Vector2 = glm::vec<2, T, Q>;
+			using is_transparent = void;
+			const std::vector<Vector2> *Points;
+			const std::vector<uint32_t> *Next;
+			const std::vector<uint32_t> *Rank;
+
+			bool operator()(const uint32_t a, const uint32_t b) const {
+				if (a == b) return false;
+				const std::vector<Vector2> &p = *Points;
+				if ((*Rank)[a] > (*Rank)[b]) return Orient2D(p[b], p[(*Next)[b]], p[a]) < 0;
+				return Orient2D(p[a], p[(*Next)[a]], p[b]) > 0;
+			}
+			bool operator()(const uint32_t edge, const Vector2 &point) const {
+				return Orient2D((*Points)[edge], (*Points)[(*Next)[edge]], point) > 0;
+			}
+			bool operator()(const Vector2 &point, const uint32_t edge) const {
+				return Orient2D((*Points)[edge], (*Points)[(*Next)[edge]], point) < 0;
+			}
+		};
+	}
+
+	/**
+	 * Triangulate a simple polygon with holes in O(n log n): a sweep line going down splits it in y-monotone pieces,
+	 * each of them is then triangulated with a stack, from the top to the bottom.
+	 * The vertices are numbered in the order of the loops, the outer loop first and then the holes one after the other.
+	 * @param polygon The outer loop, in any orientation.
+	 * @param holes The loops of the holes, in any orientation, strictly inside the outer loop and apart from each other.
+	 * @return The indices of the vertices of the triangles, three per counter-clockwise triangle.
+	 * @throw std::invalid_argument If a loop has less than three vertices, or if the loops cross each other.
+	 */
+	template<typename T = Real, glm::qualifier Q = glm::qualifier::defaultp>
+	[[nodiscard]] std::vector<uint32_t> TriangulatePolygon(const std::vector<glm::vec<2, T, Q>> &polygon, const std::vector<std::vector<glm::vec<2, T, Q>>> &holes = {}) {
+		using Vector2 = glm::vec<2, T, Q>;
+
+		// The loops are linked so the interior is on the left of every edge: the outer loop counter-clockwise, the holes clockwise.
+		std::vector<Vector2> points;
+		std::vector<uint32_t> next;
+		std::vector<uint32_t> previous;
+		const auto addLoop = [&points, &next, &previous](const std::vector<Vector2> &loop, const bool counterClockwise) {
+			if (loop.size() < 3) throw std::invalid_argument("TriangulatePolygon: a loop needs at least three vertices");
+			const auto first = static_cast<uint32_t>(points.size());
+			const auto count = static_cast<uint32_t>(loop.size());
+			double area = 0;
+			for (uint32_t i = 1; i + 1 < count; ++i) area += Orient2D(loop[0], loop[i], loop[i + 1]);
+			const bool reverse = (area > 0) != counterClockwise;
+			points.insert(points.end(), loop.begin(), loop.end());
+			for (uint32_t i = 0; i < count; ++i) {
+				const uint32_t after = first + (i + 1) % count;
+				const uint32_t before = first + (i + count - 1) % count;
+				next.push_back(reverse ? before : after);
+				previous.push_back(reverse ? after : before);
+			}
+		};
+		addLoop(polygon, true);
+		for (const std::vector<Vector2> &hole: holes) addLoop(hole, false);
+		const auto count = static_cast<uint32_t>(points.size());
+
+		// The sweep goes down, the vertices at the same height from left to right.
+		std::vector<uint32_t> order(count);
+		std::iota(order.begin(), order.end(), 0);
+		std::sort(order.begin(), order.end(), [&points](const uint32_t a, const uint32_t b) {
+			return points[a].y > points[b].y || (points[a].y == points[b].y && points[a].x < points[b].x);
+		});
+		std::vector<uint32_t> rank(count);
+		for (uint32_t i = 0; i < count; ++i) rank[order[i]] = i;
+
+		enum class VertexType : uint8_t { Start, End, Split, Merge, Regular };
+		std::vector<VertexType> types(count);
+		for (uint32_t v = 0; v < count; ++v) {
+			const bool previousBelow = rank[previous[v]] > rank[v];
+			const bool nextBelow = rank[next[v]] > rank[v];
+			const bool convex = Orient2D(points[previous[v]], points[v], points[next[v]]) > 0;
+			if (previousBelow && nextBelow) types[v] = convex ? VertexType::Start : VertexType::Split;
+			else if (!previousBelow && !nextBelow) types[v] = convex ? VertexType::End : VertexType::Merge;
+			else types[v] = VertexType::Regular;
+		}
+
+		// The edges crossing the sweep line with the interior on their right, from left to right. The edge i goes down from i to next[i].
+		using StatusLess = Polygons::StatusLess<T, Q>;
+		std::set<uint32_t, StatusLess> status(StatusLess{&points, &next, &rank});
+		std::vector<uint32_t> helper(count);
+		std::vector<std::pair<uint32_t, uint32_t>> diagonals;
+
+		const auto getLeftEdge = [&status, &points](const uint32_t v) {
+			auto it = status.lower_bound(points[v]);
+			if (it == status.begin()) throw std::invalid_argument("TriangulatePolygon: the loops cross each other");
+			return *--it;
+		};
+		const auto connectIfMerge = [&types, &helper, &diagonals](const uint32_t edge, const uint32_t v) {
+			if (types[helper[edge]] == VertexType::Merge) diagonals.emplace_back(v, helper[edge]);
+		};
+		const auto removeEdge = [&status](const uint32_t edge) {
+			if (status.erase(edge) == 0) throw std::invalid_argument("TriangulatePolygon: the loops cross each other");
+		};
+		for (const uint32_t v: order) {
+			const uint32_t p = previous[v];
+			switch (types[v]) {
+				case VertexType::Start:
+					status.insert(v);
+					helper[v] = v;
+					break;
+				case VertexType::End:
+					connectIfMerge(p, v);
+					removeEdge(p);
+					break;
+				case VertexType::Split: {
+					const uint32_t left = getLeftEdge(v);
+					diagonals.emplace_back(v, helper[left]);
+					helper[left] = v;
+					status.insert(v);
+					helper[v] = v;
+					break;
+				}
+				case VertexType::Merge: {
+					connectIfMerge(p, v);
+					removeEdge(p);
+					const uint32_t left = getLeftEdge(v);
+					connectIfMerge(left, v);
+					helper[left] = v;
+					break;
+				}
+				case VertexType::Regular:
+					// On a left side of the polygon the edge above ends here, on a right side the vertex helps the edge on its left.
+					if (rank[p] < rank[v]) {
+						connectIfMerge(p, v);
+						removeEdge(p);
+						status.insert(v);
+						helper[v] = v;
+					} else {
+						const uint32_t left = getLeftEdge(v);
+						connectIfMerge(left, v);
+						helper[left] = v;
+					}
+					break;
+			}
+		}
+
+		// The neighbours of each vertex, sorted counter-clockwise. The faces on the left of the half-edges are the monotone pieces.
+		std::vector<uint32_t> offsets(count + 1, 2);
+		offsets[count] = 0;
+		for (const auto &[a, b]: diagonals) {
+			++offsets[a];
+			++offsets[b];
+		}
+		std::exclusive_scan(offsets.begin(), offsets.end(), offsets.begin(), 0u);
+		std::vector<uint32_t> neighbours(offsets[count]);
+		std::vector<uint32_t> filled(offsets.begin(), offsets.end() - 1);
+		for (uint32_t v = 0; v < count; ++v) {
+			neighbours[filled[v]++] = next[v];
+			neighbours[filled[v]++] = previous[v];
+		}
+		for (const auto &[a, b]: diagonals) {
+			neighbours[filled[a]++] = b;
+			neighbours[filled[b]++] = a;
+		}
+		for (uint32_t v = 0; v < count; ++v) {
+			const Vector2 &center = points[v];
+			const auto isLowerHalf = [&center](const Vector2 &p) { return p.y < center.y || (p.y == center.y && p.x < center.x); };
+			std::sort(neighbours.begin() + offsets[v], neighbours.begin() + offsets[v + 1], [&](const uint32_t a, const uint32_t b) {
+				const bool aLower = isLowerHalf(points[a]);
+				if (aLower != isLowerHalf(points[b])) return !aLower;
+				return Orient2D(center, points[a], points[b]) > 0;
+			});
+		}
+
+		// The half-edges going backward along the loops are outside.
+		std::vector<bool> visited(neighbours.size(), false);
+		for (uint32_t v = 0; v < count; ++v) {
+			for (uint32_t k = offsets[v]; k < offsets[v + 1]; ++k) {
+				if (neighbours[k] == previous[v]) visited[k] = true;
+			}
+		}
+
+		std::vector<uint32_t> indices;
+		indices.reserve(3 * (count + 2 * holes.size()));
+		const auto addTriangle = [&indices, &points](const uint32_t a, const uint32_t b, const uint32_t c) {
+			indices.push_back(a);
+			if (Orient2D(points[a], points[b], points[c]) >= 0) {
+				indices.push_back(b);
+				indices.push_back(c);
+			} else {
+				indices.push_back(c);
+				indices.push_back(b);
+			}
+		};
+
+		std::vector<uint32_t> face;
+		std::vector<uint32_t> sorted;
+		std::vector<bool> isLeft(count, false);
+		std::vector<uint32_t> stack;
+		for (uint32_t start = 0; start < neighbours.size(); ++start) {
+			if (visited[start]) continue;
+
+			// Walk around the face: at each vertex, the next half-edge is the first one clockwise from where it comes from.
+			face.clear();
+			uint32_t v = static_cast<uint32_t>(std::upper_bound(offsets.begin(), offsets.end(), start) - offsets.begin()) - 1;
+			uint32_t k = start;
+			while (!visited[k]) {
+				visited[k] = true;
+				face.push_back(v);
+				const uint32_t w = neighbours[k];
+				const uint32_t back = static_cast<uint32_t>(std::find(neighbours.begin() + offsets[w], neighbours.begin() + offsets[w + 1], v) - neighbours.begin());
+				k = back == offsets[w] ? offsets[w + 1] - 1 : back - 1;
+				v = w;
+			}
+			if (face.size() < 3) continue;
+			if (face.size() == 3) {
+				addTriangle(face[0], face[1], face[2]);
+				continue;
+			}
+
+			// The face goes down its left chain from the top & up its right chain, they're merged from the top to the bottom.
+			const size_t size = face.size();
+			size_t top = 0, bottom = 0;
+			for (size_t i = 1; i < size; ++i) {
+				if (rank[face[i]] < rank[face[top]]) top = i;
+				if (rank[face[i]] > rank[face[bottom]]) bottom = i;
+			}
+			for (size_t i = top; i != bottom; i = (i + 1) % size) isLeft[face[i]] = true;
+			isLeft[face[bottom]] = false;
+			for (size_t i = (bottom + 1) % size; i != top; i = (i + 1) % size) isLeft[face[i]] = false;
+			sorted.clear();
+			size_t left = top, right = (top + size - 1) % size;
+			sorted.push_back(face[top]);
+			while (sorted.size() < size) {
+				const size_t nextLeft = (left + 1) % size;
+				if (nextLeft != bottom && (right == bottom || rank[face[nextLeft]] < rank[face[right]])) {
+					sorted.push_back(face[nextLeft]);
+					left = nextLeft;
+				} else if (right != bottom) {
+					sorted.push_back(face[right]);
+					right = (right + size - 1) % size;
+				} else {
+					sorted.push_back(face[bottom]);
+				}
+			}
+
+			stack.assign({sorted[0], sorted[1]});
+			for (size_t j = 2; j + 1 < size; ++j) {
+				const uint32_t u = sorted[j];
+				if (isLeft[u] != isLeft[stack.back()]) {
+					for (size_t i = 1; i < stack.size(); ++i) addTriangle(u, stack[i - 1], stack[i]);
+					stack.assign({sorted[j - 1], u});
+				} else {
+					// The diagonals are added while the chain turns toward the interior.
+					uint32_t last = stack.back();
+					stack.pop_back();
+					while (!stack.empty() && (isLeft[u]
+					                              ? Orient2D(points[stack.back()], points[last], points[u]) > 0
+					                              : Orient2D(points[u], points[last], points[stack.back()]) > 0)) {
+						addTriangle(u, last, stack.back());
+						last = stack.back();
+						stack.pop_back();
+					}
+					stack.push_back(last);
+					stack.push_back(u);
+				}
+			}
+			for (size_t i = 1; i < stack.size(); ++i) addTriangle(sorted[size - 1], stack[i - 1], stack[i]);
+		}
+		return indices;
+	}
+
+}
@@ -0,0 +1,428 @@
+#pragma once
+
+#include "Basics.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <span>
+
+namespace TRG::Math {
+
+	/**
+	 * Adaptive precision geometric predicates, after "Adaptive Precision Floating-Point Arithmetic
+	 * and Fast Robust Geometric Predicates" (J. R. Shewchuk).
+	 * The determinant is first evaluated in double precision with a bound of its rounding error,
+	 * and only when the sign is not certain it is evaluated again exactly, with floating-point expansions.
+	 * The float & double coordinates are converted losslessly to double, so the sign is always the exact one.
+	 */
+	namespace Predicates {
+
+		// Half an ulp of 1.0, the relative error of a rounded double operation.
+		inline constexpr double Epsilon = 0x1p-53;
+		inline constexpr double Orient2DErrorBound = (3.0 + 16.0 * Epsilon) * Epsilon;
+		inline constexpr double InCircleErrorBound = (10.0 + 96.0 * Epsilon) * Epsilon;
+		inline constexpr double Orient3DErrorBound = (7.0 + 56.0 * Epsilon) * Epsilon;
+		inline constexpr double InSphereErrorBound = (16.0 + 224.0 * Epsilon) * Epsilon;
+
+		/**
+		 * A non-overlapping expansion, the components sorted by increasing magnitude, the zeros removed.
+		 * The capacity follows from the operations that made it, so the exact evaluations never allocate.
+		 */
+		template<size_t N>
+		struct Expansion {
+			std::array<double, N> Components;
+			size_t Size{0};
+
+			void push_back(const double component) { Components[Size++] = component; }
+			[[nodiscard]] std::span<const double> GetComponents() const { return {Components.data(), Size}; }
+		};
+
+		/// Sum of a & b, x being the rounded sum and y the rounding error.
+		inline void TwoSum(const double a, const double b, double &x, double &y) {
+			x = a + b;
+			const double bVirtual = x - a;
+			const double aVirtual = x - bVirtual;
+			y = (a - aVirtual) + (b - bVirtual);
+		}
+
+		/// Product of a & b, x being the rounded product and y the rounding error.
+		inline void TwoProduct(const double a, const double b, double &x, double &y) {
+			x = a * b;
+			y = std::fma(a, b, -x);
+		}
+
+		/// Write the sum of two expansions in h, which must have room for all their components, and return its size.
+		inline size_t SumComponents(const std::span<const double> e, const std::span<const double> f, double *h) {
+			// The components are merged by increasing magnitude, the carry going up (Shewchuk's fast expansion sum).
+			size_t i = 0, j = 0, size = 0;
+			const auto next = [&]() { return j == f.size() || (i < e.size() && std::abs(e[i]) < std::abs(f[j])) ? e[i++] : f[j++]; };
+			if (e.empty() && f.empty()) return 0;
+			double q = next();
+			while (i < e.size() || j < f.size()) {
+				double sum, error;
+				TwoSum(q, next(), sum, error);
+				q = sum;
+				if (error != 0) h[size++] = error;
+			}
+			if (q != 0) h[size++] = q;
+			return size;
+		}
+
+		/// Write the product of an expansion & a double in h, which must have room for twice the components, and return its size.
+		inline size_t ScaleComponents(const std::span<const double> e, const double b, double *h) {
+			if (e.empty() || b == 0) return 0;
+			size_t size = 0;
+			double q, error;
+			TwoProduct(e[0], b, q, error);
+			if (error != 0) h[size++] = error;
+			for (size_t i = 1; i < e.size(); ++i) {
+				double product, productError;
+				TwoProduct(e[i], b, product, productError);
+				double sum;
+				TwoSum(q, productError, sum, error);
+				if (error != 0) h[size++] = error;
+				TwoSum(product, sum, q, error);
+				if (error != 0) h[size++] = error;
+			}
+			if (q != 0) h[size++] = q;
+			return size;
+		}
+
+		/// Exact a - b, as an expansion.
+		[[nodiscard]] inline Expansion<2> Difference(const double a, const double b) {
+			double x, y;
+			TwoSum(a, -b, x, y);
+			Expansion<2> result;
+			if (y != 0) result.push_back(y);
+			if (x != 0) result.push_back(x);
+			return result;
+		}
+
+		/// Exact a * b - c * d, as an expansion.
+		[[nodiscard]] inline Expansion<4> TwoTwoDifference(const double a, const double b, const double c, const double d) {
+			double ab[2], cd[2];
+			TwoProduct(a, b, ab[1], ab[0]);
+			TwoProduct(-c, d, cd[1], cd[0]);
+			// The rounding errors are zero or smaller than the products, the zeros are removed by the sum.
+			Expansion<4> result;
+			result.Size = SumComponents(ab, cd, result.Components.data());
+			return result;
+		}
+
+		template<size_t N, size_t M>
+		[[nodiscard]] inline Expansion<N + M> Sum(const Expansion<N> &e, const Expansion<M> &f) {
+			Expansion<N + M> result;
+			result.Size = SumComponents(e.GetComponents(), f.GetComponents(), result.Components.data());
+			return result;
+		}
+
+		template<size_t N>
+		[[nodiscard]] inline Expansion<2 * N> Scale(const Expansion<N> &e, const double b) {
+			Expansion<2 * N> result;
+			result.Size = ScaleComponents(e.GetComponents(), b, result.Components.data());
+			return result;
+		}
+
+		template<size_t N, size_t M>
+		[[nodiscard]] inline Expansion<2 * N * M> Product(const Expansion<N> &e, const Expansion<M> &f) {
+			// The partial sums go back & forth between the result and a second buffer.
+			Expansion<2 * N * M> result;
+			std::array<double, 2 * N * M> buffer;
+			std::array<double, 2 * N> scaled;
+			double *current = result.Components.data();
+			double *next = buffer.data();
+			size_t size = 0;
+			for (const double component: f.GetComponents()) {
+				const size_t scaledSize = ScaleComponents(e.GetComponents(), component, scaled.data());
+				size = SumComponents({current, size}, {scaled.data(), scaledSize}, next);
+				std::swap(current, next);
+			}
+			if (current != result.Components.data()) std::copy_n(current, size, result.Components.data());
+			result.Size = size;
+			return result;
+		}
+
+		template<size_t N>
+		[[nodiscard]] inline Expansion<N> Negate(Expansion<N> e) {
+			for (size_t i = 0; i < e.Size; ++i) e.Components[i] = -e.Components[i];
+			return e;
+		}
+
+		/// The most significant component, which has the sign of the whole expansion.
+		template<size_t N>
+		[[nodiscard]] inline double Estimate(const Expansion<N> &e) {
+			return e.Size == 0 ? 0.0 : e.Components[e.Size - 1];
+		}
+
+		/**
+		 * The exact determinants are expanded on the coordinates themselves, which only needs products by doubles:
+		 * a 2x2 minor is a difference of two products, and each larger minor scales the smaller ones by a coordinate.
+		 * The orientation of the triangle PQR is the 3x3 minor | x y 1 | of its points.
+		 */
+		[[nodiscard]] inline Expansion<12> OrientationMinor(const double px, const double py, const double qx, const double qy, const double rx, const double ry) {
+			return Sum(Sum(TwoTwoDifference(px, qy, qx, py), TwoTwoDifference(qx, ry, rx, qy)), TwoTwoDifference(rx, py, px, ry));
+		}
+
+		/// The 4x4 minor | x y z 1 | of the points P, Q, R & S, expanded along z.
+		[[nodiscard]] inline Expansion<96> OrientationMinor(const double px, const double py, const double pz, const double qx, const double qy, const double qz,
+		                                                    const double rx, const double ry, const double rz, const double sx, const double sy, const double sz) {
+			return Sum(Sum(Scale(OrientationMinor(qx, qy, rx, ry, sx, sy), pz), Scale(OrientationMinor(px, py, rx, ry, sx, sy), -qz)),
+			           Sum(Scale(OrientationMinor(px, py, qx, qy, sx, sy), rz), Scale(OrientationMinor(px, py, qx, qy, rx, ry), -sz)));
+		}
+
+		/// The product of the minor and the lift x² + y² (+ z²) of a point.
+		template<size_t N>
+		[[nodiscard]] inline Expansion<8 * N> Lift(const Expansion<N> &minor, const double x, const double y) {
+			return Sum(Scale(Scale(minor, x), x), Scale(Scale(minor, y), y));
+		}
+
+		template<size_t N>
+		[[nodiscard]] inline Expansion<12 * N> Lift(const Expansion<N> &minor, const double x, const double y, const double z) {
+			return Sum(Lift(minor, x, y), Scale(Scale(minor, z), z));
+		}
+
+		[[nodiscard]] inline double Orient2DExact(const double ax, const double ay, const double bx, const double by, const double cx, const double cy) {
+			return Estimate(OrientationMinor(ax, ay, bx, by, cx, cy));
+		}
+
+		/**
+		 * The orientation determinant of the triangle ABC.
+		 * @return A positive value if ABC is counter-clockwise, a negative one if it is clockwise, 0 if A, B & C are collinear.
+		 */
+		[[nodiscard]] inline double Orient2D(const double ax, const double ay, const double bx, const double by, const double cx, const double cy) {
+			const double left = (ax - cx) * (by - cy);
+			const double right = (ay - cy) * (bx - cx);
+			const double determinant = left - right;
+
+			double sum;
+			if (left > 0) {
+				if (right <= 0) return determinant;
+				sum = left + right;
+			} else if (left < 0) {
+				if (right >= 0) return determinant;
+				sum = -left - right;
+			} else {
+				return determinant;
+			}
+
+			const double bound = Orient2DErrorBound * sum;
+			if (determinant >= bound || -determinant >= bound) return determinant;
+			return Orient2DExact(ax, ay, bx, by, cx, cy);
+		}
+
+		[[nodiscard]] inline double InCircleExact(const double ax, const double ay, const double bx, const double by, const double cx, const double cy, const double dx, const double dy) {
+			// The 4x4 determinant | x y x²+y² 1 |, expanded along the lifts.
+			const Expansion<96> a = Lift(OrientationMinor(bx, by, cx, cy, dx, dy), ax, ay);
+			const Expansion<96> b = Lift(OrientationMinor(ax, ay, cx, cy, dx, dy), bx, by);
+			const Expansion<96> c = Lift(OrientationMinor(ax, ay, bx, by, dx, dy), cx, cy);
+			const Expansion<96> d = Lift(OrientationMinor(ax, ay, bx, by, cx, cy), dx, dy);
+			return Estimate(Sum(Sum(a, Negate(b)), Sum(c, Negate(d))));
+		}
+
+		/**
+		 * The in-circle determinant of D against the triangle ABC.
+		 * @return A positive value if D is inside the circumcircle of the counter-clockwise triangle ABC,
+		 * a negative one if D is outside, 0 if the 4 points are cocircular. The sign is reversed if ABC is clockwise.
+		 */
+		[[nodiscard]] inline double InCircle(const double ax, const double ay, const double bx, const double by, const double cx, const double cy, const double dx, const double dy) {
+			const double adx = ax - dx;
+			const double ady = ay - dy;
+			const double bdx = bx - dx;
+			const double bdy = by - dy;
+			const double cdx = cx - dx;
+			const double cdy = cy - dy;
+
+			const double bdxcdy = bdx * cdy;
+			const double cdxbdy = cdx * bdy;
+			const double aLift = adx * adx + ady * ady;
+
+			const double cdxady = cdx * ady;
+			const double adxcdy = adx * cdy;
+			const double bLift = bdx * bdx + bdy * bdy;
+
+			const double adxbdy = adx * bdy;
+			const double bdxady = bdx * ady;
+			const double cLift = cdx * cdx + cdy * cdy;
+
+			const double determinant = aLift * (bdxcdy - cdxbdy) + bLift * (cdxady - adxcdy) + cLift * (adxbdy - bdxady);
+			const double permanent = (std::abs(bdxcdy) + std::abs(cdxbdy)) * aLift
+			                         + (std::abs(cdxady) + std::abs(adxcdy)) * bLift
+			                         + (std::abs(adxbdy) + std::abs(bdxady)) * cLift;
+			const double bound = InCircleErrorBound * permanent;
+			if (determinant > bound || -determinant > bound) return determinant;
+			return InCircleExact(ax, ay, bx, by, cx, cy, dx, dy);
+		}
+
+		[[nodiscard]] inline double Orient3DExact(const double ax, const double ay, const double az, const double bx, const double by, const double bz,
+		                                          const double cx, const double cy, const double cz, const double dx, const double dy, const double dz) {
+			return Estimate(OrientationMinor(ax, ay, az, bx, by, bz, cx, cy, cz, dx, dy, dz));
+		}
+
+		/**
+		 * The orientation determinant of the tetrahedron ABCD.
+		 * @return A positive value if D is below the plane of ABC, "below" being the side from which ABC is clockwise,
+		 * a negative one if D is above, 0 if the 4 points are coplanar.
+		 */
+		[[nodiscard]] inline double Orient3D(const double ax, const double ay, const double az, const double bx, const double by, const double bz,
+		                                     const double cx, const double cy, const double cz, const double dx, const double dy, const double dz) {
+			const double adx = ax - dx;
+			const double ady = ay - dy;
+			const double adz = az - dz;
+			const double bdx = bx - dx;
+			const double bdy = by - dy;
+			const double bdz = bz - dz;
+			const double cdx = cx - dx;
+			const double cdy = cy - dy;
+			const double cdz = cz - dz;
+
+			const double bdxcdy = bdx * cdy;
+			const double cdxbdy = cdx * bdy;
+			const double cdxady = cdx * ady;
+			const double adxcdy = adx * cdy;
+			const double adxbdy = adx * bdy;
+			const double bdxady = bdx * ady;
+
+			const double determinant = adz * (bdxcdy - cdxbdy) + bdz * (cdxady - adxcdy) + cdz * (adxbdy - bdxady);
+			const double permanent = (std::abs(bdxcdy) + std::abs(cdxbdy)) * std::abs(adz)
+			                         + (std::abs(cdxady) + std::abs(adxcdy)) * std::abs(bdz)
+			                         + (std::abs(adxbdy) + std::abs(bdxady)) * std::abs(cdz);
+			const double bound = Orient3DErrorBound * permanent;
+			if (determinant > bound || -determinant > bound) return determinant;
+			return Orient3DExact(ax, ay, az, bx, by, bz, cx, cy, cz, dx, dy, dz);
+		}
+
+		[[nodiscard]] inline double InSphereExact(const double ax, const double ay, const double az, const double bx, const double by, const double bz,
+		                                          const double cx, const double cy, const double cz, const double dx, const double dy, const double dz,
+		                                          const double ex, const double ey, const double ez) {
+			// The 5x5 determinant | x y z x²+y²+z² 1 |, expanded along the lifts, at most 5760 components like Shewchuk's.
+			const Expansion<1152> a = Lift(OrientationMinor(bx, by, bz, cx, cy, cz, dx, dy, dz, ex, ey, ez), ax, ay, az);
+			const Expansion<1152> b = Lift(OrientationMinor(ax, ay, az, cx, cy, cz, dx, dy, dz, ex, ey, ez), bx, by, bz);
+			const Expansion<1152> c = Lift(OrientationMinor(ax, ay, az, bx, by, bz, dx, dy, dz, ex, ey, ez), cx, cy, cz);
+			const Expansion<1152> d = Lift(OrientationMinor(ax, ay, az, bx, by, bz, cx, cy, cz, ex, ey, ez), dx, dy, dz);
+			const Expansion<1152> e = Lift(OrientationMinor(ax, ay, az, bx, by, bz, cx, cy, cz, dx, dy, dz), ex, ey, ez);
+			return Estimate(Sum(Sum(Negate(a), b), Sum(Sum(Negate(c), d), Negate(e))));
+		}
+
+		/**
+		 * The in-sphere determinant of E against the tetrahedron ABCD.
+		 * @return A positive value if E is inside the circumsphere of ABCD when Orient3D(A, B, C, D) is positive,
+		 * a negative one if E is outside, 0 if the 5 points are cospherical. The sign is reversed if ABCD is negatively oriented.
+		 */
+		[[nodiscard]] inline double InSphere(const double ax, const double ay, const double az, const double bx, const double by, const double bz,
+		                                     const double cx, const double cy, const double cz, const double dx, const double dy, const double dz,
+		                                     const double ex, const double ey, const double ez) {
+			const double aex = ax - ex;
+			const double aey = ay - ey;
+			const double aez = az - ez;
+			const double bex = bx - ex;
+			const double bey = by - ey;
+			const double bez = bz - ez;
+			const double cex = cx - ex;
+			const double cey = cy - ey;
+			const double cez = cz - ez;
+			const double dex = dx - ex;
+			const double dey = dy - ey;
+			const double dez = dz - ez;
+
+			const double aexbey = aex * bey;
+			const double bexaey = bex * aey;
+			const double bexcey = bex * cey;
+			const double cexbey = cex * bey;
+			const double cexdey = cex * dey;
+			const double dexcey = dex * cey;
+			const double dexaey = dex * aey;
+			const double aexdey = aex * dey;
+			const double aexcey = aex * cey;
+			const double cexaey = cex * aey;
+			const double bexdey = bex * dey;
+			const double dexbey = dex * bey;
+
+			const double ab = aexbey - bexaey;
+			const double bc = bexcey - cexbey;
+			const double cd = cexdey - dexcey;
+			const double da = dexaey - aexdey;
+			const double ac = aexcey - cexaey;
+			const double bd = bexdey - dexbey;
+
+			const double abc = aez * bc - bez * ac + cez * ab;
+			const double bcd = bez * cd - cez * bd + dez * bc;
+			const double cda = cez * da + dez * ac + aez * cd;
+			const double dab = dez * ab + aez * bd + bez * da;
+
+			const double aLift = aex * aex + aey * aey + aez * aez;
+			const double bLift = bex * bex + bey * bey + bez * bez;
+			const double cLift = cex * cex + cey * cey + cez * cez;
+			const double dLift = dex * dex + dey * dey + dez * dez;
+
+			const double determinant = (dLift * abc - cLift * dab) + (bLift * cda - aLift * bcd);
+
+			const double aez0 = std::abs(aez);
+			const double bez0 = std::abs(bez);
+			const double cez0 = std::abs(cez);
+			const double dez0 = std::abs(dez);
+			const double ab0 = std::abs(aexbey) + std::abs(bexaey);
+			const double bc0 = std::abs(bexcey) + std::abs(cexbey);
+			const double cd0 = std::abs(cexdey) + std::abs(dexcey);
+			const double da0 = std::abs(dexaey) + std::abs(aexdey);
+			const double ac0 = std::abs(aexcey) + std::abs(cexaey);
+			const double bd0 = std::abs(bexdey) + std::abs(dexbey);
+			const double permanent = (cd0 * bez0 + bd0 * cez0 + bc0 * dez0) * aLift
+			                         + (da0 * cez0 + ac0 * dez0 + cd0 * aez0) * bLift
+			                         + (ab0 * dez0 + bd0 * aez0 + da0 * bez0) * cLift
+			                         + (bc0 * aez0 + ac0 * bez0 + ab0 * cez0) * dLift;
+			const double bound = InSphereErrorBound * permanent;
+			if (determinant > bound || -determinant > bound) return determinant;
+			return InSphereExact(ax, ay, az, bx, by, bz, cx, cy, cz, dx, dy, dz, ex, ey, ez);
+		}
+
+	}
+
+	/**
+	 * Exact orientation of the triangle ABC.
+	 * @return A positive value if ABC is counter-clockwise, a negative one if it is clockwise, 0 if A, B & C are collinear.
+	 */
+	template<typename T, glm::qualifier Q = glm::qualifier::defaultp>
+	[[nodiscard]] inline static double Orient2D(const glm::vec<2,T,Q>& a, const glm::vec<2,T,Q>& b, const glm::vec<2,T,Q>& c) {
+		return Predicates::Orient2D(static_cast<double>(a.x), static_cast<double>(a.y), static_cast<double>(b.x), static_cast<double>(b.y),
+		                            static_cast<double>(c.x), static_cast<double>(c.y));
+	}
+
+	/**
+	 * Exact in-circle test of the point D against the triangle ABC.
+	 * @return A positive value if D is inside the circumcircle of the counter-clockwise triangle ABC,
+	 * a negative one if D is outside, 0 if the 4 points are cocircular. The sign is reversed if ABC is clockwise.
+	 */
+	template<typename T, glm::qualifier Q = glm::qualifier::defaultp>
+	[[nodiscard]] inline static double InCircle(const glm::vec<2,T,Q>& a, const glm::vec<2,T,Q>& b, const glm::vec<2,T,Q>& c, const glm::vec<2,T,Q>& d) {
+		return Predicates::InCircle(static_cast<double>(a.x), static_cast<double>(a.y), static_cast<double>(b.x), static_cast<double>(b.y),
+		                            static_cast<double>(c.x), static_cast<double>(c.y), static_cast<double>(d.x), static_cast<double>(d.y));
+	}
+
+	/**
+	 * Exact orientation of the tetrahedron ABCD.
+	 * @return A positive value if D is below the plane of ABC, "below" being the side from which ABC is clockwise,
+	 * a negative one if D is above, 0 if the 4 points are coplanar.
+	 */
+	template<typename T, glm::qualifier Q = glm::qualifier::defaultp>
+	[[nodiscard]] inline static double Orient3D(const glm::vec<3,T,Q>& a, const glm::vec<3,T,Q>& b, const glm::vec<3,T,Q>& c, const glm::vec<3,T,Q>& d) {
+		return Predicates::Orient3D(static_cast<double>(a.x), static_cast<double>(a.y), static_cast<double>(a.z),
+		                            static_cast<double>(b.x), static_cast<double>(b.y), static_cast<double>(b.z),
+		                            static_cast<double>(c.x), static_cast<double>(c.y), static_cast<double>(c.z),
+		                            static_cast<double>(d.x), static_cast<double>(d.y), static_cast<double>(d.z));
+	}
+
+	/**
+	 * Exact in-sphere test of the point E against the tetrahedron ABCD.
+	 * @return A positive value if E is inside the circumsphere of ABCD when Orient3D(A, B, C, D) is positive,
+	 * a negative one if E is outside, 0 if the 5 points are cospherical. The sign is reversed if ABCD is negatively oriented.
+	 */
+	template<typename T, glm::qualifier Q = glm::qualifier::defaultp>
+	[[nodiscard]] inline static double InSphere(const glm::vec<3,T,Q>& a, const glm::vec<3,T,Q>& b, const glm::vec<3,T,Q>& c, const glm::vec<3,T,Q>& d, const glm::vec<3,T,Q>& e) {
+		return Predicates::InSphere(static_cast<double>(a.x), static_cast<double>(a.y), static_cast<double>(a.z),
+		                            static_cast<double>(b.x), static_cast<double>(b.y), static_cast<double>(b.z),
+		                            static_cast<double>(c.x), static_cast<double>(c.y), static_cast<double>(c.z),
+		                            static_cast<double>(d.x), static_cast<double>(d.y), static_cast<double>(d.z),
+		                            static_cast<double>(e.x), static_cast<double>(e.y), static_cast<double>(e.z));
+	}
+
+}
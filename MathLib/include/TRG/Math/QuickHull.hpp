@@ -0,0 +1,300 @@
+#pragma once
+
+#include "Basics.hpp"
+#include "FreeListVector.hpp"
+#include "Predicates.hpp"
+#include <array>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace TRG::Math {
+
+	/**
+	 * Convex hull of a 3D point cloud with the quickhull algorithm (Barber, Dobkin & Huhdanpaa).
+	 * Starting from a tetrahedron, the farthest point above a face is added, the faces it sees are removed,
+	 * and the hole is closed by a cone of faces from the point to the horizon. Each point waits in the conflict list
+	 * of one face it is above, and only the points of the removed faces are dispatched again, so it is O(n log n) on average.
+	 * The faces are triangles kept in an arena, the half-edge i of a face going from its vertex i to the next one.
+	 * Every side test is the exact Orient3D, so the hull is the exact one.
+	 */
+	class QuickHull3D {
+	public:
+		using T = Real;
+		using Vector3 = glm::vec<3, T>;
+
+	public:
+		/// Below this number of points per thread, the initial partition stays on the calling thread.
+		static constexpr uint32_t MinParallelPoints = 16384;
+
+	public:
+		/**
+		 * Compute the convex hull.
+		 * @param points The points to wrap.
+		 * @param threadCount Number of threads dispatching the points on the first faces, 1 to stay on the calling thread.
+		 * @throw std::invalid_argument If the points are all on a same plane.
+		 */
+		explicit QuickHull3D(std::vector<Vector3> points, uint32_t threadCount = 1);
+		~QuickHull3D() = default;
+
+	public:
+		[[nodiscard]] const std::vector<Vector3> &GetPoints() const { return m_Points; }
+		/// The faces of the hull, counter-clockwise seen from outside, as indices into the points.
+		[[nodiscard]] std::vector<std::array<uint32_t, 3>> GetTriangles() const;
+		/// Indices of the points that are vertices of the hull, sorted.
+		[[nodiscard]] std::vector<uint32_t> GetVertices() const;
+		/// The vertices of the faces one after the other, three per triangle, as a mesh to render.
+		[[nodiscard]] std::vector<Vector3> GetMesh() const;
+
+	private:
+		static constexpr uint32_t InvalidId = FreeListVector<int>::InvalidId;
+
+		struct Face {
+			std::array<uint32_t, 3> Vertices;
+			/// The twin half-edge of each half-edge, the half-edge i of the face f being 3 f + i.
+			std::array<uint32_t, 3> Twins{InvalidId, InvalidId, InvalidId};
+			/// The first of the points above the face, linked by m_NextOutside.
+			uint32_t FirstOutside{InvalidId};
+			uint32_t Farthest{InvalidId};
+			double FarthestDistance{0};
+			/// The last point whose visibility was tested against the face, & whether it was above.
+			uint32_t TestedPoint{InvalidId};
+			bool IsVisible{false};
+		};
+
+		/// How far above the face the point is, in an arbitrary unit per face. Positive only if the point is strictly above.
+		[[nodiscard]] double GetDistance(const Face &face, uint32_t point) const;
+		void AddOutside(uint32_t faceId, uint32_t point, double distance);
+		uint32_t AddFace(uint32_t a, uint32_t b, uint32_t c);
+		void Link(uint32_t halfEdge, uint32_t twin);
+		void BuildTetrahedron(uint32_t threadCount);
+		void AddPoint(uint32_t point, uint32_t faceId);
+
+	private:
+		std::vector<Vector3> m_Points;
+		FreeListVector<Face> m_Faces;
+		std::vector<uint32_t> m_NextOutside;
+		/// The faces that had points above them when made, some of them since removed or emptied.
+		std::vector<uint32_t> m_Pending;
+
+		// Scratch buffers of AddPoint.
+		std::vector<uint32_t> m_Visible;
+		std::vector<std::pair<uint32_t, uint32_t>> m_Horizon;
+		std::vector<uint32_t> m_NewFaces;
+		std::vector<uint32_t> m_Orphans;
+		std::vector<uint32_t> m_ConeFace;
+	};
+
+	inline QuickHull3D::QuickHull3D(std::vector<Vector3> points, const uint32_t threadCount) : m_Points(std::move(points)) {
+		m_NextOutside.assign(m_Points.size(), InvalidId);
+		m_ConeFace.assign(m_Points.size(), InvalidId);
+		BuildTetrahedron(threadCount);
+		while (!m_Pending.empty()) {
+			const uint32_t faceId = m_Pending.back();
+			m_Pending.pop_back();
+			if (!m_Faces.contains(faceId) || m_Faces[faceId].FirstOutside == InvalidId) continue;
+			AddPoint(m_Faces[faceId].Farthest, faceId);
+		}
+	}
+
+	inline std::vector<std::array<uint32_t, 3>> QuickHull3D::GetTriangles() const {
+		std::vector<std::array<uint32_t, 3>> triangles;
+		triangles.reserve(m_Faces.size());
+		for (const auto &[id, face]: m_Faces) triangles.push_back(face.Vertices);
+		return triangles;
+	}
+
+	inline std::vector<uint32_t> QuickHull3D::GetVertices() const {
+		std::vector<bool> isVertex(m_Points.size(), false);
+		for (const auto &[id, face]: m_Faces) {
+			for (const uint32_t vertex: face.Vertices) isVertex[vertex] = true;
+		}
+		std::vector<uint32_t> vertices;
+		for (uint32_t i = 0; i < isVertex.size(); ++i) {
+			if (isVertex[i]) vertices.push_back(i);
+		}
+		return vertices;
+	}
+
+	inline std::vector<QuickHull3D::Vector3> QuickHull3D::GetMesh() const {
+		std::vector<Vector3> mesh;
+		mesh.reserve(m_Faces.size() * 3);
+		for (const auto &[id, face]: m_Faces) {
+			for (const uint32_t vertex: face.Vertices) mesh.push_back(m_Points[vertex]);
+		}
+		return mesh;
+	}
+
+	inline double QuickHull3D::GetDistance(const Face &face, const uint32_t point) const {
+		return -Orient3D(m_Points[face.Vertices[0]], m_Points[face.Vertices[1]], m_Points[face.Vertices[2]], m_Points[point]);
+	}
+
+	inline void QuickHull3D::AddOutside(const uint32_t faceId, const uint32_t point, const double distance) {
+		Face &face = m_Faces[faceId];
+		if (face.FirstOutside == InvalidId) m_Pending.push_back(faceId);
+		m_NextOutside[point] = face.FirstOutside;
+		face.FirstOutside = point;
+		if (face.Farthest == InvalidId || distance > face.FarthestDistance) {
+			face.Farthest = point;
+			face.FarthestDistance = distance;
+		}
+	}
+
+	inline uint32_t QuickHull3D::AddFace(const uint32_t a, const uint32_t b, const uint32_t c) {
+		return m_Faces.emplace(Face{.Vertices = {a, b, c}});
+	}
+
+	inline void QuickHull3D::Link(const uint32_t halfEdge, const uint32_t twin) {
+		m_Faces[halfEdge / 3].Twins[halfEdge % 3] = twin;
+		m_Faces[twin / 3].Twins[twin % 3] = halfEdge;
+	}
+
+	/**
+	 * Find four points far apart & not on a same plane, make their tetrahedron and dispatch the other points above its faces.
+	 */
+	inline void QuickHull3D::BuildTetrahedron(const uint32_t threadCount) {
+		const auto count = static_cast<uint32_t>(m_Points.size());
+		if (count < 4) throw std::invalid_argument("QuickHull3D: at least four points not on a same plane are needed");
+		const auto findBest = [count](const auto &score) {
+			uint32_t best = 0;
+			double bestScore = score(0);
+			for (uint32_t i = 1; i < count; ++i) {
+				const double value = score(i);
+				if (value > bestScore) {
+					best = i;
+					bestScore = value;
+				}
+			}
+			return std::pair{best, bestScore};
+		};
+
+		// The extremes along x, the farthest point from their line, and the farthest one from their plane.
+		const uint32_t a = findBest([this](const uint32_t i) { return -static_cast<double>(m_Points[i].x); }).first;
+		const auto [b, length] = findBest([this, a](const uint32_t i) {
+			const glm::vec<3, double> ai = glm::vec<3, double>(m_Points[i]) - glm::vec<3, double>(m_Points[a]);
+			return glm::dot(ai, ai);
+		});
+		if (length == 0) throw std::invalid_argument("QuickHull3D: at least four points not on a same plane are needed");
+		const glm::vec<3, double> ab = glm::vec<3, double>(m_Points[b]) - glm::vec<3, double>(m_Points[a]);
+		uint32_t c = findBest([this, a, &ab](const uint32_t i) {
+			const glm::vec<3, double> normal = glm::cross(ab, glm::vec<3, double>(m_Points[i]) - glm::vec<3, double>(m_Points[a]));
+			return glm::dot(normal, normal);
+		}).first;
+		const auto isCollinear = [this, a, b](const uint32_t i) {
+			const auto project = [](const Vector3 &p, const int u, const int v) { return glm::vec<2, T>(p[u], p[v]); };
+			for (const auto &[u, v]: {std::pair{0, 1}, std::pair{1, 2}, std::pair{2, 0}}) {
+				if (Orient2D(project(m_Points[a], u, v), project(m_Points[b], u, v), project(m_Points[i], u, v)) != 0) return false;
+			}
+			return true;
+		};
+		// The rounding of the distance can hide a point barely off the line.
+		if (isCollinear(c)) {
+			c = 0;
+			while (c < count && isCollinear(c)) ++c;
+			if (c == count) throw std::invalid_argument("QuickHull3D: at least four points not on a same plane are needed");
+		}
+		const auto [d, height] = findBest([this, a, b, c](const uint32_t i) { return std::abs(Orient3D(m_Points[a], m_Points[b], m_Points[c], m_Points[i])); });
+		if (height == 0) throw std::invalid_argument("QuickHull3D: at least four points not on a same plane are needed");
+
+		// The faces are counter-clockwise seen from outside, so the fourth point is below the first face.
+		const auto [v0, v1, v2, v3] = Orient3D(m_Points[a], m_Points[b], m_Points[c], m_Points[d]) > 0 ? std::array{a, b, c, d} : std::array{b, a, c, d};
+		const std::array faces{AddFace(v0, v1, v2), AddFace(v0, v3, v1), AddFace(v1, v3, v2), AddFace(v2, v3, v0)};
+		// Each edge is shared by two faces going along it in opposite directions.
+		for (uint32_t i = 0; i < 12; ++i) {
+			for (uint32_t j = i + 1; j < 12; ++j) {
+				const Face &fi = m_Faces[faces[i / 3]];
+				const Face &fj = m_Faces[faces[j / 3]];
+				if (fi.Vertices[i % 3] == fj.Vertices[(j + 1) % 3] && fi.Vertices[(i + 1) % 3] == fj.Vertices[j % 3]) {
+					Link(3 * faces[i / 3] + i % 3, 3 * faces[j / 3] + j % 3);
+				}
+			}
+		}
+
+		// Each point goes above the first face it is above, the points below them all being inside the tetrahedron.
+		std::vector<uint8_t> owners(count);
+		std::vector<double> distances(count);
+		const auto dispatch = [&](const uint32_t begin, const uint32_t end) {
+			for (uint32_t i = begin; i < end; ++i) {
+				owners[i] = 4;
+				if (i == v0 || i == v1 || i == v2 || i == v3) continue;
+				for (uint8_t f = 0; f < 4; ++f) {
+					const double distance = GetDistance(m_Faces[faces[f]], i);
+					if (distance > 0) {
+						owners[i] = f;
+						distances[i] = distance;
+						break;
+					}
+				}
+			}
+		};
+		const uint32_t workerCount = std::clamp(threadCount, 1u, std::max(1u, count / MinParallelPoints));
+		std::vector<std::thread> workers;
+		for (uint32_t worker = 1; worker < workerCount; ++worker) {
+			workers.emplace_back(dispatch, static_cast<uint32_t>(uint64_t{count} * worker / workerCount), static_cast<uint32_t>(uint64_t{count} * (worker + 1) / workerCount));
+		}
+		dispatch(0, count / workerCount);
+		for (std::thread &worker: workers) worker.join();
+		for (uint32_t i = 0; i < count; ++i) {
+			if (owners[i] < 4) AddOutside(faces[owners[i]], i, distances[i]);
+		}
+	}
+
+	/**
+	 * Add the point to the hull, it being above the face.
+	 */
+	inline void QuickHull3D::AddPoint(const uint32_t point, const uint32_t faceId) {
+		// The faces seen from the point are connected, their edges toward the other faces make the horizon.
+		m_Visible.assign({faceId});
+		m_Horizon.clear();
+		m_Faces[faceId].TestedPoint = point;
+		m_Faces[faceId].IsVisible = true;
+		for (size_t i = 0; i < m_Visible.size(); ++i) {
+			const uint32_t visibleId = m_Visible[i];
+			for (uint32_t edge = 0; edge < 3; ++edge) {
+				const uint32_t twin = m_Faces[visibleId].Twins[edge];
+				Face &neighbour = m_Faces[twin / 3];
+				if (neighbour.TestedPoint != point) {
+					neighbour.TestedPoint = point;
+					neighbour.IsVisible = GetDistance(neighbour, point) > 0;
+					if (neighbour.IsVisible) m_Visible.push_back(twin / 3);
+				}
+				if (!neighbour.IsVisible) m_Horizon.emplace_back(3 * visibleId + edge, twin);
+			}
+		}
+
+		// The cone from the point to the horizon, each face starting on a vertex of the horizon, that loop being simple.
+		m_NewFaces.clear();
+		for (const auto &[halfEdge, twin]: m_Horizon) {
+			const std::array<uint32_t, 3> &vertices = m_Faces[halfEdge / 3].Vertices;
+			const uint32_t a = vertices[halfEdge % 3];
+			const uint32_t b = vertices[(halfEdge + 1) % 3];
+			const uint32_t newId = AddFace(a, b, point);
+			Link(3 * newId, twin);
+			m_ConeFace[a] = newId;
+			m_NewFaces.push_back(newId);
+		}
+		for (const uint32_t newId: m_NewFaces) {
+			const uint32_t b = m_Faces[newId].Vertices[1];
+			Link(3 * newId + 1, 3 * m_ConeFace[b] + 2);
+		}
+
+		// The points above the removed faces are either above a new face or inside the hull.
+		m_Orphans.clear();
+		for (const uint32_t visibleId: m_Visible) {
+			for (uint32_t p = m_Faces[visibleId].FirstOutside; p != InvalidId; p = m_NextOutside[p]) {
+				if (p != point) m_Orphans.push_back(p);
+			}
+			m_Faces.erase(visibleId);
+		}
+		for (const uint32_t orphan: m_Orphans) {
+			for (const uint32_t newId: m_NewFaces) {
+				const double distance = GetDistance(m_Faces[newId], orphan);
+				if (distance > 0) {
+					AddOutside(newId, orphan, distance);
+					break;
+				}
+			}
+		}
+	}
+
+}
@@ -7,97 +7,300 @@
 
 #include "Basics.hpp"
 #include "Geometry.hpp"
+#include "Predicates.hpp"
+#include <array>
+#include <limits>
+#include <list>
+#include <numeric>
+#include <span>
+#include <thread>
+#include <vector>
 
 namespace TRG::Math {
-	template<typename Iter, typename T = Real, glm::qualifier Q = glm::qualifier::defaultp>
-	std::vector<glm::vec<2, T, Q> > JarvisConvexShell(Iter begin, Iter end) {
-		if (begin == end) return {};
-		std::vector<glm::vec<2, T, Q> > shell;
-		uint64_t count{0};
-		glm::vec<2, T, Q> first = *begin;
-		for (auto it = begin; it != end; ++it) {
-			const glm::vec<2, T, Q> &p = *it;
-			++count;
-			if (p.x < first.x) {
-				first = p;
-			} else if (p.x == first.x && p.y < first.y) {
-				first = p;
+
+	namespace Shells {
+		/**
+		 * Write the convex hull of items sorted by the x then y of their point, counter-clockwise from the first one.
+		 * The points in the middle of an edge of the hull & the duplicates are left out.
+		 */
+		template<typename Item, typename GetPoint>
+		void SortedMonotoneChain(const std::span<const Item> sorted, std::vector<Item> &hull, const GetPoint &getPoint) {
+			hull.clear();
+			for (const Item &item: sorted) {
+				if (!hull.empty() && getPoint(hull.back()) == getPoint(item)) continue;
+				while (hull.size() >= 2 && Orient2D(getPoint(hull[hull.size() - 2]), getPoint(hull.back()), getPoint(item)) <= 0) hull.pop_back();
+				hull.push_back(item);
 			}
+			if (hull.size() < 2) return;
+			const size_t lowerSize = hull.size();
+			for (auto it = sorted.rbegin() + 1; it != sorted.rend(); ++it) {
+				if (getPoint(hull.back()) == getPoint(*it)) continue;
+				while (hull.size() > lowerSize && Orient2D(getPoint(hull[hull.size() - 2]), getPoint(hull.back()), getPoint(*it)) <= 0) hull.pop_back();
+				hull.push_back(*it);
+			}
+			// The upper chain ends on the first point.
+			hull.pop_back();
+		}
+
+		/**
+		 * Sort the points by x then y, and write their convex hull counter-clockwise from the lowest of the leftmost points.
+		 */
+		template<typename T, glm::qualifier Q>
+		void MonotoneChain(std::span<glm::vec<2, T, Q>> points, std::vector<glm::vec<2, T, Q>> &hull) {
+			std::sort(points.begin(), points.end(), [](const glm::vec<2, T, Q> &a, const glm::vec<2, T, Q> &b) {
+				return a.x < b.x || (a.x == b.x && a.y < b.y);
+			});
+			SortedMonotoneChain<glm::vec<2, T, Q>>(points, hull, [](const glm::vec<2, T, Q> &p) -> const glm::vec<2, T, Q> & { return p; });
 		}
 
-		glm::vec<2, T, Q> current = first;
-		glm::vec<2, T, Q> next = first;
-		glm::vec<2, T, Q> direction = {0, 1};
-		shell.push_back(first);
-
-		for (int i = 0; i < count * count; ++i) {
-			next = *std::min_element(begin, end, [direction, current](const glm::vec<2, T, Q> &a, const glm::vec<2, T, Q> &b) {
-					if (a == current) return false;
-					if (b == current) return true;
-					const auto cToA = a - current;
-					const auto cToB = b - current;
-					const auto angleA = Math::SignedAngle(direction, cToA);
-					const auto angleB = Math::SignedAngle(direction, cToB);
-					if (angleA == angleB) {
-						return Math::Magnitude(cToA) > Math::Magnitude(cToB);
+		/**
+		 * Find the vertex of a counter-clockwise convex hull such that the whole hull is on the left of the line from the point to it,
+		 * the farthest one when several are on that line. The point must be outside of the hull or one of its vertices.
+		 * @return The index of the vertex, or the size of the hull if all its vertices are the point.
+		 */
+		template<typename T, glm::qualifier Q>
+		[[nodiscard]] size_t RightTangent(const std::span<const glm::vec<2, T, Q>> hull, const glm::vec<2, T, Q> &p) {
+			const size_t count = hull.size();
+			const auto isBetter = [&hull, &p](const size_t candidate, const size_t best) {
+				const double orientation = Orient2D(p, hull[best], hull[candidate]);
+				return orientation < 0 || (orientation == 0 && Distance2(p, hull[candidate]) > Distance2(p, hull[best]));
+			};
+			const auto linearSearch = [&]() {
+				size_t best = count;
+				for (size_t i = 0; i < count; ++i) {
+					if (hull[i] != p && (best == count || isBetter(i, best))) best = i;
+				}
+				return best;
+			};
+			if (count <= 8) return linearSearch();
+
+			// Seen from the point, the angle of the vertices goes up from the tangent to the opposite one & back down.
+			// The first vertex tells on which side of that cycle the search starts.
+			const auto isRising = [&hull, &p, count](const size_t i) { return Orient2D(p, hull[i], hull[(i + 1) % count]) > 0; };
+			const auto isAboveFirst = [&hull, &p](const size_t i) { return Orient2D(p, hull[0], hull[i]) > 0; };
+			const bool firstIsRising = isRising(0);
+			size_t low = 0, high = count;
+			while (low < high) {
+				const size_t middle = (low + high) / 2;
+				const bool after = firstIsRising ? !isRising(middle) || isAboveFirst(middle) : !isRising(middle) && !isAboveFirst(middle);
+				if (after) low = middle + 1;
+				else high = middle;
+			}
+			size_t tangent = low % count;
+
+			// A point on the hull, or in line with a vertex & the next one, can mislead the search.
+			const size_t next = (tangent + 1) % count;
+			const size_t previous = (tangent + count - 1) % count;
+			const double nextOrientation = Orient2D(p, hull[tangent], hull[next]);
+			const double previousOrientation = Orient2D(p, hull[tangent], hull[previous]);
+			if (hull[tangent] == p || nextOrientation < 0 || previousOrientation < 0) return linearSearch();
+			if (nextOrientation == 0 && Distance2(p, hull[next]) > Distance2(p, hull[tangent])) tangent = next;
+			else if (previousOrientation == 0 && Distance2(p, hull[previous]) > Distance2(p, hull[tangent])) tangent = previous;
+			return tangent;
+		}
+
+		/**
+		 * Wrap a gift around convex hulls stored one after the other, the hull g going from offsets[g] to offsets[g + 1].
+		 * Each hull must be counter-clockwise from the lowest of its leftmost points, like MonotoneChain writes them.
+		 * @return Whether the shell closed in at most maxSteps steps.
+		 */
+		template<typename T, glm::qualifier Q>
+		bool WrapHulls(const std::span<const glm::vec<2, T, Q>> hulls, const std::span<const size_t> offsets, const size_t maxSteps, std::vector<glm::vec<2, T, Q>> &shell) {
+			using Vector2 = glm::vec<2, T, Q>;
+			const size_t groupCount = offsets.size() - 1;
+			const auto getHull = [&hulls, &offsets](const size_t g) {
+				return hulls.subspan(offsets[g], offsets[g + 1] - offsets[g]);
+			};
+			size_t startGroup = groupCount;
+			for (size_t g = 0; g < groupCount; ++g) {
+				if (offsets[g] == offsets[g + 1]) continue;
+				if (startGroup == groupCount) {
+					startGroup = g;
+					continue;
+				}
+				const Vector2 &a = hulls[offsets[g]];
+				const Vector2 &b = hulls[offsets[startGroup]];
+				if (a.x < b.x || (a.x == b.x && a.y < b.y)) startGroup = g;
+			}
+			shell.clear();
+			if (startGroup == groupCount) return true;
+
+			const Vector2 start = hulls[offsets[startGroup]];
+			shell.push_back(start);
+			size_t group = startGroup;
+			size_t index = 0;
+			for (size_t step = 0; step < maxSteps; ++step) {
+				const Vector2 p = getHull(group)[index];
+				// In its own group, the point is a vertex whose tangent is the next one.
+				size_t bestGroup = group;
+				size_t bestIndex = (index + 1) % getHull(group).size();
+				for (size_t g = 0; g < groupCount; ++g) {
+					if (g == group) continue;
+					const std::span<const Vector2> other = getHull(g);
+					const size_t i = RightTangent(other, p);
+					if (i == other.size()) continue;
+					const Vector2 &best = getHull(bestGroup)[bestIndex];
+					const Vector2 &candidate = other[i];
+					const double orientation = Orient2D(p, best, candidate);
+					if (best == p || orientation < 0 || (orientation == 0 && Distance2(p, candidate) > Distance2(p, best))) {
+						bestGroup = g;
+						bestIndex = i;
 					}
-					return angleA < angleB;
 				}
-			);
+				const Vector2 &next = getHull(bestGroup)[bestIndex];
+				if (next == p || next == start) return true;
+				shell.push_back(next);
+				group = bestGroup;
+				index = bestIndex;
+			}
+			return false;
+		}
+	}
+
+	/**
+	 * Calculate the convex hull of the points with Chan's algorithm, in O(n log h) for a hull of h vertices.
+	 * The points are split in groups of m points whose hulls are wrapped together, each step finding the tangent of every group
+	 * in O(log m). The wrap gives up after m steps, & starts again with m squared until the hull closes.
+	 * @return The vertices of the hull counter-clockwise, from the lowest of the leftmost points, without the points in the middle of an edge.
+	 */
+	template<typename Iter, typename T = Real, glm::qualifier Q = glm::qualifier::defaultp>
+	std::vector<glm::vec<2, T, Q> > JarvisConvexShell(Iter begin, Iter end) {
+		using Vector2 = glm::vec<2, T, Q>;
+		std::vector<Vector2> points(begin, end);
+		if (points.empty()) return {};
+		const size_t count = points.size();
 
-			if (next == first) {
-				break;
+		// The hulls of the groups one after the other.
+		std::vector<Vector2> hulls;
+		std::vector<size_t> offsets;
+		std::vector<Vector2> hull;
+		std::vector<Vector2> shell;
+		// The smallest groups cost more to go through than they save on the sorts.
+		for (size_t groupSize = std::min<size_t>(count, 64);; groupSize = groupSize >= (size_t{1} << 32) ? count : std::min(count, groupSize * groupSize)) {
+			const size_t groupCount = (count + groupSize - 1) / groupSize;
+			hulls.clear();
+			offsets.assign({0});
+			for (size_t g = 0; g < groupCount; ++g) {
+				const size_t first = g * groupSize;
+				Shells::MonotoneChain(std::span<Vector2>{points.data() + first, std::min(groupSize, count - first)}, hull);
+				hulls.insert(hulls.end(), hull.begin(), hull.end());
+				offsets.push_back(hulls.size());
 			}
-			shell.push_back(next);
-			direction = next - current;
-			current = next;
+			if (Shells::WrapHulls<T, Q>(hulls, offsets, groupSize, shell)) return shell;
 		}
+	}
+
+	/**
+	 * Calculate the convex hull of the points with Andrew's monotone chain, in O(n log n).
+	 * The points are sorted by x then y, the lower chain is built from left to right on a stack & the upper one back from right to left.
+	 * @return The vertices of the hull counter-clockwise, from the lowest of the leftmost points, without the points in the middle of an edge.
+	 */
+	template<typename Iter, typename T = Real, glm::qualifier Q = glm::qualifier::defaultp>
+	std::vector<glm::vec<2, T, Q> > MonotoneChainConvexShell(Iter begin, Iter end) {
+		std::vector<glm::vec<2, T, Q>> points(begin, end);
+		std::vector<glm::vec<2, T, Q>> shell;
+		shell.reserve(points.size() + 1);
+		Shells::MonotoneChain(std::span<glm::vec<2, T, Q>>{points}, shell);
+		return shell;
+	}
 
+	/**
+	 * Calculate the convex hull of the points with Andrew's monotone chain, like MonotoneChainConvexShell.
+	 * @return The indices of the vertices of the hull in the points, counter-clockwise from the lowest of the leftmost points.
+	 * Of duplicated points, the first one is kept.
+	 */
+	template<typename T = Real, glm::qualifier Q = glm::qualifier::defaultp>
+	std::vector<uint32_t> MonotoneChainConvexShellIndices(const std::vector<glm::vec<2, T, Q>> &points) {
+		std::vector<uint32_t> order(points.size());
+		std::iota(order.begin(), order.end(), 0);
+		std::sort(order.begin(), order.end(), [&points](const uint32_t a, const uint32_t b) {
+			const glm::vec<2, T, Q> &pa = points[a];
+			const glm::vec<2, T, Q> &pb = points[b];
+			return pa.x < pb.x || (pa.x == pb.x && (pa.y < pb.y || (pa.y == pb.y && a < b)));
+		});
+		// The duplicates are next to each other, by increasing index.
+		order.erase(std::unique(order.begin(), order.end(), [&points](const uint32_t a, const uint32_t b) { return points[a] == points[b]; }), order.end());
+		std::vector<uint32_t> shell;
+		shell.reserve(points.size() + 1);
+		Shells::SortedMonotoneChain<uint32_t>(order, shell, [&points](const uint32_t i) -> const glm::vec<2, T, Q> & { return points[i]; });
 		return shell;
 	}
 
+	/**
+	 * Calculate the convex hull of the points on several threads.
+	 * The points strictly inside the octagon of the extreme points in eight directions are thrown away (Akl–Toussaint),
+	 * then each thread computes the monotone chain hull of its share of the rest, & the hulls are merged by wrapping them with tangents.
+	 * @return The vertices of the hull counter-clockwise, from the lowest of the leftmost points, without the points in the middle of an edge.
+	 */
 	template<typename Iter, typename T = Real, glm::qualifier Q = glm::qualifier::defaultp>
-	std::list<glm::vec<2, T, Q>> GrahamScanConvexShell(Iter begin, Iter end) {
-		if (begin == end) return {};
-		using List = std::list<glm::vec<2, T, Q>>;
-		using ListIter = typename List::iterator;
-		List shell(begin, end);
-
-		glm::vec<2, T, Q> center = Math::CalculateCenter<Iter, 2>(begin, end);
-
-		shell.sort([center](const glm::vec<2, T, Q>& a, const glm::vec<2, T, Q>& b) {
-			const glm::vec<2, T, Q> cToA = a - center;
-			const glm::vec<2, T, Q> cToB = b - center;
-			const T angleA = Math::SignedAngle(glm::vec<2, T, Q>{1,0}, cToA);
-			const T angleB = Math::SignedAngle(glm::vec<2, T, Q>{1,0}, cToB);
-			if (angleA == angleB) {
-				return Math::Magnitude(cToA) < Math::Magnitude(cToB);
+	std::vector<glm::vec<2, T, Q> > ParallelConvexShell(Iter begin, Iter end, const uint32_t threadCount = std::max(1u, std::thread::hardware_concurrency())) {
+		using Vector2 = glm::vec<2, T, Q>;
+		std::vector<Vector2> points(begin, end);
+		const size_t count = points.size();
+		const auto workerCount = static_cast<uint32_t>(std::clamp<size_t>(threadCount, 1, std::max<size_t>(1, count / 16384)));
+		if (workerCount == 1) return MonotoneChainConvexShell<typename std::vector<Vector2>::const_iterator, T, Q>(points.cbegin(), points.cend());
+
+		const auto getBegin = [count, workerCount](const uint32_t worker) { return count * worker / workerCount; };
+		const auto runWorkers = [workerCount](const auto &task) {
+			std::vector<std::thread> workers;
+			for (uint32_t worker = 1; worker < workerCount; ++worker) workers.emplace_back(task, worker);
+			task(0u);
+			for (std::thread &worker: workers) worker.join();
+		};
+
+		// The extreme points going counter-clockwise from the left, each one the farthest along its direction.
+		constexpr std::array<glm::vec<2, T, Q>, 8> directions{{{-1, 0}, {-1, -1}, {0, -1}, {1, -1}, {1, 0}, {1, 1}, {0, 1}, {-1, 1}}};
+		std::vector<std::array<size_t, 8>> extremes(workerCount);
+		runWorkers([&](const uint32_t worker) {
+			std::array<size_t, 8> &extreme = extremes[worker];
+			extreme.fill(getBegin(worker));
+			for (size_t i = getBegin(worker) + 1; i < getBegin(worker + 1); ++i) {
+				for (size_t d = 0; d < directions.size(); ++d) {
+					if (glm::dot(directions[d], points[i]) > glm::dot(directions[d], points[extreme[d]])) extreme[d] = i;
+				}
 			}
-			return angleA < angleB;
 		});
-
-		ListIter sInit = shell.begin();
-		ListIter pivot = sInit;
-		bool advance = false;
-		do {
-			ListIter prev = pivot == shell.begin() ? shell.end(): pivot;
-			--prev;
-			ListIter next = pivot;
-			++next;
-			if (next == shell.end()) next = shell.begin();
-
-			if (Math::IsTriangleOriented(*prev, *pivot, *next)) {
-				pivot = next;
-				advance = true;
-			} else {
-				sInit = prev;
-				shell.erase(pivot);
-				pivot = sInit;
-				advance = false;
+		std::vector<Vector2> octagon;
+		for (size_t d = 0; d < directions.size(); ++d) {
+			size_t best = extremes[0][d];
+			for (uint32_t worker = 1; worker < workerCount; ++worker) {
+				if (glm::dot(directions[d], points[extremes[worker][d]]) > glm::dot(directions[d], points[best])) best = extremes[worker][d];
+			}
+			if (octagon.empty() || octagon.back() != points[best]) octagon.push_back(points[best]);
+		}
+		while (octagon.size() > 1 && octagon.back() == octagon.front()) octagon.pop_back();
+		const auto isInside = [&octagon](const Vector2 &p) {
+			for (size_t i = 0; i < octagon.size(); ++i) {
+				if (Orient2D(octagon[i], octagon[(i + 1) % octagon.size()], p) <= 0) return false;
 			}
-		} while ((pivot != sInit || advance == false) && !shell.empty());
+			return true;
+		};
+
+		std::vector<std::vector<Vector2>> chunkHulls(workerCount);
+		runWorkers([&](const uint32_t worker) {
+			const auto first = points.begin() + static_cast<std::ptrdiff_t>(getBegin(worker));
+			const auto kept = std::partition(first, points.begin() + static_cast<std::ptrdiff_t>(getBegin(worker + 1)), [&isInside](const Vector2 &p) { return !isInside(p); });
+			Shells::MonotoneChain(std::span<Vector2>{first, kept}, chunkHulls[worker]);
+		});
 
-		// return std::list<glm::vec<2, T, Q>>(shell.begin(), shell.end());
+		std::vector<Vector2> hulls;
+		std::vector<size_t> offsets{0};
+		for (const std::vector<Vector2> &hull: chunkHulls) {
+			hulls.insert(hulls.end(), hull.begin(), hull.end());
+			offsets.push_back(hulls.size());
+		}
+		std::vector<Vector2> shell;
+		Shells::WrapHulls<T, Q>(hulls, offsets, std::numeric_limits<size_t>::max(), shell);
 		return shell;
 	}
+
+	/**
+	 * Calculate the convex hull of the points, counter-clockwise.
+	 * Kept for the callers wanting a list, the hull comes from MonotoneChainConvexShell.
+	 */
+	template<typename Iter, typename T = Real, glm::qualifier Q = glm::qualifier::defaultp>
+	std::list<glm::vec<2, T, Q>> GrahamScanConvexShell(Iter begin, Iter end) {
+		const std::vector<glm::vec<2, T, Q>> shell = MonotoneChainConvexShell<Iter, T, Q>(begin, end);
+		return std::list<glm::vec<2, T, Q>>(shell.begin(), shell.end());
+	}
 }
@@ -0,0 +1,152 @@
+#pragma once
+
+#include "Basics.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <iterator>
+#include <numeric>
+#include <random>
+#include <utility>
+
+namespace TRG::Math {
+
+	/**
+	 * Calculate the distance along a Hilbert curve of the cell (x, y) of a 2^order x 2^order grid.
+	 * @param x Column of the cell, in [0, 2^order[.
+	 * @param y Row of the cell, in [0, 2^order[.
+	 * @param order Number of subdivisions of the grid (max 31).
+	 * @return Index of the cell along the curve, in [0, 4^order[.
+	 */
+	[[nodiscard]] inline uint64_t HilbertIndex(uint32_t x, uint32_t y, const uint32_t order = 16) {
+		const uint32_t n = 1u << order;
+		uint64_t index = 0;
+		for (uint32_t s = n >> 1; s > 0; s >>= 1) {
+			const uint32_t rx = (x & s) > 0 ? 1 : 0;
+			const uint32_t ry = (y & s) > 0 ? 1 : 0;
+			index += static_cast<uint64_t>(s) * static_cast<uint64_t>(s) * ((3 * rx) ^ ry);
+			// Rotate the quadrant so the sub-curve is in the right direction.
+			if (ry == 0) {
+				if (rx == 1) {
+					x = n - 1 - x;
+					y = n - 1 - y;
+				}
+				std::swap(x, y);
+			}
+		}
+		return index;
+	}
+
+	/**
+	 * Calculate the distance along a 3D Hilbert curve of the cell (x, y, z) of a 2^order x 2^order x 2^order grid,
+	 * with the transposed index of "Programming the Hilbert curve" (J. Skilling).
+	 * @param order Number of subdivisions of the grid (max 21).
+	 * @return Index of the cell along the curve, in [0, 8^order[.
+	 */
+	[[nodiscard]] inline uint64_t HilbertIndex3D(const uint32_t x, const uint32_t y, const uint32_t z, const uint32_t order = 21) {
+		std::array<uint32_t, 3> axes{x, y, z};
+		const uint32_t top = 1u << (order - 1);
+		for (uint32_t q = top; q > 1; q >>= 1) {
+			const uint32_t mask = q - 1;
+			for (uint32_t &axis: axes) {
+				if (axis & q) {
+					axes[0] ^= mask;
+				} else {
+					const uint32_t swapped = (axes[0] ^ axis) & mask;
+					axes[0] ^= swapped;
+					axis ^= swapped;
+				}
+			}
+		}
+		axes[1] ^= axes[0];
+		axes[2] ^= axes[1];
+		uint32_t gray = 0;
+		for (uint32_t q = top; q > 1; q >>= 1) {
+			if (axes[2] & q) gray ^= q - 1;
+		}
+		for (uint32_t &axis: axes) axis ^= gray;
+
+		// The transposed index has the bits of the index spread over the 3 axes.
+		uint64_t index = 0;
+		for (uint32_t bit = order; bit-- > 0;) {
+			for (const uint32_t axis: axes) index = (index << 1) | ((axis >> bit) & 1u);
+		}
+		return index;
+	}
+
+	/**
+	 * Calculate the Hilbert index of each point, in a grid fitting the bounding box of the points:
+	 * 2^16 x 2^16 for the 2D points, 2^21 x 2^21 x 2^21 for the 3D ones.
+	 */
+	template<typename Iter, typename T = Real, glm::qualifier Q = glm::qualifier::defaultp, glm::length_t L = std::iter_value_t<Iter>::length()>
+	[[nodiscard]] std::vector<uint64_t> HilbertIndices(const Iter begin, const Iter end) {
+		static_assert(L == 2 || L == 3, "HilbertIndices: only 2D & 3D points are supported");
+		std::vector<uint64_t> indices;
+		if (begin == end) return indices;
+
+		glm::vec<L, T, Q> min = *begin;
+		glm::vec<L, T, Q> max = *begin;
+		for (auto it = begin; it != end; ++it) {
+			const glm::vec<L, T, Q> &p = *it;
+			min = glm::min(min, p);
+			max = glm::max(max, p);
+		}
+
+		constexpr uint32_t order = L == 2 ? 16 : 21;
+		constexpr T cellCount = static_cast<T>((1u << order) - 1);
+		T size = 0;
+		for (glm::length_t i = 0; i < L; ++i) size = std::max(size, max[i] - min[i]);
+		const T scale = size > 0 ? cellCount / size : static_cast<T>(0);
+
+		for (auto it = begin; it != end; ++it) {
+			const glm::vec<L, T, Q> &p = *it;
+			std::array<uint32_t, L> cell;
+			for (glm::length_t i = 0; i < L; ++i) cell[i] = static_cast<uint32_t>(std::clamp((p[i] - min[i]) * scale, static_cast<T>(0), cellCount));
+			if constexpr (L == 2) indices.push_back(HilbertIndex(cell[0], cell[1], order));
+			else indices.push_back(HilbertIndex3D(cell[0], cell[1], cell[2], order));
+		}
+		return indices;
+	}
+
+	/**
+	 * Randomly assign each of the points to a round of a Biased Randomized Insertion Order (BRIO),
+	 * the last round taking half of the points, the one before a quarter, etc.
+	 * @param seed Seed of the random rounds, the rounds are deterministic for a given seed.
+	 * @return The round of each point, from 0 to the number of bits of the point count.
+	 */
+	[[nodiscard]] inline std::vector<uint32_t> BrioRounds(const uint32_t count, const uint32_t seed = 0x5EED) {
+		const uint32_t lastRound = std::max(1u, static_cast<uint32_t>(std::bit_width(count)));
+		std::mt19937 random(seed);
+
+		std::vector<uint32_t> rounds(count);
+		for (uint32_t &round: rounds) {
+			// Each trailing zero has a probability of 1/2, so every round is twice the size of the one before.
+			const auto zeros = static_cast<uint32_t>(std::countr_zero(static_cast<uint32_t>(random())));
+			round = lastRound - std::min(zeros, lastRound);
+		}
+		return rounds;
+	}
+
+	/**
+	 * Calculate a Biased Randomized Insertion Order (BRIO) of the points, with the rounds of `BrioRounds`.
+	 * The rounds are inserted one after the other, and the points of a round are sorted along a Hilbert curve,
+	 * so the insertion keeps the randomization guarantees while staying spatially coherent.
+	 * @param seed Seed of the random rounds, the order is deterministic for a given seed.
+	 * @return The indices of the points in their insertion order.
+	 */
+	template<typename Iter, typename T = Real, glm::qualifier Q = glm::qualifier::defaultp, glm::length_t L = std::iter_value_t<Iter>::length()>
+	[[nodiscard]] std::vector<uint32_t> BrioOrder(const Iter begin, const Iter end, const uint32_t seed = 0x5EED) {
+		const std::vector<uint64_t> hilbert = HilbertIndices<Iter, T, Q, L>(begin, end);
+		const auto count = static_cast<uint32_t>(hilbert.size());
+		const std::vector<uint32_t> rounds = BrioRounds(count, seed);
+
+		// The 3D Hilbert indices take up to 63 bits, the round is a separate key.
+		std::vector<uint32_t> order(count);
+		std::iota(order.begin(), order.end(), 0u);
+		std::sort(order.begin(), order.end(), [&rounds, &hilbert](const uint32_t a, const uint32_t b) {
+			return std::pair{rounds[a], hilbert[a]} < std::pair{rounds[b], hilbert[b]};
+		});
+		return order;
+	}
+
+}
@@ -0,0 +1,462 @@
+#pragma once
+
+#include "Basics.hpp"
+#include "FreeListVector.hpp"
+#include "Geometry.hpp"
+#include "Predicates.hpp"
+#include "SpatialSort.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <vector>
+
+namespace TRG::Math {
+
+	/**
+	 * Delaunay tetrahedralization of 3D points, the tetrahedral counterpart of the MeshGraph, built by Bowyer-Watson insertions:
+	 * the tetrahedra whose circumsphere contains the new point are removed, and the cavity is filled by joining its boundary to the point.
+	 * The faces of the convex hull are closed by ghost tetrahedra sharing a vertex at infinity, so a point outside the hull
+	 * is inserted like any other one, its cavity holding the ghosts of the hull faces it sees.
+	 * A tetrahedron is only its 4 vertices & its 4 neighbours, 32 bytes (36 with the id of the free list),
+	 * and the neighbour of the face i is stored as 4 * neighbour + the index of the same face in the neighbour.
+	 */
+	class DelaunayTetrahedralization {
+	public:
+		using T = Real;
+		using Vector3 = glm::vec<3, T>;
+
+	public:
+		DelaunayTetrahedralization() = default;
+		/**
+		 * Tetrahedralize the points, inserted in a biased randomized order. The duplicated points are ignored.
+		 * @param points The points to tetrahedralize.
+		 * @param exact Whether the in-sphere test is the exact InSphere predicate, or the non-robust comparison
+		 * with the circumsphere of `GetSphere`, in double precision. The orientations are always exact, and
+		 * when a cavity would break the tetrahedralization only the tetrahedra containing the point are replaced,
+		 * so the tetrahedralization stays valid but may not be exactly a Delaunay one.
+		 */
+		explicit DelaunayTetrahedralization(std::vector<Vector3> points, bool exact = true);
+		~DelaunayTetrahedralization() = default;
+
+	public:
+		/**
+		 * Insert a point in the tetrahedralization.
+		 * Until 4 of the points are not coplanar there is no tetrahedron, they are inserted as soon as there is one.
+		 * @return The id of the point in GetPoints. A duplicated point keeps an id but is not a vertex.
+		 */
+		uint32_t AddPoint(const Vector3 &point);
+
+		[[nodiscard]] const std::vector<Vector3> &GetPoints() const { return m_Points; }
+		[[nodiscard]] size_t GetTetrahedronCount() const { return m_Tetrahedra.size() - m_HullFaceCount; }
+		/// The tetrahedra, as indices into the points, positively oriented (Orient3D of the 4 points is positive).
+		[[nodiscard]] std::vector<std::array<uint32_t, 4>> GetTetrahedra() const;
+		/// The faces of the convex hull, counter-clockwise seen from outside, as indices into the points.
+		[[nodiscard]] std::vector<std::array<uint32_t, 3>> GetHullTriangles() const;
+		/**
+		 * The faces of every tetrahedron, three vertices per triangle counter-clockwise from outside, as a mesh to render.
+		 * @param scale The scale of each tetrahedron around its center, below 1 to see them apart.
+		 */
+		[[nodiscard]] std::vector<Vector3> GetMesh(T scale = 1) const;
+
+	private:
+		static constexpr uint32_t InvalidId = FreeListVector<int>::InvalidId;
+		/// The vertex of the ghost tetrahedra, a point at infinity beyond every face of the hull.
+		static constexpr uint32_t InfiniteVertex = InvalidId - 1;
+		/// The face opposite to each vertex, ordered so the vertex is below it: the faces are counter-clockwise from outside.
+		static constexpr std::array<std::array<uint32_t, 3>, 4> FaceVertices{{{1, 3, 2}, {0, 2, 3}, {0, 3, 1}, {0, 1, 2}}};
+
+		/**
+		 * A positively oriented tetrahedron, or a ghost with the infinite vertex in place of a point beyond its hull face:
+		 * any point outside the hull face makes it positively oriented.
+		 */
+		struct Tetrahedron {
+			std::array<uint32_t, 4> Vertices;
+			/// The neighbour through the face opposite to each vertex, as 4 * neighbour + index of the face in the neighbour.
+			std::array<uint32_t, 4> Neighbours{InvalidId, InvalidId, InvalidId, InvalidId};
+		};
+		static_assert(sizeof(Tetrahedron) == 32);
+
+		/// Index of the infinite vertex in the tetrahedron, 4 if it is not a ghost.
+		[[nodiscard]] static uint32_t GetInfiniteIndex(const Tetrahedron &tetrahedron);
+		[[nodiscard]] static bool AreCollinear(const Vector3 &a, const Vector3 &b, const Vector3 &c);
+		/// Orientation of the point against the face opposite to the vertex i, positive on the side of the vertex.
+		[[nodiscard]] double GetSide(const Tetrahedron &tetrahedron, uint32_t i, const Vector3 &point) const;
+
+		void AddVertex(uint32_t vertex);
+		void AddPending(uint32_t vertex);
+		void BuildFirstTetrahedron();
+		void Insert(uint32_t vertex);
+		/// The tetrahedron containing the point, or a ghost whose hull face sees it, with a stochastic visibility walk.
+		[[nodiscard]] uint32_t Locate(const Vector3 &point);
+		enum class ConflictTest : uint8_t {
+			/// The exact InSphere predicate.
+			InSphere,
+			/// The circumsphere of GetSphere, in double precision.
+			Circumsphere,
+			/// Only the tetrahedra containing the point, the cavity of an insertion without flips.
+			Contains,
+		};
+
+		/**
+		 * Gather the tetrahedra in conflict with the point in the cavity, and the faces around it in the boundary.
+		 * @return Whether the cavity can be replaced by the cone from its boundary to the point.
+		 * It always is with the exact predicate in a Delaunay tetrahedralization, or with the tetrahedra containing the point.
+		 */
+		bool FindCavity(uint32_t start, const Vector3 &point, ConflictTest test);
+		/// Whether the point is strictly inside the circumsphere of the tetrahedron, or beyond the hull face of the ghost.
+		[[nodiscard]] bool IsInConflict(uint32_t tetrahedronId, const Vector3 &point, ConflictTest test) const;
+		/// Whether joining the face i of a tetrahedron of the cavity to the point makes a valid tetrahedron.
+		[[nodiscard]] bool IsVisible(uint32_t tetrahedronId, uint32_t i, const Vector3 &point) const;
+		/// Link the faces of the tetrahedra that have no neighbour yet to each other, all of them sharing the apex.
+		void LinkFaces(const std::vector<uint32_t> &tetrahedra, uint32_t apex);
+
+	private:
+		std::vector<Vector3> m_Points;
+		FreeListVector<Tetrahedron> m_Tetrahedra;
+		size_t m_HullFaceCount{0};
+		bool m_Exact{true};
+		/// The tetrahedron the next walk starts from.
+		uint32_t m_LastTetrahedron{InvalidId};
+		uint32_t m_WalkSeed{0x5EED};
+		/// The points waiting for a first tetrahedron, the first ones being independent: a point, a segment, a triangle.
+		std::vector<uint32_t> m_Pending;
+		uint32_t m_BasisSize{0};
+
+		// Scratch buffers of Insert.
+		std::vector<uint32_t> m_Cavity;
+		std::vector<bool> m_InCavity;
+		std::vector<uint32_t> m_Outside;
+		std::vector<bool> m_IsOutside;
+		std::vector<uint32_t> m_Boundary;
+		std::vector<bool> m_IsOnBoundary;
+		std::vector<Tetrahedron> m_Cone;
+		std::vector<uint32_t> m_ConeIds;
+		/// A slot of the small open addressing tables keyed by an edge: the face waiting on it, or how many faces have it.
+		struct EdgeSlot {
+			uint64_t Edge;
+			uint32_t Value;
+		};
+		std::vector<EdgeSlot> m_EdgeSlots;
+	};
+
+	inline DelaunayTetrahedralization::DelaunayTetrahedralization(std::vector<Vector3> points, const bool exact) : m_Points(std::move(points)), m_Exact(exact) {
+		// Random points have about 6.5 tetrahedra each.
+		m_Tetrahedra.reserve(m_Points.size() * 7);
+		for (const uint32_t vertex: BrioOrder(m_Points.begin(), m_Points.end())) AddVertex(vertex);
+	}
+
+	inline uint32_t DelaunayTetrahedralization::AddPoint(const Vector3 &point) {
+		const auto vertex = static_cast<uint32_t>(m_Points.size());
+		m_Points.push_back(point);
+		AddVertex(vertex);
+		return vertex;
+	}
+
+	inline std::vector<std::array<uint32_t, 4>> DelaunayTetrahedralization::GetTetrahedra() const {
+		std::vector<std::array<uint32_t, 4>> tetrahedra;
+		tetrahedra.reserve(GetTetrahedronCount());
+		for (const auto &[id, tetrahedron]: m_Tetrahedra) {
+			if (GetInfiniteIndex(tetrahedron) == 4) tetrahedra.push_back(tetrahedron.Vertices);
+		}
+		return tetrahedra;
+	}
+
+	inline std::vector<std::array<uint32_t, 3>> DelaunayTetrahedralization::GetHullTriangles() const {
+		std::vector<std::array<uint32_t, 3>> triangles;
+		triangles.reserve(m_HullFaceCount);
+		for (const auto &[id, tetrahedron]: m_Tetrahedra) {
+			const uint32_t infinite = GetInfiniteIndex(tetrahedron);
+			if (infinite == 4) continue;
+			// The outside is where the infinite vertex is, so the face is reversed.
+			const auto &face = FaceVertices[infinite];
+			triangles.push_back({tetrahedron.Vertices[face[0]], tetrahedron.Vertices[face[2]], tetrahedron.Vertices[face[1]]});
+		}
+		return triangles;
+	}
+
+	inline std::vector<DelaunayTetrahedralization::Vector3> DelaunayTetrahedralization::GetMesh(const T scale) const {
+		std::vector<Vector3> mesh;
+		mesh.reserve(GetTetrahedronCount() * 12);
+		for (const auto &[id, tetrahedron]: m_Tetrahedra) {
+			if (GetInfiniteIndex(tetrahedron) != 4) continue;
+			Vector3 center{0};
+			for (const uint32_t vertex: tetrahedron.Vertices) center += m_Points[vertex];
+			center /= static_cast<T>(4);
+			for (const auto &face: FaceVertices) {
+				for (const uint32_t i: face) mesh.push_back(center + (m_Points[tetrahedron.Vertices[i]] - center) * scale);
+			}
+		}
+		return mesh;
+	}
+
+	inline uint32_t DelaunayTetrahedralization::GetInfiniteIndex(const Tetrahedron &tetrahedron) {
+		return static_cast<uint32_t>(std::find(tetrahedron.Vertices.begin(), tetrahedron.Vertices.end(), InfiniteVertex) - tetrahedron.Vertices.begin());
+	}
+
+	inline bool DelaunayTetrahedralization::AreCollinear(const Vector3 &a, const Vector3 &b, const Vector3 &c) {
+		using Vector2 = glm::vec<2, T>;
+		return Orient2D(Vector2{a.x, a.y}, Vector2{b.x, b.y}, Vector2{c.x, c.y}) == 0
+		       && Orient2D(Vector2{a.y, a.z}, Vector2{b.y, b.z}, Vector2{c.y, c.z}) == 0
+		       && Orient2D(Vector2{a.z, a.x}, Vector2{b.z, b.x}, Vector2{c.z, c.x}) == 0;
+	}
+
+	inline double DelaunayTetrahedralization::GetSide(const Tetrahedron &tetrahedron, const uint32_t i, const Vector3 &point) const {
+		const auto &face = FaceVertices[i];
+		return Orient3D(m_Points[tetrahedron.Vertices[face[0]]], m_Points[tetrahedron.Vertices[face[1]]], m_Points[tetrahedron.Vertices[face[2]]], point);
+	}
+
+	inline void DelaunayTetrahedralization::AddVertex(const uint32_t vertex) {
+		if (m_Tetrahedra.empty()) AddPending(vertex);
+		else Insert(vertex);
+	}
+
+	inline void DelaunayTetrahedralization::AddPending(const uint32_t vertex) {
+		const Vector3 &point = m_Points[vertex];
+		const auto basis = [this](const uint32_t i) -> const Vector3 & { return m_Points[m_Pending[i]]; };
+		bool isIndependent;
+		switch (m_BasisSize) {
+			case 0: isIndependent = true;
+				break;
+			case 1: isIndependent = point != basis(0);
+				break;
+			case 2: isIndependent = !AreCollinear(basis(0), basis(1), point);
+				break;
+			default: isIndependent = Orient3D(basis(0), basis(1), basis(2), point) != 0;
+				break;
+		}
+		m_Pending.push_back(vertex);
+		if (!isIndependent) return;
+		std::swap(m_Pending[m_BasisSize], m_Pending.back());
+		if (++m_BasisSize == 4) BuildFirstTetrahedron();
+	}
+
+	inline void DelaunayTetrahedralization::BuildFirstTetrahedron() {
+		std::array<uint32_t, 4> vertices{m_Pending[0], m_Pending[1], m_Pending[2], m_Pending[3]};
+		if (Orient3D(m_Points[vertices[0]], m_Points[vertices[1]], m_Points[vertices[2]], m_Points[vertices[3]]) < 0) std::swap(vertices[0], vertices[1]);
+		const uint32_t first = m_Tetrahedra.emplace(Tetrahedron{vertices});
+
+		// A ghost is the tetrahedron with the infinite vertex in place of the one behind the face, turned inside out.
+		std::vector<uint32_t> ghosts;
+		for (uint32_t i = 0; i < 4; ++i) {
+			Tetrahedron ghost{vertices};
+			ghost.Vertices[i] = InfiniteVertex;
+			std::swap(ghost.Vertices[(i + 1) & 3], ghost.Vertices[(i + 2) & 3]);
+			ghost.Neighbours[i] = 4 * first + i;
+			const uint32_t id = m_Tetrahedra.emplace(ghost);
+			m_Tetrahedra[first].Neighbours[i] = 4 * id + i;
+			ghosts.push_back(id);
+		}
+		LinkFaces(ghosts, InfiniteVertex);
+		m_HullFaceCount = 4;
+		m_LastTetrahedron = first;
+
+		const std::vector<uint32_t> pending = std::move(m_Pending);
+		m_Pending.clear();
+		for (size_t i = 4; i < pending.size(); ++i) Insert(pending[i]);
+	}
+
+	inline void DelaunayTetrahedralization::Insert(const uint32_t vertex) {
+		const Vector3 &point = m_Points[vertex];
+		const uint32_t start = Locate(point);
+		const Tetrahedron &located = m_Tetrahedra[start];
+		if (GetInfiniteIndex(located) == 4 && std::any_of(located.Vertices.begin(), located.Vertices.end(), [this, &point](const uint32_t v) { return m_Points[v] == point; })) {
+			return;
+		}
+
+		if (m_InCavity.size() < m_Tetrahedra.id_bound()) {
+			m_InCavity.resize(m_Tetrahedra.id_bound(), false);
+			m_IsOutside.resize(m_Tetrahedra.id_bound(), false);
+		}
+		// The last flag is the one of the infinite vertex.
+		if (m_IsOnBoundary.size() <= m_Points.size()) m_IsOnBoundary.resize(m_Points.size() + 1, false);
+		if (m_Exact) FindCavity(start, point, ConflictTest::InSphere);
+		else if (!FindCavity(start, point, ConflictTest::Circumsphere)) FindCavity(start, point, ConflictTest::Contains);
+
+		// The cone is made before the cavity is removed, so its slots are reused.
+		m_Cone.clear();
+		for (const uint32_t face: m_Boundary) {
+			const Tetrahedron &tetrahedron = m_Tetrahedra[face >> 2];
+			Tetrahedron &cone = m_Cone.emplace_back(Tetrahedron{tetrahedron.Vertices});
+			cone.Vertices[face & 3] = vertex;
+			cone.Neighbours[face & 3] = tetrahedron.Neighbours[face & 3];
+		}
+		for (const uint32_t id: m_Cavity) {
+			if (GetInfiniteIndex(m_Tetrahedra[id]) != 4) --m_HullFaceCount;
+			m_InCavity[id] = false;
+			m_Tetrahedra.erase(id);
+		}
+		m_ConeIds.clear();
+		for (size_t k = 0; k < m_Cone.size(); ++k) {
+			const uint32_t i = m_Boundary[k] & 3;
+			const uint32_t outside = m_Cone[k].Neighbours[i];
+			const uint32_t id = m_Tetrahedra.emplace(m_Cone[k]);
+			m_Tetrahedra[outside >> 2].Neighbours[outside & 3] = 4 * id + i;
+			if (GetInfiniteIndex(m_Cone[k]) == 4) m_LastTetrahedron = id;
+			else ++m_HullFaceCount;
+			m_ConeIds.push_back(id);
+		}
+		LinkFaces(m_ConeIds, vertex);
+	}
+
+	inline bool DelaunayTetrahedralization::FindCavity(const uint32_t start, const Vector3 &point, const ConflictTest test) {
+		// The tetrahedra in conflict are connected, they're gathered from the one containing the point.
+		// The tetrahedra seen outside are remembered, a tetrahedron being often next to several ones of the cavity.
+		m_Cavity.assign(1, start);
+		m_InCavity[start] = true;
+		m_Outside.clear();
+		m_Boundary.clear();
+		for (size_t k = 0; k < m_Cavity.size(); ++k) {
+			for (uint32_t i = 0; i < 4; ++i) {
+				const uint32_t neighbour = m_Tetrahedra[m_Cavity[k]].Neighbours[i] >> 2;
+				if (m_InCavity[neighbour]) continue;
+				if (m_IsOutside[neighbour] || !IsInConflict(neighbour, point, test)) {
+					if (!m_IsOutside[neighbour]) {
+						m_IsOutside[neighbour] = true;
+						m_Outside.push_back(neighbour);
+					}
+					m_Boundary.push_back(4 * m_Cavity[k] + i);
+					continue;
+				}
+				m_InCavity[neighbour] = true;
+				m_Cavity.push_back(neighbour);
+			}
+		}
+		for (const uint32_t id: m_Outside) m_IsOutside[id] = false;
+		if (test != ConflictTest::Circumsphere) return true;
+
+		// With the approximate circumspheres the cavity may not be star-shaped from the point, or hide a vertex inside.
+		// Its boundary must be a sphere: every edge on 2 faces, and 2 vertices more than half the faces.
+		bool isValid = true;
+		uint32_t vertexCount = 0;
+		const auto capacity = std::bit_ceil(static_cast<uint32_t>(4 * m_Boundary.size()));
+		m_EdgeSlots.assign(capacity, EdgeSlot{0, 0});
+		for (const uint32_t face: m_Boundary) {
+			const Tetrahedron &tetrahedron = m_Tetrahedra[face >> 2];
+			isValid = isValid && IsVisible(face >> 2, face & 3, point);
+			const auto &vertices = FaceVertices[face & 3];
+			for (uint32_t j = 0; j < 3; ++j) {
+				const uint32_t v = tetrahedron.Vertices[vertices[j]];
+				if (!m_IsOnBoundary[v == InfiniteVertex ? m_Points.size() : v]) {
+					m_IsOnBoundary[v == InfiniteVertex ? m_Points.size() : v] = true;
+					++vertexCount;
+				}
+				const uint64_t w = tetrahedron.Vertices[vertices[(j + 1) % 3]];
+				const uint64_t edge = (std::max<uint64_t>(v, w) << 32) | std::min<uint64_t>(v, w);
+				uint32_t slot = static_cast<uint32_t>((edge * 0x9E3779B97F4A7C15ull) >> 32) & (capacity - 1);
+				while (m_EdgeSlots[slot].Value != 0 && m_EdgeSlots[slot].Edge != edge) slot = (slot + 1) & (capacity - 1);
+				m_EdgeSlots[slot].Edge = edge;
+				isValid = isValid && ++m_EdgeSlots[slot].Value <= 2;
+			}
+		}
+		isValid = isValid && 2 * vertexCount == m_Boundary.size() + 4;
+		for (const uint32_t id: m_Cavity) {
+			for (const uint32_t v: m_Tetrahedra[id].Vertices) isValid = isValid && m_IsOnBoundary[v == InfiniteVertex ? m_Points.size() : v];
+		}
+		for (const uint32_t face: m_Boundary) {
+			for (const uint32_t j: FaceVertices[face & 3]) {
+				const uint32_t v = m_Tetrahedra[face >> 2].Vertices[j];
+				m_IsOnBoundary[v == InfiniteVertex ? m_Points.size() : v] = false;
+			}
+		}
+		if (!isValid) {
+			for (const uint32_t id: m_Cavity) m_InCavity[id] = false;
+		}
+		return isValid;
+	}
+
+	inline uint32_t DelaunayTetrahedralization::Locate(const Vector3 &point) {
+		uint32_t id = m_LastTetrahedron;
+		while (true) {
+			const Tetrahedron &tetrahedron = m_Tetrahedra[id];
+			if (GetInfiniteIndex(tetrahedron) != 4) return id;
+
+			// The faces are tried from a random one, so the walk can't cycle.
+			m_WalkSeed = m_WalkSeed * 1664525u + 1013904223u;
+			const uint32_t first = m_WalkSeed >> 30;
+			bool isInside = true;
+			for (uint32_t j = 0; j < 4 && isInside; ++j) {
+				const uint32_t i = (first + j) & 3;
+				if (GetSide(tetrahedron, i, point) < 0) {
+					id = tetrahedron.Neighbours[i] >> 2;
+					isInside = false;
+				}
+			}
+			if (isInside) return id;
+		}
+	}
+
+	inline bool DelaunayTetrahedralization::IsInConflict(const uint32_t tetrahedronId, const Vector3 &point, const ConflictTest test) const {
+		const Tetrahedron &tetrahedron = m_Tetrahedra[tetrahedronId];
+		const uint32_t infinite = GetInfiniteIndex(tetrahedron);
+		if (infinite == 4) {
+			if (test == ConflictTest::Contains) {
+				for (uint32_t i = 0; i < 4; ++i) {
+					if (GetSide(tetrahedron, i, point) < 0) return false;
+				}
+				return true;
+			}
+			const Vector3 &a = m_Points[tetrahedron.Vertices[0]];
+			const Vector3 &b = m_Points[tetrahedron.Vertices[1]];
+			const Vector3 &c = m_Points[tetrahedron.Vertices[2]];
+			const Vector3 &d = m_Points[tetrahedron.Vertices[3]];
+			if (test == ConflictTest::InSphere) return InSphere(a, b, c, d, point) > 0;
+
+			using Vector3d = glm::vec<3, double>;
+			const Sphere<double> sphere = GetSphere(Vector3d{a}, Vector3d{b}, Vector3d{c}, Vector3d{d});
+			return Magnitude2(Vector3d{point} - sphere.Center) < sphere.Radius * sphere.Radius;
+		}
+
+		// The ghost is positively oriented with the point in place of the infinite vertex if the point is beyond the hull face.
+		const double side = GetSide(tetrahedron, infinite, point);
+		if (side != 0) return side > 0;
+		// On the plane of the hull face, the point is in conflict if it is inside the circumcircle of the face,
+		// which is also where the circumsphere of the tetrahedron behind cuts the plane, or on the face itself for `Contains`.
+		return IsInConflict(tetrahedron.Neighbours[infinite] >> 2, point, test);
+	}
+
+	inline bool DelaunayTetrahedralization::IsVisible(const uint32_t tetrahedronId, const uint32_t i, const Vector3 &point) const {
+		const Tetrahedron &tetrahedron = m_Tetrahedra[tetrahedronId];
+		const uint32_t infinite = GetInfiniteIndex(tetrahedron);
+		if (infinite == 4 || infinite == i) return GetSide(tetrahedron, i, point) > 0;
+
+		// The new ghost needs a proper triangle on the hull.
+		std::array<uint32_t, 2> others{};
+		uint32_t count = 0;
+		for (uint32_t j = 0; j < 4; ++j) {
+			if (j != i && j != infinite) others[count++] = tetrahedron.Vertices[j];
+		}
+		return !AreCollinear(m_Points[others[0]], m_Points[others[1]], point);
+	}
+
+	inline void DelaunayTetrahedralization::LinkFaces(const std::vector<uint32_t> &tetrahedra, const uint32_t apex) {
+		// The faces are matched by their edge opposite to the apex, in a small open addressing table.
+		const auto capacity = std::bit_ceil(static_cast<uint32_t>(4 * tetrahedra.size()));
+		m_EdgeSlots.assign(capacity, EdgeSlot{0, InvalidId});
+		for (const uint32_t id: tetrahedra) {
+			const Tetrahedron &tetrahedron = m_Tetrahedra[id];
+			for (uint32_t i = 0; i < 4; ++i) {
+				if (tetrahedron.Neighbours[i] != InvalidId) continue;
+				uint64_t low = InvalidId, high = 0;
+				for (const uint32_t j: FaceVertices[i]) {
+					const uint32_t vertex = tetrahedron.Vertices[j];
+					if (vertex == apex) continue;
+					low = std::min<uint64_t>(low, vertex);
+					high = std::max<uint64_t>(high, vertex);
+				}
+
+				const uint64_t edge = (high << 32) | low;
+				const uint32_t face = 4 * id + i;
+				uint32_t slot = static_cast<uint32_t>((edge * 0x9E3779B97F4A7C15ull) >> 32) & (capacity - 1);
+				while (m_EdgeSlots[slot].Value != InvalidId && m_EdgeSlots[slot].Edge != edge) slot = (slot + 1) & (capacity - 1);
+				if (m_EdgeSlots[slot].Value == InvalidId) {
+					m_EdgeSlots[slot] = {edge, face};
+					continue;
+				}
+				const uint32_t twin = m_EdgeSlots[slot].Value;
+				m_Tetrahedra[id].Neighbours[i] = twin;
+				m_Tetrahedra[twin >> 2].Neighbours[twin & 3] = face;
+			}
+		}
+	}
+
+}
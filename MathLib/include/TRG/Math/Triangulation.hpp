@@ -37,6 +37,7 @@ namespace TRG::Math {
 		return mesh;
 	}
 
+	/// The triangles on the XZ plane, the height of the vertices going up from y.
 	inline std::vector<typename MeshGraph::Vector3> MeshGraphToMesh3DXZ(const MeshGraph& meshGraph, MeshGraph::T y = 0) {
 		std::vector<MeshGraph::Vector3> mesh;
 		mesh.reserve(meshGraph.m_Triangles.size() * 3);
@@ -50,18 +51,19 @@ namespace TRG::Math {
 			const auto& C = meshGraph.m_Vertices.at(secondEdge.VertexA == AB.VertexA || secondEdge.VertexA == AB.VertexB ? secondEdge.VertexB : secondEdge.VertexA);
 
 			if (AisInOtherEdge) {
-				mesh.push_back(MeshGraph::Vector3{A.Position.x, y, A.Position.y});
-				mesh.push_back(MeshGraph::Vector3{B.Position.x, y, B.Position.y});
-				mesh.push_back(MeshGraph::Vector3{C.Position.x, y, C.Position.y});
+				mesh.push_back(MeshGraph::Vector3{A.Position.x, y + A.Height, A.Position.y});
+				mesh.push_back(MeshGraph::Vector3{B.Position.x, y + B.Height, B.Position.y});
+				mesh.push_back(MeshGraph::Vector3{C.Position.x, y + C.Height, C.Position.y});
 			} else {
-				mesh.push_back(MeshGraph::Vector3{B.Position.x, y, B.Position.y});
-				mesh.push_back(MeshGraph::Vector3{A.Position.x, y, A.Position.y});
-				mesh.push_back(MeshGraph::Vector3{C.Position.x, y, C.Position.y});
+				mesh.push_back(MeshGraph::Vector3{B.Position.x, y + B.Height, B.Position.y});
+				mesh.push_back(MeshGraph::Vector3{A.Position.x, y + A.Height, A.Position.y});
+				mesh.push_back(MeshGraph::Vector3{C.Position.x, y + C.Height, C.Position.y});
 			}
 		}
 		return mesh;
 	}
 
+	/// The triangles on the XY plane, the height of the vertices going up from z.
 	inline std::vector<typename MeshGraph::Vector3> MeshGraphToMesh3DXY(const MeshGraph& meshGraph, MeshGraph::T z = 0) {
 		std::vector<MeshGraph::Vector3> mesh;
 		mesh.reserve(meshGraph.m_Triangles.size() * 3);
@@ -75,13 +77,13 @@ namespace TRG::Math {
 			const auto& C = meshGraph.m_Vertices.at(secondEdge.VertexA == AB.VertexA || secondEdge.VertexA == AB.VertexB ? secondEdge.VertexB : secondEdge.VertexA);
 
 			if (AisInOtherEdge) {
-				mesh.push_back(MeshGraph::Vector3{B.Position.x, B.Position.y, z});
-				mesh.push_back(MeshGraph::Vector3{A.Position.x, A.Position.y, z});
-				mesh.push_back(MeshGraph::Vector3{C.Position.x, C.Position.y, z});
+				mesh.push_back(MeshGraph::Vector3{B.Position.x, B.Position.y, z + B.Height});
+				mesh.push_back(MeshGraph::Vector3{A.Position.x, A.Position.y, z + A.Height});
+				mesh.push_back(MeshGraph::Vector3{C.Position.x, C.Position.y, z + C.Height});
 			} else {
-				mesh.push_back(MeshGraph::Vector3{A.Position.x, A.Position.y, z});
-				mesh.push_back(MeshGraph::Vector3{B.Position.x, B.Position.y, z});
-				mesh.push_back(MeshGraph::Vector3{C.Position.x, C.Position.y, z});
+				mesh.push_back(MeshGraph::Vector3{A.Position.x, A.Position.y, z + A.Height});
+				mesh.push_back(MeshGraph::Vector3{B.Position.x, B.Position.y, z + B.Height});
+				mesh.push_back(MeshGraph::Vector3{C.Position.x, C.Position.y, z + C.Height});
 			}
 		}
 		return mesh;
@@ -3,7 +3,10 @@
 //
 
 #include <TRG/Math.hpp>
+#include <TRG/Math/FreeListVector.hpp>
 #include <gtest/gtest.h>
+#include <memory>
+#include <random>
 
 using namespace TRG::Literal;
 using namespace TRG;
@@ -16,6 +19,23 @@ using namespace TRG;
 	#define ASSERT_REAL_EQ(val1, val2) ASSERT_FLOAT_EQ(val1, val2)
 #endif
 
+// A triangulation of a convex domain, V - E + F = 1, with the triangles oriented as their edges expect & an empty circumcircle.
+static void checkDelaunay(const Math::MeshGraph& mg) {
+	ASSERT_EQ(mg.m_Vertices.size() + mg.m_Triangles.size(), mg.m_Edges.size() + 1);
+	for (const auto& [triangleId, triangle] : mg.m_Triangles) {
+		const auto& AB = mg.m_Edges.at(triangle.EdgeAB);
+		const auto& BC = mg.m_Edges.at(triangle.EdgeBC);
+		const uint32_t cId = BC.VertexA == AB.VertexA || BC.VertexA == AB.VertexB ? BC.VertexB : BC.VertexA;
+		const Vec2 a = mg.m_Vertices.at(AB.VertexA).Position;
+		const Vec2 b = mg.m_Vertices.at(AB.VertexB).Position;
+		const Vec2 c = mg.m_Vertices.at(cId).Position;
+		ASSERT_EQ(Math::IsTriangleOriented(a, b, c), AB.TriangleLeft == triangleId);
+		for (const auto& [vertexId, vertex] : mg.m_Vertices) {
+			ASSERT_FALSE(Math::IsPointInsideCircumcircle(a, b, c, vertex.Position));
+		}
+	}
+}
+
 // Demonstrate some basic assertions.
 TEST(HelloTest, BasicAssertions) {
 	// Expect two strings not to be equal.
@@ -91,6 +111,79 @@ TEST(MathTest, OrientationTests) {
 	EXPECT_FALSE(TRG::Math::IsTriangleOriented(A, C, B));
 }
 
+TEST(MathTest, PredicatesTests) {
+	// A few ulps around (0.5, 0.5), against the line y = x: the sign only depends on which coordinate is the biggest.
+	const Vec2 B{12, 12};
+	const Vec2 C{24, 24};
+	Real x = 0.5;
+	for (int i = 0; i < 8; ++i, x = std::nextafter(x, static_cast<Real>(1))) {
+		Real y = 0.5;
+		for (int j = 0; j < 8; ++j, y = std::nextafter(y, static_cast<Real>(1))) {
+			const double orientation = Math::Orient2D(Vec2{x, y}, B, C);
+			EXPECT_EQ(orientation > 0, j > i);
+			EXPECT_EQ(orientation < 0, j < i);
+			EXPECT_EQ(Math::AreCollinear(Vec2{x, y}, B, C), i == j);
+		}
+	}
+
+	// An isosceles trapezoid, the 4 points are exactly cocircular whatever the rounding of the coordinates.
+	const Vec2 p1{-3, static_cast<Real>(0.45)};
+	const Vec2 p2{-2, static_cast<Real>(0.2)};
+	const Vec2 p3{2, static_cast<Real>(0.2)};
+	const Vec2 p4{3, static_cast<Real>(0.45)};
+	EXPECT_EQ(Math::InCircle(p1, p2, p3, p4), 0.0);
+	EXPECT_FALSE(Math::IsPointInsideCircumcircle(p1, p2, p3, p4));
+	EXPECT_FALSE(Math::IsPointInsideCircumcircle(p1, p3, p2, p4));
+	EXPECT_TRUE(Math::IsPointInsideCircumcircle(p1, p2, p3, Vec2{std::nextafter(p4.x, static_cast<Real>(0)), p4.y}));
+	EXPECT_FALSE(Math::IsPointInsideCircumcircle(p1, p2, p3, Vec2{std::nextafter(p4.x, static_cast<Real>(4)), p4.y}));
+}
+
+TEST(MathTest, BatchTests) {
+	// Small integer coordinates, so a lot of the points are collinear or cocircular and the exact fallback is used.
+	std::vector<Vec2> points;
+	for (int i = 0; i < 64; ++i) {
+		points.emplace_back(static_cast<Real>((i * 7) % 5), static_cast<Real>((i * 11) % 4));
+	}
+
+	Math::SegmentBuffer segments;
+	Math::TriangleBuffer triangles;
+	for (size_t i = 0; i + 2 < points.size(); ++i) {
+		segments.Add(points[i], points[i + 1]);
+		triangles.Add(points[i], points[i + 1], points[i + 2]);
+	}
+
+	std::vector<int8_t> orientations(segments.Size());
+	std::vector<uint8_t> insideCircles(triangles.Size());
+	for (const Vec2& p : points) {
+		Math::OrientBatch(p, segments, orientations.data());
+		Math::InCircleBatch(p, triangles, insideCircles.data());
+		for (size_t i = 0; i < triangles.Size(); ++i) {
+			const Vec2 a = points[i], b = points[i + 1], c = points[i + 2];
+			const double orientation = Math::Orient2D(a, b, p);
+			EXPECT_EQ(orientations[i], (orientation > 0) - (orientation < 0));
+			EXPECT_EQ(insideCircles[i] != 0, Math::IsPointInsideCircumcircle(a, b, c, p));
+		}
+	}
+
+	// The vector lanes follow the operations of the scalar circumcenter.
+	std::vector<double> centersX(triangles.Size()), centersY(triangles.Size());
+	Math::CircumcentersBatch(triangles, centersX.data(), centersY.data());
+	for (size_t i = 0; i < triangles.Size(); ++i) {
+		double centerX, centerY;
+		Math::Batch::Circumcenter(triangles.AX[i], triangles.AY[i], triangles.BX[i], triangles.BY[i], triangles.CX[i], triangles.CY[i], centerX, centerY);
+		if (!std::isfinite(centerX) || !std::isfinite(centerY)) continue;
+		EXPECT_DOUBLE_EQ(centersX[i], centerX);
+		EXPECT_DOUBLE_EQ(centersY[i], centerY);
+	}
+
+	Math::TriangleBuffer circles;
+	circles.Add(Vec2{-6, 3}, Vec2{-3, 2}, Vec2{0, 3});
+	double centerX, centerY;
+	Math::CircumcentersBatch(circles, &centerX, &centerY);
+	EXPECT_DOUBLE_EQ(centerX, -3);
+	EXPECT_DOUBLE_EQ(centerY, 7);
+}
+
 TEST(MathTest, TriangleTests) {
 	const Vec2 A{-1,-1};
 	const Vec2 B{1,-1};
@@ -203,4 +296,948 @@ TEST(MathTest, RayCastTests) {
 	const auto hit7 = Math::Raycast(plane7, ray7);
 	ASSERT_TRUE(hit7.has_value());
 	EXPECT_REAL_EQ(hit7.value(), std::sqrt(4.5_r));
-}
\ No newline at end of file
+}
+TEST(MathTest, JarvisConvexShellTests) {
+	// A square with points inside, on its edges & duplicated corners.
+	std::vector<Vec2> points{{2, 2}, {0, 0}, {4, 0}, {2, 0}, {4, 4}, {0, 4}, {0, 2}, {1, 3}, {4, 4}, {0, 0}, {3, 1}};
+	const std::vector<Vec2> square{{0, 0}, {4, 0}, {4, 4}, {0, 4}};
+	EXPECT_EQ(Math::JarvisConvexShell(points.begin(), points.end()), square);
+
+	// Enough points for several groups, on a circle around a cloud.
+	std::mt19937 random(19);
+	std::uniform_real_distribution<Real> distribution(-1, 1);
+	points.clear();
+	for (int i = 0; i < 10000; ++i) points.emplace_back(distribution(random), distribution(random));
+	for (int i = 0; i < 200; ++i) {
+		const Real angle = static_cast<Real>(i) * 2 * pi / 200;
+		points.emplace_back(10 * std::cos(angle), 10 * std::sin(angle));
+	}
+	const std::vector<Vec2> shell = Math::JarvisConvexShell(points.begin(), points.end());
+	ASSERT_GE(shell.size(), 3);
+	for (size_t i = 0; i < shell.size(); ++i) {
+		EXPECT_NEAR(Math::Magnitude(shell[i]), 10, 1e-3);
+		const Vec2 &a = shell[i];
+		const Vec2 &b = shell[(i + 1) % shell.size()];
+		for (const Vec2 &p : points) EXPECT_GE(Math::Orient2D(a, b, p), 0);
+	}
+	EXPECT_TRUE(Math::JarvisConvexShell(points.end(), points.end()).empty());
+}
+
+TEST(MathTest, MonotoneChainConvexShellTests) {
+	const std::vector<Vec2> points{{2, 2}, {0, 0}, {4, 0}, {2, 0}, {4, 4}, {0, 4}, {0, 2}, {1, 3}, {4, 4}, {0, 0}, {3, 1}};
+	const std::vector<Vec2> square{{0, 0}, {4, 0}, {4, 4}, {0, 4}};
+	EXPECT_EQ(Math::MonotoneChainConvexShell(points.begin(), points.end()), square);
+	EXPECT_EQ(Math::MonotoneChainConvexShellIndices(points), (std::vector<uint32_t>{1, 2, 4, 5}));
+
+	const std::list<Vec2> list = Math::GrahamScanConvexShell(points.begin(), points.end());
+	EXPECT_EQ(std::vector<Vec2>(list.begin(), list.end()), square);
+
+	// Collinear points only keep their ends.
+	const std::vector<Vec2> line{{1, 1}, {0, 0}, {2, 2}, {1, 1}};
+	EXPECT_EQ(Math::MonotoneChainConvexShellIndices(line), (std::vector<uint32_t>{1, 2}));
+	EXPECT_TRUE(Math::MonotoneChainConvexShellIndices(std::vector<Vec2>{}).empty());
+
+	// Every hull vertex given twice, the first index is kept.
+	const std::vector<Vec2> twice{{0, 0}, {4, 0}, {4, 4}, {0, 4}, {0, 0}, {4, 0}, {4, 4}, {0, 4}};
+	EXPECT_EQ(Math::MonotoneChainConvexShellIndices(twice), (std::vector<uint32_t>{0, 1, 2, 3}));
+	const std::vector<Vec2> reversed{{0, 4}, {4, 4}, {4, 0}, {0, 0}, {0, 4}, {4, 4}, {4, 0}, {0, 0}};
+	EXPECT_EQ(Math::MonotoneChainConvexShellIndices(reversed), (std::vector<uint32_t>{3, 2, 1, 0}));
+}
+
+TEST(MathTest, ParallelConvexShellTests) {
+	// Enough points to be shared by four threads, most of them inside the octagon of the extreme points.
+	std::mt19937 random(21);
+	std::uniform_real_distribution<Real> distribution(-10, 10);
+	std::vector<Vec2> points;
+	for (int i = 0; i < 100000; ++i) points.emplace_back(distribution(random), distribution(random));
+	for (int i = 0; i < 100; ++i) points.emplace_back(static_cast<Real>(i % 10), 10);
+	const std::vector<Vec2> shell = Math::ParallelConvexShell(points.begin(), points.end(), 4);
+	EXPECT_EQ(shell, Math::MonotoneChainConvexShell(points.begin(), points.end()));
+	EXPECT_EQ(Math::ParallelConvexShell(points.begin(), points.begin() + 3, 4), Math::MonotoneChainConvexShell(points.begin(), points.begin() + 3));
+	EXPECT_TRUE(Math::ParallelConvexShell(points.end(), points.end()).empty());
+}
+
+TEST(MathTest, DynamicConvexShellTests) {
+	Math::DynamicConvexShell shell;
+	EXPECT_TRUE(shell.Query().empty());
+	EXPECT_FALSE(shell.Erase({0, 0}));
+
+	// A sliding window over points on a small grid, with duplicates & points in line.
+	std::mt19937 random(22);
+	std::uniform_int_distribution<int> distribution(0, 9);
+	std::vector<Vec2> window;
+	for (int i = 0; i < 300; ++i) {
+		const Vec2 point(distribution(random), distribution(random));
+		shell.Insert(point);
+		window.push_back(point);
+		if (window.size() > 20) {
+			EXPECT_TRUE(shell.Erase(window.front()));
+			window.erase(window.begin());
+		}
+		ASSERT_EQ(shell.Query(), Math::MonotoneChainConvexShell(window.begin(), window.end()));
+	}
+	EXPECT_EQ(shell.GetCount(), window.size());
+
+	for (const Vec2 &point: window) EXPECT_TRUE(shell.Erase(point));
+	EXPECT_TRUE(shell.IsEmpty());
+	EXPECT_TRUE(shell.Query().empty());
+}
+
+TEST(MathTest, QuickHull3DTests) {
+	// The corners of a cube, with points inside & on its faces.
+	std::vector<Vec3> points;
+	for (int i = 0; i < 8; ++i) points.emplace_back(i & 1 ? 1 : -1, i & 2 ? 1 : -1, i & 4 ? 1 : -1);
+	std::mt19937 random(23);
+	std::uniform_real_distribution<Real> distribution(-1, 1);
+	for (int i = 0; i < 2000; ++i) {
+		Vec3 point{distribution(random), distribution(random), distribution(random)};
+		if (i % 4 == 0) point[i % 3] = i % 8 == 0 ? 1 : -1;
+		points.push_back(point);
+	}
+	const Math::QuickHull3D hull(points, 2);
+	const std::vector<std::array<uint32_t, 3>> triangles = hull.GetTriangles();
+	const std::vector<uint32_t> vertices = hull.GetVertices();
+	for (uint32_t i = 0; i < 8; ++i) EXPECT_TRUE(std::binary_search(vertices.begin(), vertices.end(), i));
+	// A closed triangulated surface.
+	EXPECT_EQ(triangles.size(), 2 * vertices.size() - 4);
+	Real volume = 0;
+	for (const auto &[a, b, c]: triangles) {
+		volume += Math::Dot(points[a], Math::Cross(points[b], points[c])) / 6;
+		for (const Vec3 &point: points) EXPECT_GE(Math::Orient3D(points[a], points[b], points[c], point), 0);
+	}
+	EXPECT_NEAR(volume, 8, 1e-3);
+	EXPECT_EQ(hull.GetMesh().size(), 3 * triangles.size());
+
+	const std::vector<Vec3> flat{{0, 0, 0}, {1, 0, 0}, {0, 1, 0}, {1, 1, 0}, {2, 3, 0}};
+	EXPECT_THROW(Math::QuickHull3D{flat}, std::invalid_argument);
+}
+
+TEST(MathTest, DelaunayTetrahedralizationTests) {
+	// Random points in a cube, with its corners and a duplicate.
+	std::vector<Vec3> points;
+	for (int i = 0; i < 8; ++i) points.emplace_back(i & 1 ? 1 : -1, i & 2 ? 1 : -1, i & 4 ? 1 : -1);
+	std::mt19937 random(24);
+	std::uniform_real_distribution<Real> distribution(-1, 1);
+	for (int i = 0; i < 500; ++i) points.emplace_back(distribution(random), distribution(random), distribution(random));
+	points.push_back(points[42]);
+
+	for (const bool exact: {true, false}) {
+		const Math::DelaunayTetrahedralization delaunay(points, exact);
+		const std::vector<std::array<uint32_t, 4>> tetrahedra = delaunay.GetTetrahedra();
+		ASSERT_EQ(tetrahedra.size(), delaunay.GetTetrahedronCount());
+		Real volume = 0;
+		for (const auto &[a, b, c, d]: tetrahedra) {
+			const double orientation = Math::Orient3D(points[a], points[b], points[c], points[d]);
+			EXPECT_GT(orientation, 0);
+			volume += static_cast<Real>(orientation) / 6;
+			if (exact) {
+				for (const Vec3 &point: points) EXPECT_LE(Math::InSphere(points[a], points[b], points[c], points[d], point), 0);
+			}
+		}
+		EXPECT_NEAR(volume, 8, 1e-3);
+		// The hull is the 12 triangles of the cube faces, each face being 2 of them.
+		EXPECT_EQ(delaunay.GetHullTriangles().size(), 12);
+		EXPECT_EQ(delaunay.GetMesh().size(), 12 * tetrahedra.size());
+	}
+
+	// The points are inserted one by one, the first ones being on a plane.
+	Math::DelaunayTetrahedralization incremental;
+	const std::vector<Vec3> flat{{0, 0, 0}, {1, 0, 0}, {0, 1, 0}, {1, 1, 0}};
+	for (const Vec3 &point: flat) incremental.AddPoint(point);
+	EXPECT_EQ(incremental.GetTetrahedronCount(), 0);
+	EXPECT_EQ(incremental.AddPoint({0, 0, 1}), 4);
+	EXPECT_EQ(incremental.AddPoint({1, 1, 1}), 5);
+	EXPECT_EQ(incremental.GetHullTriangles().size(), 8);
+	Real volume = 0;
+	for (const auto &[a, b, c, d]: incremental.GetTetrahedra()) {
+		const std::vector<Vec3> &p = incremental.GetPoints();
+		volume += static_cast<Real>(Math::Orient3D(p[a], p[b], p[c], p[d])) / 6;
+	}
+	EXPECT_NEAR(volume, 2.0 / 3.0, 1e-5);
+}
+
+TEST(MathTest, BrioOrderTests) {
+	// In 3D the Hilbert indices take up to 63 bits, the rounds must still come one after the other.
+	std::vector<Vec3> points;
+	std::mt19937 random(7);
+	std::uniform_real_distribution<Real> distribution(-1, 1);
+	for (int i = 0; i < 10000; ++i) points.emplace_back(distribution(random), distribution(random), distribution(random));
+
+	const std::vector<uint32_t> order = Math::BrioOrder(points.cbegin(), points.cend());
+	const std::vector<uint32_t> rounds = Math::BrioRounds(static_cast<uint32_t>(points.size()));
+	const std::vector<uint64_t> hilbert = Math::HilbertIndices(points.cbegin(), points.cend());
+	ASSERT_EQ(order.size(), points.size());
+	for (size_t i = 1; i < order.size(); ++i) {
+		ASSERT_LE(rounds[order[i - 1]], rounds[order[i]]);
+		if (rounds[order[i - 1]] == rounds[order[i]]) ASSERT_LE(hilbert[order[i - 1]], hilbert[order[i]]);
+	}
+	// Half of the points are in the last round.
+	const auto last = std::count(rounds.cbegin(), rounds.cend(), rounds[order.back()]);
+	EXPECT_NEAR(static_cast<double>(last) / static_cast<double>(points.size()), 0.5, 0.05);
+	std::vector<uint32_t> sorted = order;
+	std::sort(sorted.begin(), sorted.end());
+	for (uint32_t i = 0; i < sorted.size(); ++i) ASSERT_EQ(sorted[i], i);
+}
+
+TEST(MathTest, TriangulatePolygonTests) {
+	const auto checkTriangulation = [](const std::vector<Vec2>& polygon, const std::vector<std::vector<Vec2>>& holes, const Real area) {
+		const std::vector<uint32_t> indices = Math::TriangulatePolygon(polygon, holes);
+		std::vector<Vec2> points = polygon;
+		for (const auto& hole : holes) points.insert(points.end(), hole.begin(), hole.end());
+		ASSERT_EQ(indices.size(), 3 * (points.size() + 2 * holes.size() - 2));
+		Real sum = 0;
+		for (size_t i = 0; i < indices.size(); i += 3) {
+			const Real triangleArea = Math::Orient2D(points[indices[i]], points[indices[i + 1]], points[indices[i + 2]]) / 2;
+			EXPECT_GT(triangleArea, 0);
+			sum += triangleArea;
+		}
+		EXPECT_NEAR(sum, area, 1e-3);
+	};
+
+	// A comb, clockwise, with many vertices at the same height.
+	std::vector<Vec2> comb{{0, 0}, {0, 3}};
+	for (int tooth = 0; tooth < 5; ++tooth) {
+		comb.emplace_back(2 * tooth + 1, 3);
+		comb.emplace_back(2 * tooth + 1, 1);
+		comb.emplace_back(2 * tooth + 2, 1);
+		comb.emplace_back(2 * tooth + 2, 3);
+	}
+	comb.emplace_back(11, 3);
+	comb.emplace_back(11, 0);
+	checkTriangulation(comb, {}, 23);
+
+	// A square with a square & a triangle as holes.
+	const std::vector<Vec2> square{{0, 0}, {10, 0}, {10, 10}, {0, 10}};
+	const std::vector<std::vector<Vec2>> holes{{{1, 1}, {1, 4}, {4, 4}, {4, 1}}, {{6, 6}, {9, 6}, {6, 9}}};
+	checkTriangulation(square, holes, static_cast<Real>(100 - 9 - 4.5));
+
+	EXPECT_THROW((void)Math::TriangulatePolygon(std::vector<Vec2>{{0, 0}, {1, 0}}), std::invalid_argument);
+}
+
+TEST(MathTest, FreeListVectorTests) {
+	Math::FreeListVector<int> list;
+	const uint32_t a = list.emplace(1);
+	const uint32_t b = list.emplace(2);
+	const uint32_t c = list.emplace(3);
+	EXPECT_EQ(list.size(), 3);
+	EXPECT_EQ(list.at(b), 2);
+
+	list.erase(b);
+	EXPECT_EQ(list.size(), 2);
+	EXPECT_FALSE(list.contains(b));
+	EXPECT_THROW((void)list.at(b), std::out_of_range);
+
+	int sum = 0;
+	for (const auto& [id, value] : list) {
+		EXPECT_TRUE(id == a || id == c);
+		sum += value;
+	}
+	EXPECT_EQ(sum, 4);
+
+	// The erased id is recycled by the next insertion.
+	const uint32_t d = list.emplace(4);
+	EXPECT_EQ(d, b);
+	EXPECT_EQ(list.id_bound(), 3);
+	EXPECT_EQ(list[d], 4);
+
+	// Inserting a given id takes it out of the free ids, whatever its place among them.
+	EXPECT_TRUE(list.insert({6, 7}).second);
+	EXPECT_FALSE(list.insert({6, 8}).second);
+	EXPECT_TRUE(list.insert({4, 5}).second);
+	list.erase(a);
+	EXPECT_TRUE(list.insert({a, 1}).second);
+	std::vector<uint32_t> ids;
+	for (int i = 0; i < 2; ++i) ids.push_back(list.emplace(0));
+	std::sort(ids.begin(), ids.end());
+	EXPECT_EQ(ids, (std::vector<uint32_t>{3, 5}));
+	EXPECT_EQ(list.emplace(0), 7);
+	EXPECT_EQ(list.size(), 8);
+
+	// The erased slots keep their place in the free list, whatever the order of the insertions & removals.
+	Math::FreeListVector<uint32_t> shuffled;
+	std::vector<bool> alive;
+	std::mt19937 random(1);
+	for (int i = 0; i < 2000; ++i) {
+		const uint32_t target = random() % 64;
+		if (random() % 3 == 0) {
+			const uint32_t inserted = shuffled.emplace(target);
+			if (inserted >= alive.size()) alive.resize(inserted + 1);
+			ASSERT_FALSE(alive[inserted]);
+			alive[inserted] = true;
+		} else if (target < alive.size() && alive[target]) {
+			shuffled.erase(target);
+			alive[target] = false;
+		} else {
+			ASSERT_TRUE(shuffled.insert({target, target}).second);
+			if (target >= alive.size()) alive.resize(target + 1);
+			alive[target] = true;
+		}
+		ASSERT_EQ(shuffled.size(), static_cast<size_t>(std::count(alive.cbegin(), alive.cend(), true)));
+	}
+	for (uint32_t i = 0; i < alive.size(); ++i) ASSERT_EQ(shuffled.contains(i), alive[i]);
+
+	// An erased element is destroyed right away.
+	Math::FreeListVector<std::shared_ptr<int>> pointers;
+	const auto shared = std::make_shared<int>(0);
+	const uint32_t id = pointers.emplace(shared);
+	EXPECT_EQ(shared.use_count(), 2);
+	pointers.erase(id);
+	EXPECT_EQ(shared.use_count(), 1);
+}
+
+TEST(MeshGraphTest, LocateTriangleTests) {
+	const std::vector<Vec2> points {
+		Vec2{-1_r,-1_r},
+		Vec2{+1_r,-1_r},
+		Vec2{+1_r,+1_r},
+		Vec2{-1_r,+1_r},
+		Vec2{+0.1_r,+0.2_r},
+	};
+	const Math::MeshGraph mg(points.cbegin(), points.cend(), true);
+	ASSERT_EQ(mg.m_Triangles.size(), 4);
+
+	const std::array<Vec2, 4> queries {
+		Vec2{+0.0_r,-0.8_r},
+		Vec2{+0.8_r,+0.0_r},
+		Vec2{+0.0_r,+0.8_r},
+		Vec2{-0.8_r,+0.0_r},
+	};
+	for (const auto& query : queries) {
+		for (const auto& [hintId, hint] : mg.m_Triangles) {
+			const auto triangleId = mg.LocateTriangle(query, hintId);
+			ASSERT_TRUE(triangleId.has_value());
+			const auto& triangle = mg.m_Triangles.at(triangleId.value());
+			const auto& AB = mg.m_Edges.at(triangle.EdgeAB);
+			const auto& BC = mg.m_Edges.at(triangle.EdgeBC);
+			const uint32_t cId = BC.VertexA == AB.VertexA || BC.VertexA == AB.VertexB ? BC.VertexB : BC.VertexA;
+			EXPECT_TRUE(Math::PointIsInsideTriangle(mg.m_Vertices.at(AB.VertexA).Position, mg.m_Vertices.at(AB.VertexB).Position, mg.m_Vertices.at(cId).Position, query));
+		}
+	}
+
+	EXPECT_FALSE(mg.LocateTriangle(Vec2{2_r, 0_r}).has_value());
+	EXPECT_FALSE(mg.LocateTriangle(Vec2{0_r, -1.5_r}).has_value());
+}
+
+TEST(MeshGraphTest, BuildDelaunayTests) {
+	// A 6x6 grid (lots of cocircular points), each point given twice.
+	std::vector<Vec2> points;
+	for (int i = 0; i < 2; ++i) {
+		for (int x = 0; x < 6; ++x) {
+			for (int y = 0; y < 6; ++y) {
+				points.emplace_back(static_cast<Real>(x), static_cast<Real>(y));
+			}
+		}
+	}
+	const Math::MeshGraph mg = Math::MeshGraph::BuildDelaunay(points.cbegin(), points.cend());
+	ASSERT_EQ(mg.m_Vertices.size(), 36);
+	// 2n - h - 2 triangles with the 20 points on the border of the grid.
+	ASSERT_EQ(mg.m_Triangles.size(), 2 * 36 - 20 - 2);
+	ASSERT_NO_FATAL_FAILURE(checkDelaunay(mg));
+
+	// A flat arc, all on the hull: the super-triangle is in the circumcircle of most of its triangles.
+	std::vector<Vec2> arc;
+	std::mt19937 random(5);
+	std::uniform_real_distribution<Real> distribution(-1, 1);
+	for (int i = 0; i < 200; ++i) {
+		const Real x = distribution(random);
+		arc.emplace_back(x, x * x / 100);
+	}
+	Math::MeshGraph arcGraph = Math::MeshGraph::BuildDelaunay(arc.cbegin(), arc.cend());
+	ASSERT_EQ(arcGraph.m_Vertices.size(), arc.size());
+	ASSERT_EQ(arcGraph.m_Triangles.size(), arc.size() - 2);
+	EXPECT_EQ(arcGraph.GetConvexHull().size(), arc.size());
+	ASSERT_NO_FATAL_FAILURE(checkDelaunay(arcGraph));
+
+	// Collinear points don't have any edge.
+	std::vector<Vec2> line;
+	for (int i = 0; i < 10; ++i) line.emplace_back(static_cast<Real>(i), static_cast<Real>(2 * i));
+	const Math::MeshGraph lineGraph = Math::MeshGraph::BuildDelaunay(line.cbegin(), line.cend());
+	EXPECT_EQ(lineGraph.m_Vertices.size(), line.size());
+	EXPECT_TRUE(lineGraph.m_Edges.empty());
+}
+
+TEST(MeshGraphTest, AddDelaunayPointTests) {
+	// Points on the edges, on the prolongation of the border and duplicated.
+	Math::MeshGraph mg;
+	for (int i = 0; i < 2; ++i) {
+		for (int x = 0; x < 6; ++x) {
+			for (int y = 0; y < 6; ++y) {
+				mg.AddDelaunayPoint({static_cast<Real>((x * 5) % 6), static_cast<Real>((y * 7 + x) % 6)});
+			}
+		}
+	}
+	ASSERT_EQ(mg.m_Vertices.size(), 36);
+	ASSERT_EQ(mg.m_Triangles.size(), 2 * 36 - 20 - 2);
+	for (const auto& [edgeId, edge] : mg.m_Edges) {
+		EXPECT_TRUE(edge.TriangleLeft || edge.TriangleRight);
+	}
+}
+
+TEST(MeshGraphTest, RemoveDelaunayPointTests) {
+	// A grid (cocircular points everywhere) and random points, removed in a random order, hull vertices included.
+	std::vector<Vec2> points;
+	for (int x = 0; x < 6; ++x) {
+		for (int y = 0; y < 6; ++y) {
+			points.emplace_back(static_cast<Real>(x), static_cast<Real>(y));
+		}
+	}
+	std::mt19937 random(11);
+	std::uniform_real_distribution<Real> distribution(-3, 8);
+	for (int i = 0; i < 30; ++i) points.emplace_back(distribution(random), distribution(random));
+
+	Math::MeshGraph mg = Math::MeshGraph::BuildDelaunay(points.cbegin(), points.cend());
+	std::vector<uint32_t> vertexIds;
+	for (const auto& [vertexId, vertex] : mg.m_Vertices) vertexIds.push_back(vertexId);
+	std::shuffle(vertexIds.begin(), vertexIds.end(), random);
+
+	for (const uint32_t vertexId : vertexIds) {
+		ASSERT_NO_THROW(mg.RemoveDelaunayPoint(vertexId));
+		ASSERT_FALSE(mg.m_Vertices.contains(vertexId));
+		if (mg.m_Triangles.empty()) continue;
+
+		ASSERT_NO_FATAL_FAILURE(checkDelaunay(mg));
+	}
+	EXPECT_TRUE(mg.m_Vertices.empty());
+	EXPECT_TRUE(mg.m_Edges.empty());
+	EXPECT_TRUE(mg.m_Triangles.empty());
+}
+
+TEST(MeshGraphTest, RemoveDelaunayPointsTests) {
+	// Remove disks of neighbouring points, with a few scattered ones, until nothing is left.
+	std::vector<Vec2> points;
+	for (int x = 0; x < 8; ++x) {
+		for (int y = 0; y < 8; ++y) {
+			points.emplace_back(static_cast<Real>(x), static_cast<Real>(y));
+		}
+	}
+	std::mt19937 random(13);
+	std::uniform_real_distribution<Real> distribution(-3, 10);
+	for (int i = 0; i < 60; ++i) points.emplace_back(distribution(random), distribution(random));
+
+	Math::MeshGraph mg = Math::MeshGraph::BuildDelaunay(points.cbegin(), points.cend());
+	const size_t idBound = mg.m_Triangles.id_bound();
+	while (!mg.m_Vertices.empty()) {
+		std::vector<std::pair<uint32_t, Vec2>> vertices;
+		for (const auto& [vertexId, vertex] : mg.m_Vertices) vertices.emplace_back(vertexId, vertex.Position);
+		const Vec2 center = vertices[random() % vertices.size()].second;
+		std::vector<uint32_t> removed;
+		for (const auto& [vertexId, position] : vertices) {
+			if (Math::Distance(position, center) <= 2 || random() % 16 == 0) removed.push_back(vertexId);
+		}
+
+		const size_t count = mg.m_Vertices.size();
+		ASSERT_NO_THROW(mg.RemoveDelaunayPoints(removed));
+		ASSERT_EQ(mg.m_Vertices.size(), count - removed.size());
+		for (const uint32_t vertexId : removed) ASSERT_FALSE(mg.m_Vertices.contains(vertexId));
+		// The holes are filled with the freed ids.
+		ASSERT_LE(mg.m_Triangles.id_bound(), idBound);
+		if (mg.m_Triangles.empty()) continue;
+
+		ASSERT_NO_FATAL_FAILURE(checkDelaunay(mg));
+	}
+	EXPECT_TRUE(mg.m_Edges.empty());
+	EXPECT_TRUE(mg.m_Triangles.empty());
+}
+
+TEST(MeshGraphTest, MoveDelaunayPointTests) {
+	std::vector<Vec2> points;
+	std::mt19937 random(15);
+	std::uniform_real_distribution<Real> distribution(0, 10);
+	for (int i = 0; i < 120; ++i) points.emplace_back(distribution(random), distribution(random));
+	Math::MeshGraph mg = Math::MeshGraph::BuildDelaunay(points.cbegin(), points.cend());
+
+	std::vector<uint32_t> vertexIds;
+	for (const auto& [vertexId, vertex] : mg.m_Vertices) vertexIds.push_back(vertexId);
+	ASSERT_THROW(mg.MoveDelaunayPoint(mg.m_Vertices.id_bound(), {0, 0}), std::out_of_range);
+	// Another point is already there.
+	EXPECT_FALSE(mg.MoveDelaunayPoint(vertexIds[0], mg.m_Vertices.at(vertexIds[1]).Position));
+
+	// Small steps stay in the star of the vertex, every fifth tick jumps across the mesh.
+	std::uniform_real_distribution<Real> step(-1, 1);
+	for (int tick = 0; tick < 10; ++tick) {
+		const Real amplitude = tick % 5 == 4 ? 4 : static_cast<Real>(0.1);
+		for (const uint32_t vertexId : vertexIds) {
+			const Vec2 position = mg.m_Vertices.at(vertexId).Position + Vec2{step(random), step(random)} * amplitude;
+			ASSERT_NO_THROW(mg.MoveDelaunayPoint(vertexId, position));
+			ASSERT_EQ(mg.m_Vertices.at(vertexId).Position, position);
+		}
+		ASSERT_EQ(mg.m_Vertices.size(), vertexIds.size());
+
+		ASSERT_NO_FATAL_FAILURE(checkDelaunay(mg));
+	}
+
+	// The constraint of the moved point would cross another one, the move is refused before touching the mesh.
+	const std::vector<Vec2> square{{0, 0}, {10, 0}, {10, 10}, {0, 10}, {2, 5}, {5, 2}, {5, 8}, {8, 5}};
+	Math::MeshGraph constrained = Math::MeshGraph::BuildDelaunay(square.cbegin(), square.cend());
+	const auto findVertex = [&constrained](const Vec2 position) {
+		for (const auto& [vertexId, vertex] : constrained.m_Vertices) {
+			if (vertex.Position == position) return vertexId;
+		}
+		return std::numeric_limits<uint32_t>::max();
+	};
+	const auto isConstrained = [&constrained](const uint32_t aId, const uint32_t bId) {
+		for (const auto& [edgeId, edge] : constrained.m_Edges) {
+			if ((edge.VertexA == aId && edge.VertexB == bId) || (edge.VertexA == bId && edge.VertexB == aId)) return edge.Constrained;
+		}
+		return false;
+	};
+	const uint32_t corner = findVertex({0, 0});
+	const uint32_t left = findVertex({2, 5});
+	const uint32_t bottom = findVertex({5, 2});
+	const uint32_t top = findVertex({5, 8});
+	constrained.InsertConstraint(bottom, top);
+	constrained.InsertConstraint(left, corner);
+	const size_t edgeCount = constrained.m_Edges.size();
+	EXPECT_FALSE(constrained.MoveDelaunayPoint(left, {9, 6}));
+	EXPECT_EQ(constrained.m_Vertices.at(left).Position, Vec2(2, 5));
+	EXPECT_EQ(constrained.m_Edges.size(), edgeCount);
+	EXPECT_TRUE(isConstrained(bottom, top));
+	EXPECT_TRUE(isConstrained(left, corner));
+	// On the same side of the other constraint, the constraint follows the point.
+	EXPECT_TRUE(constrained.MoveDelaunayPoint(left, {3, 8}));
+	EXPECT_TRUE(isConstrained(bottom, top));
+	EXPECT_TRUE(isConstrained(left, corner));
+}
+
+TEST(MeshGraphTest, InsertConstraintTests) {
+	// A grid, so the constraints go through vertices and along edges.
+	std::vector<Vec2> points;
+	for (int x = 0; x < 10; ++x) {
+		for (int y = 0; y < 10; ++y) {
+			points.emplace_back(static_cast<Real>(x), static_cast<Real>(y));
+		}
+	}
+	std::mt19937 random(16);
+	std::uniform_real_distribution<Real> distribution(0, 9);
+	for (int i = 0; i < 80; ++i) points.emplace_back(distribution(random), distribution(random));
+	Math::MeshGraph mg = Math::MeshGraph::BuildDelaunay(points.cbegin(), points.cend());
+	const auto findVertex = [&mg](const Vec2 position) {
+		for (const auto& [vertexId, vertex] : mg.m_Vertices) {
+			if (vertex.Position == position) return vertexId;
+		}
+		return std::numeric_limits<uint32_t>::max();
+	};
+
+	// The segments the constrained edges must cover, by their length.
+	const std::vector<std::pair<Vec2, Vec2>> segments{{{0, 0}, {9, 9}}, {{0, 4}, {5, 9}}, {{4, 0}, {9, 2}}};
+	for (const auto& [a, b] : segments) {
+		ASSERT_NO_THROW(mg.InsertConstraint(findVertex(a), findVertex(b)));
+	}
+	// Crosses the first segment.
+	EXPECT_THROW(mg.InsertConstraint(findVertex({1, 0}), findVertex({0, 1})), std::runtime_error);
+	EXPECT_THROW(mg.InsertConstraint(findVertex({0, 0}), findVertex({0, 0})), std::invalid_argument);
+
+	const auto opposite = [&mg](const uint32_t triangleId, const Math::MeshGraph::Edge& edge) {
+		const auto& triangle = mg.m_Triangles.at(triangleId);
+		for (const uint32_t otherId : {triangle.EdgeAB, triangle.EdgeBC}) {
+			const auto& other = mg.m_Edges.at(otherId);
+			for (const uint32_t vertexId : {other.VertexA, other.VertexB}) {
+				if (vertexId != edge.VertexA && vertexId != edge.VertexB) return vertexId;
+			}
+		}
+		return std::numeric_limits<uint32_t>::max();
+	};
+	const auto checkConstraints = [&]() {
+		ASSERT_EQ(mg.m_Vertices.size() + mg.m_Triangles.size(), mg.m_Edges.size() + 1);
+		Real constrainedLength = 0;
+		for (const auto& [edgeId, edge] : mg.m_Edges) {
+			const Vec2 a = mg.m_Vertices.at(edge.VertexA).Position;
+			const Vec2 b = mg.m_Vertices.at(edge.VertexB).Position;
+			if (edge.Constrained) {
+				constrainedLength += Math::Distance(a, b);
+				continue;
+			}
+			// Every other edge is locally Delaunay.
+			if (!edge.TriangleLeft || !edge.TriangleRight) continue;
+			const Vec2 left = mg.m_Vertices.at(opposite(edge.TriangleLeft.value(), edge)).Position;
+			const Vec2 right = mg.m_Vertices.at(opposite(edge.TriangleRight.value(), edge)).Position;
+			ASSERT_FALSE(Math::IsPointInsideCircumcircle(a, b, left, right));
+		}
+		Real segmentsLength = 0;
+		for (const auto& [a, b] : segments) segmentsLength += Math::Distance(a, b);
+		EXPECT_NEAR(constrainedLength, segmentsLength, 1e-3);
+	};
+	checkConstraints();
+
+	// The other points come and go, a point on a constraint splits it and mends it when removed.
+	mg.AddDelaunayPoint({static_cast<Real>(4.5), static_cast<Real>(4.5)});
+	checkConstraints();
+	mg.RemoveDelaunayPoint(findVertex({static_cast<Real>(4.5), static_cast<Real>(4.5)}));
+	mg.RemoveDelaunayPoint(findVertex({3, 3}));
+	checkConstraints();
+	std::vector<uint32_t> removed;
+	for (const auto& [vertexId, vertex] : mg.m_Vertices) {
+		if (vertex.Position.x != std::floor(vertex.Position.x) && removed.size() < 30) removed.push_back(vertexId);
+	}
+	mg.RemoveDelaunayPoints(removed);
+	checkConstraints();
+	for (int i = 0; i < 40; ++i) mg.AddDelaunayPoint({distribution(random), distribution(random)});
+	checkConstraints();
+}
+
+TEST(MeshGraphTest, RefineDelaunayTests) {
+	std::vector<Vec2> points{{0, 0}, {9, 0}, {9, 9}, {0, 9}};
+	std::mt19937 random(17);
+	std::uniform_real_distribution<Real> distribution(0, 9);
+	for (int i = 0; i < 60; ++i) points.emplace_back(distribution(random), distribution(random));
+	Math::MeshGraph mg = Math::MeshGraph::BuildDelaunay(points.cbegin(), points.cend());
+	EXPECT_THROW(mg.RefineDelaunay(pi / 3), std::invalid_argument);
+	EXPECT_THROW(mg.RefineDelaunay(0, 0), std::invalid_argument);
+	EXPECT_EQ(mg.RefineDelaunay(25 * deg2rad, std::numeric_limits<Real>::max(), 10), 10);
+
+	uint32_t cornerA = 0, cornerB = 0;
+	for (const auto& [vertexId, vertex] : mg.m_Vertices) {
+		if (vertex.Position == Vec2{0, 0}) cornerA = vertexId;
+		if (vertex.Position == Vec2{9, 9}) cornerB = vertexId;
+	}
+	mg.InsertConstraint(cornerA, cornerB);
+	const Real maxArea = 1;
+	EXPECT_GT(mg.RefineDelaunay(25 * deg2rad, maxArea), 0);
+
+	ASSERT_EQ(mg.m_Vertices.size() + mg.m_Triangles.size(), mg.m_Edges.size() + 1);
+	Real area = 0;
+	for (const auto& [triangleId, triangle] : mg.m_Triangles) {
+		const auto& ab = mg.m_Edges.at(triangle.EdgeAB);
+		const auto& bc = mg.m_Edges.at(triangle.EdgeBC);
+		const Vec2 a = mg.m_Vertices.at(ab.VertexA).Position;
+		const Vec2 b = mg.m_Vertices.at(ab.VertexB).Position;
+		const Vec2 c = mg.m_Vertices.at(bc.VertexA == ab.VertexA || bc.VertexA == ab.VertexB ? bc.VertexB : bc.VertexA).Position;
+		const Real triangleArea = std::abs(Math::Orient2D(a, b, c)) / 2;
+		area += triangleArea;
+		EXPECT_LE(triangleArea, maxArea);
+		// The sine of the smallest angle is the shortest edge over the diameter of the circumcircle.
+		const Real shortest = std::sqrt(std::min({Math::Distance2(a, b), Math::Distance2(b, c), Math::Distance2(c, a)}));
+		EXPECT_GE(shortest / (2 * Math::GetCircleRadius(a, b, c)), std::sin(static_cast<Real>(24.9) * deg2rad));
+	}
+	// The domain & the diagonal are still covered.
+	EXPECT_NEAR(area, 81, 1e-2);
+	Real constrainedLength = 0;
+	for (const auto& [edgeId, edge] : mg.m_Edges) {
+		if (edge.Constrained) constrainedLength += Math::Distance(mg.m_Vertices.at(edge.VertexA).Position, mg.m_Vertices.at(edge.VertexB).Position);
+	}
+	EXPECT_NEAR(constrainedLength, 9 * std::sqrt(static_cast<Real>(2)), 1e-3);
+}
+
+TEST(MeshGraphTest, BuildTerrainTests) {
+	const uint32_t width = 97, depth = 65;
+	std::vector<Real> heights;
+	for (uint32_t y = 0; y < depth; ++y) {
+		for (uint32_t x = 0; x < width; ++x) {
+			heights.push_back(std::sin(static_cast<Real>(x) / 9) * std::cos(static_cast<Real>(y) / 7) * 5 + static_cast<Real>(x) / 10);
+		}
+	}
+	EXPECT_THROW((void)Math::MeshGraph::BuildTerrain(heights, width, depth + 1, 0), std::invalid_argument);
+	EXPECT_THROW((void)Math::MeshGraph::BuildTerrain(std::span<const Real>{heights}.first(width), width, 1, 0), std::invalid_argument);
+
+	// A plane only needs its corners.
+	std::vector<Real> plane;
+	for (uint32_t y = 0; y < 5; ++y) for (uint32_t x = 0; x < 8; ++x) plane.push_back(static_cast<Real>(2 * x + y));
+	EXPECT_EQ(Math::MeshGraph::BuildTerrain(plane, 8, 5, 0).m_Vertices.size(), 4);
+
+	const Vec2 origin{-4, 2};
+	const Vec2 spacing{0.5, 0.25};
+	const Real tolerance = 0.05;
+	Math::MeshGraph mg = Math::MeshGraph::BuildTerrain(heights, width, depth, tolerance, origin, spacing);
+	EXPECT_GT(mg.m_Vertices.size(), 4);
+	EXPECT_LT(mg.m_Vertices.size(), heights.size() / 2);
+	ASSERT_EQ(mg.m_Vertices.size() + mg.m_Triangles.size(), mg.m_Edges.size() + 1);
+	for (const auto& [vertexId, vertex] : mg.m_Vertices) {
+		const Vec2 grid = (vertex.Position - origin) / spacing;
+		EXPECT_REAL_EQ(vertex.Height, heights[static_cast<uint32_t>(std::round(grid.y)) * width + static_cast<uint32_t>(std::round(grid.x))]);
+	}
+	for (uint32_t y = 0; y < depth; ++y) {
+		for (uint32_t x = 0; x < width; ++x) {
+			const Vec2 point = origin + spacing * Vec2{static_cast<Real>(x), static_cast<Real>(y)};
+			const std::optional<uint32_t> triangleId = mg.LocateTriangle(point);
+			ASSERT_TRUE(triangleId.has_value());
+			EXPECT_NEAR(mg.InterpolateHeight(triangleId.value(), point), heights[y * width + x], tolerance + 1e-3);
+		}
+	}
+	const auto mesh = Math::MeshGraphToMesh3DXY(mg, 1);
+	ASSERT_EQ(mesh.size(), mg.m_Triangles.size() * 3);
+	for (const Vec3& vertex : mesh) {
+		const Vec2 grid = (Vec2{vertex.x, vertex.y} - origin) / spacing;
+		EXPECT_NEAR(vertex.z, 1 + heights[static_cast<uint32_t>(std::round(grid.y)) * width + static_cast<uint32_t>(std::round(grid.x))], 1e-4);
+	}
+
+	EXPECT_EQ(Math::MeshGraph::BuildTerrain(heights, width, depth, 0, origin, spacing, 20).m_Vertices.size(), 20);
+
+	// The heights follow the vertices inserted by hand.
+	Math::MeshGraph terrain;
+	for (const Vec3 point : {Vec3{0, 0, 1}, Vec3{4, 0, 2}, Vec3{0, 4, 4}}) terrain.AddDelaunayPoint(point);
+	const std::optional<uint32_t> triangleId = terrain.LocateTriangle({1, 1});
+	ASSERT_TRUE(triangleId.has_value());
+	EXPECT_NEAR(terrain.InterpolateHeight(triangleId.value(), {1, 1}), 2, 1e-5);
+}
+
+TEST(MeshGraphTest, IncidentEdgesAndHullTests) {
+	const auto checkTopology = [](Math::MeshGraph& mg) {
+		std::unordered_map<uint32_t, size_t> degrees;
+		size_t borderCount = 0;
+		for (const auto& [edgeId, edge] : mg.m_Edges) {
+			++degrees[edge.VertexA];
+			++degrees[edge.VertexB];
+			if (edge.TriangleLeft.has_value() != edge.TriangleRight.has_value()) ++borderCount;
+		}
+		std::vector<uint32_t> edges;
+		for (const auto& [vertexId, vertex] : mg.m_Vertices) {
+			mg.GetIncidentEdges(vertexId, edges);
+			ASSERT_EQ(edges.size(), degrees[vertexId]);
+			for (const uint32_t edgeId : edges) {
+				const auto& edge = mg.m_Edges.at(edgeId);
+				ASSERT_TRUE(edge.VertexA == vertexId || edge.VertexB == vertexId);
+			}
+		}
+
+		// A convex polygon, counter-clockwise, with every border edge.
+		const std::vector<uint32_t> hull = mg.GetConvexHull();
+		ASSERT_EQ(hull.size(), borderCount);
+		for (size_t i = 0; i < hull.size(); ++i) {
+			const Vec2 a = mg.m_Vertices.at(hull[i]).Position;
+			const Vec2 b = mg.m_Vertices.at(hull[(i + 1) % hull.size()]).Position;
+			const Vec2 c = mg.m_Vertices.at(hull[(i + 2) % hull.size()]).Position;
+			ASSERT_GE(Math::Orient2D(a, b, c), 0);
+		}
+	};
+
+	// Inserted from left to right, every point is outside of the hull.
+	std::vector<Vec2> points;
+	std::mt19937 random(17);
+	std::uniform_real_distribution<Real> distribution(0, 10);
+	for (int i = 0; i < 150; ++i) points.emplace_back(distribution(random), distribution(random));
+	for (int x = 0; x < 5; ++x) points.emplace_back(static_cast<Real>(x), static_cast<Real>(-1));
+	std::sort(points.begin(), points.end(), [](const Vec2& a, const Vec2& b) { return a.x < b.x || (a.x == b.x && a.y < b.y); });
+
+	Math::MeshGraph mg;
+	for (const Vec2& point : points) {
+		mg.AddDelaunayPoint(point);
+	}
+	checkTopology(mg);
+
+	std::vector<uint32_t> vertexIds;
+	for (const auto& [vertexId, vertex] : mg.m_Vertices) vertexIds.push_back(vertexId);
+	std::shuffle(vertexIds.begin(), vertexIds.end(), random);
+	vertexIds.resize(vertexIds.size() / 2);
+	for (size_t i = 0; i < vertexIds.size(); ++i) {
+		mg.RemoveDelaunayPoint(vertexIds[i]);
+		if (i % 10 == 0) checkTopology(mg);
+	}
+	checkTopology(mg);
+}
+
+TEST(MeshGraphTest, CircumcircleCacheTests) {
+	Math::MeshGraph mg;
+	mg.AddDelaunayPoint({0, 0});
+	mg.AddDelaunayPoint({4, 0});
+	mg.AddDelaunayPoint({0, 4});
+	ASSERT_EQ(mg.m_Triangles.size(), 1);
+	const uint32_t firstId = mg.m_Triangles.begin()->first;
+	const auto circle = mg.GetCircumcircle(firstId);
+	EXPECT_NEAR(circle.Center.x, 2, 1e-5);
+	EXPECT_NEAR(circle.Center.y, 2, 1e-5);
+	EXPECT_NEAR(circle.SquaredRadius, 8, 1e-5);
+
+	// The flips and the new triangles must not reuse a stale circle.
+	for (int x = 0; x < 5; ++x) {
+		for (int y = 0; y < 5; ++y) {
+			mg.AddDelaunayPoint({static_cast<Real>((x * 3) % 5) + static_cast<Real>(0.1) * y, static_cast<Real>((y * 2 + x) % 5)});
+		}
+		mg.UpdateCircumcircleCache();
+	}
+	for (const auto& [triangleId, triangle] : mg.m_Triangles) {
+		const auto cached = mg.GetCircumcircle(triangleId);
+		const auto& AB = mg.m_Edges.at(triangle.EdgeAB);
+		const auto& BC = mg.m_Edges.at(triangle.EdgeBC);
+		const uint32_t cId = BC.VertexA == AB.VertexA || BC.VertexA == AB.VertexB ? BC.VertexB : BC.VertexA;
+		const Vec2 a = mg.m_Vertices.at(AB.VertexA).Position;
+		const Vec2 center = Math::GetCircleCenter(a, mg.m_Vertices.at(AB.VertexB).Position, mg.m_Vertices.at(cId).Position);
+		EXPECT_NEAR(cached.Center.x, center.x, 1e-3);
+		EXPECT_NEAR(cached.Center.y, center.y, 1e-3);
+		EXPECT_NEAR(cached.SquaredRadius, Math::Distance2(center, a), 1e-2);
+	}
+
+	const auto [cachedCells, cachedEdges] = mg.GetVoronoi();
+	mg.SetCircumcircleCacheEnabled(false);
+	const auto [cells, edges] = mg.GetVoronoi();
+	ASSERT_EQ(cachedCells.size(), cells.size());
+	ASSERT_EQ(cachedEdges.size(), edges.size());
+	for (const auto& [triangleId, center] : cells) {
+		EXPECT_EQ(cachedCells.at(triangleId), center);
+	}
+}
+
+TEST(MeshGraphTest, IncrementalVoronoiTests) {
+	// The same edits on two graphs, one diagram updated after each edit, the other built once at the end.
+	Math::MeshGraph incremental;
+	Math::MeshGraph reference;
+	const auto edit = [&](const auto& func) {
+		func(incremental);
+		func(reference);
+		const uint64_t version = incremental.GetVersion();
+		EXPECT_EQ(incremental.GetVoronoiDiagram().Version, version);
+	};
+	for (int x = 0; x < 6; ++x) {
+		for (int y = 0; y < 6; ++y) {
+			const Vec2 point{static_cast<Real>((x * 5) % 6) + static_cast<Real>(0.1) * y, static_cast<Real>((y * 7 + x) % 6)};
+			edit([&](Math::MeshGraph& mg) { mg.AddDelaunayPoint(point); });
+		}
+	}
+	std::vector<uint32_t> interiorIds;
+	for (const auto& [vertexId, vertex] : reference.m_Vertices) {
+		if (vertex.Position.x > 1 && vertex.Position.x < 4 && vertex.Position.y > 1 && vertex.Position.y < 4) interiorIds.push_back(vertexId);
+	}
+	ASSERT_FALSE(interiorIds.empty());
+	for (size_t i = 0; i < interiorIds.size(); i += 2) {
+		edit([&](Math::MeshGraph& mg) { mg.RemoveDelaunayPoint(interiorIds[i]); });
+	}
+
+	// Nothing changed, the diagram is not rebuilt.
+	const uint64_t version = incremental.GetVersion();
+	EXPECT_EQ(incremental.GetVoronoiDiagram().Version, version);
+	EXPECT_EQ(incremental.GetVersion(), version);
+
+	const auto& expected = reference.GetVoronoiDiagram();
+	const auto& actual = incremental.GetVoronoiDiagram();
+	for (const auto& [triangleId, triangle] : reference.m_Triangles) {
+		ASSERT_TRUE(actual.Vertices[triangleId].has_value());
+		EXPECT_EQ(actual.Vertices[triangleId].value(), expected.Vertices[triangleId].value());
+	}
+	size_t edgeCount = 0;
+	for (size_t edgeId = 0; edgeId < std::max(actual.Edges.size(), expected.Edges.size()); ++edgeId) {
+		const auto actualEdge = edgeId < actual.Edges.size() ? actual.Edges[edgeId] : std::nullopt;
+		const auto expectedEdge = edgeId < expected.Edges.size() ? expected.Edges[edgeId] : std::nullopt;
+		ASSERT_EQ(actualEdge.has_value(), expectedEdge.has_value());
+		if (!actualEdge) continue;
+		++edgeCount;
+		EXPECT_EQ(actualEdge->From, expectedEdge->From);
+		EXPECT_EQ(actualEdge->To, expectedEdge->To);
+		EXPECT_EQ(actualEdge->Infinite, expectedEdge->Infinite);
+	}
+	EXPECT_EQ(edgeCount, reference.m_Edges.size());
+}
+
+TEST(MeshGraphTest, VoronoiCellsTests) {
+	std::mt19937 random(7);
+	std::uniform_real_distribution<Real> distribution(0, 10);
+	std::vector<Vec2> points;
+	for (int i = 0; i < 200; ++i) points.emplace_back(distribution(random), distribution(random));
+	const Math::MeshGraph mg = Math::MeshGraph::BuildDelaunay(points.cbegin(), points.cend(), Math::DelaunayAlgorithm::BowyerWatson);
+
+	Math::MeshGraph::VoronoiCells cells;
+	mg.GetVoronoiCells(Vec2{-1, -2}, Vec2{11, 12}, cells);
+	ASSERT_EQ(cells.Size(), mg.m_Vertices.size());
+	ASSERT_EQ(cells.Offsets.size(), cells.Size() + 1);
+
+	// The cells tile the rectangle, and each one is the region closest to its site.
+	Real area = 0;
+	for (size_t i = 0; i < cells.Size(); ++i) {
+		const auto cell = cells.GetCell(i);
+		ASSERT_GE(cell.size(), 3);
+		const Real cellArea = Math::GetPolygonArea(cell);
+		EXPECT_GT(cellArea, 0);
+		area += cellArea;
+		const Vec2 site = mg.m_Vertices.at(cells.Sites[i]).Position;
+		const Vec2 centroid = Math::GetPolygonCentroid(cell);
+		for (const auto& [vertexId, vertex] : mg.m_Vertices) {
+			EXPECT_LE(Math::Distance2(centroid, site), Math::Distance2(centroid, vertex.Position) + static_cast<Real>(1e-3));
+		}
+	}
+	EXPECT_NEAR(area, 12 * 14, 1e-2);
+
+	// A site outside of the clipping polygon.
+	const std::vector<Vec2> triangle{{0, 0}, {1, 0}, {0, 1}};
+	mg.GetVoronoiCells(triangle, cells);
+	area = 0;
+	size_t emptyCount = 0;
+	for (size_t i = 0; i < cells.Size(); ++i) {
+		area += Math::GetPolygonArea(cells.GetCell(i));
+		emptyCount += cells.GetCell(i).empty();
+	}
+	EXPECT_NEAR(area, 0.5, 1e-4);
+	EXPECT_GT(emptyCount, 0);
+	EXPECT_THROW(mg.GetVoronoiCells(std::span<const Vec2>{triangle}.first(2), cells), std::invalid_argument);
+}
+
+TEST(MeshGraphTest, LloydRelaxationTests) {
+	std::mt19937 random(3);
+	std::uniform_real_distribution<Real> distribution(0, 10);
+	std::vector<Vec2> points;
+	for (int i = 0; i < 300; ++i) points.emplace_back(distribution(random), distribution(random));
+	const std::array<Vec2, 4> domain{Vec2{0, 0}, Vec2{10, 0}, Vec2{10, 10}, Vec2{0, 10}};
+
+	const auto getAreaDeviation = [&domain](const Math::MeshGraph& mg) {
+		Math::MeshGraph::VoronoiCells cells;
+		mg.GetVoronoiCells(domain, cells);
+		const Real mean = 100 / static_cast<Real>(cells.Size());
+		Real deviation = 0;
+		for (size_t i = 0; i < cells.Size(); ++i) {
+			const Real area = Math::GetPolygonArea(cells.GetCell(i));
+			deviation += (area - mean) * (area - mean);
+		}
+		return std::sqrt(deviation / static_cast<Real>(cells.Size()));
+	};
+
+	Math::MeshGraph mg = Math::MeshGraph::BuildDelaunay(points.cbegin(), points.cend(), Math::DelaunayAlgorithm::BowyerWatson);
+	Math::MeshGraph parallel = mg;
+	const Real initialDeviation = getAreaDeviation(mg);
+	EXPECT_EQ(mg.RelaxLloyd(domain, 30), 30);
+	EXPECT_EQ(parallel.RelaxLloyd(domain, 30, 0, 4), 30);
+	EXPECT_LT(getAreaDeviation(mg), initialDeviation / 3);
+
+	// Same vertices, moved in place, and still a Delaunay triangulation.
+	ASSERT_EQ(mg.m_Vertices.size(), points.size());
+	for (const auto& [vertexId, vertex] : mg.m_Vertices) {
+		EXPECT_EQ(vertex.Position, parallel.m_Vertices.at(vertexId).Position);
+		EXPECT_GE(vertex.Position.x, 0);
+		EXPECT_LE(vertex.Position.x, 10);
+	}
+	size_t borderCount = 0;
+	for (const auto& [edgeId, edge] : mg.m_Edges) borderCount += !(edge.TriangleLeft && edge.TriangleRight);
+	ASSERT_EQ(mg.m_Triangles.size(), 2 * points.size() - 2 - borderCount);
+	ASSERT_NO_FATAL_FAILURE(checkDelaunay(mg));
+
+	// Converged, the next iterations stop early.
+	EXPECT_LT(mg.RelaxLloyd(domain, 200, static_cast<Real>(0.01)), 200);
+}
+
+TEST(MeshGraphTest, DivideAndConquerDelaunayTests) {
+	// Points on a branch of parabola (the worst case of the incremental insertions) and a grid.
+	std::vector<Vec2> points;
+	for (int x = 0; x <= 40; ++x) {
+		points.emplace_back(static_cast<Real>(x), static_cast<Real>(x * x) / 20);
+	}
+	for (int x = 0; x < 6; ++x) {
+		for (int y = 0; y < 6; ++y) {
+			points.emplace_back(static_cast<Real>(x) * 2 - 5, static_cast<Real>(y) * 2 + 30);
+		}
+	}
+	const Math::MeshGraph bowyerWatson = Math::MeshGraph::BuildDelaunay(points.cbegin(), points.cend(), Math::DelaunayAlgorithm::BowyerWatson);
+	const Math::MeshGraph mg = Math::MeshGraph::BuildDelaunay(points.cbegin(), points.cend(), Math::DelaunayAlgorithm::DivideAndConquer);
+	ASSERT_EQ(mg.m_Vertices.size(), points.size());
+	ASSERT_EQ(mg.m_Triangles.size(), bowyerWatson.m_Triangles.size());
+	ASSERT_EQ(mg.m_Edges.size(), bowyerWatson.m_Edges.size());
+	ASSERT_NO_FATAL_FAILURE(checkDelaunay(mg));
+}
+
+TEST(MeshGraphTest, ParallelDivideAndConquerDelaunayTests) {
+	// Enough points for the strips to be split between the threads, the seams must give the same triangulation.
+	std::vector<Vec2> points;
+	for (int x = 0; x < 150; ++x) {
+		for (int y = 0; y < 100; ++y) {
+			points.emplace_back(static_cast<Real>(x) + static_cast<Real>((x * 7 + y * 13) % 10) / 20, static_cast<Real>(y));
+		}
+	}
+	const Math::DivideAndConquerDelaunay sequential(points, 1);
+	const Math::DivideAndConquerDelaunay parallel(points, 4);
+
+	auto normalize = [](std::vector<std::array<uint32_t, 3>> triangles) {
+		for (auto& triangle : triangles) {
+			std::rotate(triangle.begin(), std::min_element(triangle.begin(), triangle.end()), triangle.end());
+		}
+		std::sort(triangles.begin(), triangles.end());
+		return triangles;
+	};
+	const auto triangles = normalize(sequential.GetTriangles());
+	ASSERT_FALSE(triangles.empty());
+	ASSERT_EQ(triangles, normalize(parallel.GetTriangles()));
+}